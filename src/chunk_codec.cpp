@@ -0,0 +1,383 @@
+#include "chunk_codec.hpp"
+#include "filter_definitions.hpp"
+#include "vbz_filter.hpp"
+#include <cstring>
+#include <algorithm>
+#include <cstdint>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+bool ChunkCodec::supports(int filter_id, const std::vector<unsigned int> &cd_values, size_t type_size)
+{
+    switch (filter_id)
+    {
+    case H5Z_FILTER_DEFLATE:
+        return true;
+    case H5Z_FILTER_SHUFFLE:
+        return true;
+#ifdef HAVE_ZSTD
+    case H5Z_FILTER_ZSTD:
+        return true;
+#endif
+    case H5Z_FILTER_VBZ:
+    case H5Z_FILTER_VBZ_NATIVE:
+        // 只实现了 int16 + delta zigzag 的组合（nanopore 原始信号的用法）；未编译 zstd 时只支持级别 0
+        return type_size == 2 && cd_values.size() >= 4 &&
+               VbzFilter::supports(VbzFilter::fromCdValues(cd_values.size(), cd_values.data()));
+#ifdef HAVE_LZ4
+    case H5Z_FILTER_LZ4:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+std::string ChunkCodec::supportedList()
+{
+    std::string list = "DEFLATE, SHUFFLE";
+#ifdef HAVE_ZSTD
+    list += ", ZSTD";
+#endif
+    list += ", VBZ";
+#ifdef HAVE_LZ4
+    list += ", LZ4";
+#endif
+    return list;
+}
+
+bool ChunkCodec::encode(int filter_id,
+                        const std::vector<unsigned int> &cd_values,
+                        size_t type_size,
+                        const unsigned char *input,
+                        size_t input_bytes,
+                        std::vector<unsigned char> &output)
+{
+    switch (filter_id)
+    {
+    case H5Z_FILTER_DEFLATE:
+        return encodeDeflate(cd_values, input, input_bytes, output);
+    case H5Z_FILTER_SHUFFLE:
+        return encodeShuffle(cd_values, type_size, input, input_bytes, output);
+    case H5Z_FILTER_ZSTD:
+        return encodeZstd(cd_values, input, input_bytes, output);
+    case H5Z_FILTER_LZ4:
+        return encodeLz4(cd_values, input, input_bytes, output);
+    case H5Z_FILTER_VBZ:
+    case H5Z_FILTER_VBZ_NATIVE:
+        return encodeVbz(cd_values, input, input_bytes, output);
+    default:
+        return false;
+    }
+}
+
+// 与 HDF5 内置 deflate 过滤器相同：zlib compress2，cd_values[0] 为压缩级别
+bool ChunkCodec::encodeDeflate(const std::vector<unsigned int> &cd_values, const unsigned char *input,
+                               size_t input_bytes, std::vector<unsigned char> &output)
+{
+    int level = cd_values.empty() ? 6 : static_cast<int>(cd_values[0]);
+    uLongf dest_len = compressBound(static_cast<uLong>(input_bytes));
+    output.resize(dest_len);
+    if (compress2(output.data(), &dest_len, input, static_cast<uLong>(input_bytes), level) != Z_OK)
+    {
+        return false;
+    }
+    output.resize(dest_len);
+    return true;
+}
+
+// 与 HDF5 内置 shuffle 过滤器相同：按字节平面重排，不足一个元素的尾部字节原样保留
+bool ChunkCodec::encodeShuffle(const std::vector<unsigned int> &cd_values, size_t type_size,
+                               const unsigned char *input, size_t input_bytes, std::vector<unsigned char> &output)
+{
+    size_t bytes_per_element = cd_values.empty() ? type_size : cd_values[0];
+    output.resize(input_bytes);
+    if (bytes_per_element <= 1)
+    {
+        std::memcpy(output.data(), input, input_bytes);
+        return true;
+    }
+
+    size_t elements = input_bytes / bytes_per_element;
+    for (size_t byte = 0; byte < bytes_per_element; ++byte)
+    {
+        unsigned char *dst = output.data() + byte * elements;
+        const unsigned char *src = input + byte;
+        for (size_t i = 0; i < elements; ++i)
+        {
+            dst[i] = src[i * bytes_per_element];
+        }
+    }
+    size_t tail = input_bytes - elements * bytes_per_element;
+    if (tail > 0)
+    {
+        std::memcpy(output.data() + elements * bytes_per_element, input + elements * bytes_per_element, tail);
+    }
+    return true;
+}
+
+// 与 HDF5 zstd 插件（32015）相同：整个分块一次 ZSTD_compress，cd_values[0] 为级别
+bool ChunkCodec::encodeZstd(const std::vector<unsigned int> &cd_values, const unsigned char *input,
+                            size_t input_bytes, std::vector<unsigned char> &output)
+{
+#ifdef HAVE_ZSTD
+    int level = cd_values.empty() ? 3 : static_cast<int>(cd_values[0]);
+    output.resize(ZSTD_compressBound(input_bytes));
+    size_t written = ZSTD_compress(output.data(), output.size(), input, input_bytes, level);
+    if (ZSTD_isError(written))
+    {
+        return false;
+    }
+    output.resize(written);
+    return true;
+#else
+    (void)cd_values;
+    (void)input;
+    (void)input_bytes;
+    (void)output;
+    return false;
+#endif
+}
+
+#ifdef HAVE_LZ4
+static void putBigEndian32(unsigned char *p, uint32_t value)
+{
+    p[0] = static_cast<unsigned char>(value >> 24);
+    p[1] = static_cast<unsigned char>(value >> 16);
+    p[2] = static_cast<unsigned char>(value >> 8);
+    p[3] = static_cast<unsigned char>(value);
+}
+#endif
+
+// 与 HDF5 lz4 插件（32004）相同：8 字节原始长度 + 4 字节块大小（大端），
+// 之后每块为 4 字节压缩长度 + 数据；压缩后不变小的块按原样存放
+bool ChunkCodec::encodeLz4(const std::vector<unsigned int> &cd_values, const unsigned char *input,
+                           size_t input_bytes, std::vector<unsigned char> &output)
+{
+#ifdef HAVE_LZ4
+    size_t block_size = (!cd_values.empty() && cd_values[0] > 0) ? cd_values[0] : (1U << 30);
+    if (block_size > input_bytes)
+    {
+        block_size = input_bytes;
+    }
+    if (block_size == 0 || block_size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE))
+    {
+        return false;
+    }
+
+    size_t blocks = (input_bytes + block_size - 1) / block_size;
+    output.resize(12 + blocks * (4 + static_cast<size_t>(LZ4_compressBound(static_cast<int>(block_size)))));
+    uint64_t total = input_bytes;
+    putBigEndian32(output.data(), static_cast<uint32_t>(total >> 32));
+    putBigEndian32(output.data() + 4, static_cast<uint32_t>(total));
+    putBigEndian32(output.data() + 8, static_cast<uint32_t>(block_size));
+
+    size_t out_pos = 12;
+    for (size_t offset = 0; offset < input_bytes; offset += block_size)
+    {
+        size_t this_block = std::min(block_size, input_bytes - offset);
+        unsigned char *dst = output.data() + out_pos + 4;
+        int written = LZ4_compress_default(reinterpret_cast<const char *>(input + offset), reinterpret_cast<char *>(dst),
+                                           static_cast<int>(this_block), LZ4_compressBound(static_cast<int>(this_block)));
+        if (written <= 0 || static_cast<size_t>(written) >= this_block)
+        {
+            std::memcpy(dst, input + offset, this_block);
+            written = static_cast<int>(this_block);
+        }
+        putBigEndian32(output.data() + out_pos, static_cast<uint32_t>(written));
+        out_pos += 4 + static_cast<size_t>(written);
+    }
+    output.resize(out_pos);
+    return true;
+#else
+    (void)cd_values;
+    (void)input;
+    (void)input_bytes;
+    (void)output;
+    return false;
+#endif
+}
+
+// 与 VBZ 插件（32020）相同的格式，由 VbzFilter 实现（SIMD delta/zigzag 与 StreamVByte）
+bool ChunkCodec::encodeVbz(const std::vector<unsigned int> &cd_values, const unsigned char *input,
+                           size_t input_bytes, std::vector<unsigned char> &output)
+{
+    return VbzFilter::encode(VbzFilter::fromCdValues(cd_values.size(), cd_values.data()), input, input_bytes,
+                             output);
+}
+
+bool ChunkCodec::decode(int filter_id,
+                        const std::vector<unsigned int> &cd_values,
+                        size_t type_size,
+                        const unsigned char *input,
+                        size_t input_bytes,
+                        size_t expected_bytes,
+                        std::vector<unsigned char> &output)
+{
+    switch (filter_id)
+    {
+    case H5Z_FILTER_DEFLATE:
+        return decodeDeflate(input, input_bytes, expected_bytes, output);
+    case H5Z_FILTER_SHUFFLE:
+        return decodeShuffle(cd_values, type_size, input, input_bytes, output);
+    case H5Z_FILTER_ZSTD:
+        return decodeZstd(input, input_bytes, expected_bytes, output);
+    case H5Z_FILTER_LZ4:
+        return decodeLz4(input, input_bytes, output);
+    case H5Z_FILTER_VBZ:
+    case H5Z_FILTER_VBZ_NATIVE:
+        return decodeVbz(cd_values, input, input_bytes, output);
+    default:
+        return false;
+    }
+}
+
+// zlib 流不记录原始长度，先按预期长度分配，不够时倍增重试
+bool ChunkCodec::decodeDeflate(const unsigned char *input, size_t input_bytes, size_t expected_bytes,
+                               std::vector<unsigned char> &output)
+{
+    size_t capacity = std::max<size_t>(expected_bytes, 64);
+    while (true)
+    {
+        output.resize(capacity);
+        uLongf dest_len = static_cast<uLongf>(capacity);
+        int status = uncompress(output.data(), &dest_len, input, static_cast<uLong>(input_bytes));
+        if (status == Z_OK)
+        {
+            output.resize(dest_len);
+            return true;
+        }
+        if (status != Z_BUF_ERROR)
+        {
+            return false;
+        }
+        capacity *= 2;
+    }
+}
+
+bool ChunkCodec::decodeShuffle(const std::vector<unsigned int> &cd_values, size_t type_size,
+                               const unsigned char *input, size_t input_bytes, std::vector<unsigned char> &output)
+{
+    size_t bytes_per_element = cd_values.empty() ? type_size : cd_values[0];
+    output.resize(input_bytes);
+    if (bytes_per_element <= 1)
+    {
+        std::memcpy(output.data(), input, input_bytes);
+        return true;
+    }
+
+    size_t elements = input_bytes / bytes_per_element;
+    for (size_t byte = 0; byte < bytes_per_element; ++byte)
+    {
+        const unsigned char *src = input + byte * elements;
+        unsigned char *dst = output.data() + byte;
+        for (size_t i = 0; i < elements; ++i)
+        {
+            dst[i * bytes_per_element] = src[i];
+        }
+    }
+    size_t tail = input_bytes - elements * bytes_per_element;
+    if (tail > 0)
+    {
+        std::memcpy(output.data() + elements * bytes_per_element, input + elements * bytes_per_element, tail);
+    }
+    return true;
+}
+
+bool ChunkCodec::decodeZstd(const unsigned char *input, size_t input_bytes, size_t expected_bytes,
+                            std::vector<unsigned char> &output)
+{
+#ifdef HAVE_ZSTD
+    unsigned long long content_size = ZSTD_getFrameContentSize(input, input_bytes);
+    if (content_size == ZSTD_CONTENTSIZE_ERROR)
+    {
+        return false;
+    }
+    output.resize(content_size == ZSTD_CONTENTSIZE_UNKNOWN ? expected_bytes : static_cast<size_t>(content_size));
+    size_t written = ZSTD_decompress(output.data(), output.size(), input, input_bytes);
+    if (ZSTD_isError(written))
+    {
+        return false;
+    }
+    output.resize(written);
+    return true;
+#else
+    (void)input;
+    (void)input_bytes;
+    (void)expected_bytes;
+    (void)output;
+    return false;
+#endif
+}
+
+#ifdef HAVE_LZ4
+static uint32_t getBigEndian32(const unsigned char *p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+#endif
+
+bool ChunkCodec::decodeLz4(const unsigned char *input, size_t input_bytes, std::vector<unsigned char> &output)
+{
+#ifdef HAVE_LZ4
+    if (input_bytes < 12)
+    {
+        return false;
+    }
+    uint64_t total = (static_cast<uint64_t>(getBigEndian32(input)) << 32) | getBigEndian32(input + 4);
+    size_t block_size = getBigEndian32(input + 8);
+    if (block_size == 0 && total > 0)
+    {
+        return false;
+    }
+    output.resize(static_cast<size_t>(total));
+
+    size_t in_pos = 12;
+    for (size_t offset = 0; offset < total; offset += block_size)
+    {
+        size_t this_block = std::min<size_t>(block_size, static_cast<size_t>(total) - offset);
+        if (in_pos + 4 > input_bytes)
+        {
+            return false;
+        }
+        size_t compressed = getBigEndian32(input + in_pos);
+        in_pos += 4;
+        if (in_pos + compressed > input_bytes)
+        {
+            return false;
+        }
+        if (compressed == this_block)
+        {
+            // 该块按原样存放
+            std::memcpy(output.data() + offset, input + in_pos, this_block);
+        }
+        else if (LZ4_decompress_safe(reinterpret_cast<const char *>(input + in_pos),
+                                     reinterpret_cast<char *>(output.data() + offset),
+                                     static_cast<int>(compressed), static_cast<int>(this_block)) !=
+                 static_cast<int>(this_block))
+        {
+            return false;
+        }
+        in_pos += compressed;
+    }
+    return true;
+#else
+    (void)input;
+    (void)input_bytes;
+    (void)output;
+    return false;
+#endif
+}
+
+bool ChunkCodec::decodeVbz(const std::vector<unsigned int> &cd_values, const unsigned char *input,
+                           size_t input_bytes, std::vector<unsigned char> &output)
+{
+    return VbzFilter::decode(VbzFilter::fromCdValues(cd_values.size(), cd_values.data()), input, input_bytes,
+                             output);
+}
@@ -0,0 +1,61 @@
+#ifndef CHUNK_CODEC_HPP
+#define CHUNK_CODEC_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// 进程内的分块编解码器：按照对应 HDF5 过滤器插件的格式编码/解码一个分块，
+// 编码结果可以直接用 H5Dwrite_chunk 写入，H5Dread_chunk 读出的原始分块也可以直接解码
+class ChunkCodec
+{
+public:
+    // 该过滤器及参数组合是否有进程内实现（编译时可选库：zstd 需要 HAVE_ZSTD，VBZ 的 zstd 级别非 0 时也需要，lz4 需要 HAVE_LZ4）
+    static bool supports(int filter_id, const std::vector<unsigned int> &cd_values, size_t type_size);
+
+    // 按过滤器 ID 和数据集上最终生效的 cd_values 编码一个分块
+    // type_size 为元素字节数；失败时返回 false
+    static bool encode(int filter_id,
+                       const std::vector<unsigned int> &cd_values,
+                       size_t type_size,
+                       const unsigned char *input,
+                       size_t input_bytes,
+                       std::vector<unsigned char> &output);
+
+    // encode 的逆过程：按过滤器格式解码一个分块。expected_bytes 为解码后的预期字节数
+    // （格式本身不记录原始长度时使用，例如 deflate）
+    static bool decode(int filter_id,
+                       const std::vector<unsigned int> &cd_values,
+                       size_t type_size,
+                       const unsigned char *input,
+                       size_t input_bytes,
+                       size_t expected_bytes,
+                       std::vector<unsigned char> &output);
+
+    // 进程内可用的编码器名称列表，用于日志
+    static std::string supportedList();
+
+private:
+    static bool encodeDeflate(const std::vector<unsigned int> &cd_values, const unsigned char *input,
+                              size_t input_bytes, std::vector<unsigned char> &output);
+    static bool encodeShuffle(const std::vector<unsigned int> &cd_values, size_t type_size,
+                              const unsigned char *input, size_t input_bytes, std::vector<unsigned char> &output);
+    static bool encodeZstd(const std::vector<unsigned int> &cd_values, const unsigned char *input,
+                           size_t input_bytes, std::vector<unsigned char> &output);
+    static bool encodeLz4(const std::vector<unsigned int> &cd_values, const unsigned char *input,
+                          size_t input_bytes, std::vector<unsigned char> &output);
+    static bool encodeVbz(const std::vector<unsigned int> &cd_values, const unsigned char *input,
+                          size_t input_bytes, std::vector<unsigned char> &output);
+
+    static bool decodeDeflate(const unsigned char *input, size_t input_bytes, size_t expected_bytes,
+                              std::vector<unsigned char> &output);
+    static bool decodeShuffle(const std::vector<unsigned int> &cd_values, size_t type_size,
+                              const unsigned char *input, size_t input_bytes, std::vector<unsigned char> &output);
+    static bool decodeZstd(const unsigned char *input, size_t input_bytes, size_t expected_bytes,
+                           std::vector<unsigned char> &output);
+    static bool decodeLz4(const unsigned char *input, size_t input_bytes, std::vector<unsigned char> &output);
+    static bool decodeVbz(const std::vector<unsigned int> &cd_values, const unsigned char *input,
+                          size_t input_bytes, std::vector<unsigned char> &output);
+};
+
+#endif // CHUNK_CODEC_HPP
@@ -0,0 +1,245 @@
+#include "chunk_read_engine.hpp"
+#include "chunk_codec.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+ChunkReadEngine::ChunkReadEngine(int threads)
+{
+    threads = std::max(1, threads);
+    // 限制已读出但尚未解码的原始分块占用的内存
+    max_in_flight_bytes_ = static_cast<size_t>(threads) * 16 * 1024 * 1024;
+    for (int i = 0; i < threads; ++i)
+    {
+        workers_.emplace_back(&ChunkReadEngine::workerLoop, this);
+    }
+}
+
+ChunkReadEngine::~ChunkReadEngine()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+bool ChunkReadEngine::submit(hid_t dset_id, const std::string &path, int16_t *output, size_t elements)
+{
+    hid_t type_id = H5Dget_type(dset_id);
+    bool native_int16 = H5Tequal(type_id, H5T_NATIVE_INT16) > 0;
+    H5Tclose(type_id);
+    if (!native_int16)
+    {
+        return false;
+    }
+
+    hid_t dcpl_id = H5Dget_create_plist(dset_id);
+    if (dcpl_id < 0)
+    {
+        return false;
+    }
+    if (H5Pget_layout(dcpl_id) != H5D_CHUNKED)
+    {
+        H5Pclose(dcpl_id);
+        return false;
+    }
+
+    // 过滤器管线：全部过滤器都要有进程内解码实现
+    auto pipeline = std::make_shared<Pipeline>();
+    int nfilters = H5Pget_nfilters(dcpl_id);
+    bool supported = nfilters >= 0;
+    for (int i = 0; i < nfilters && supported; ++i)
+    {
+        unsigned int flags = 0;
+        size_t cd_nelmts = 16;
+        std::vector<unsigned int> cd_values(cd_nelmts);
+        unsigned int filter_config = 0;
+        H5Z_filter_t filter_id = H5Pget_filter2(dcpl_id, static_cast<unsigned>(i), &flags, &cd_nelmts,
+                                                cd_values.data(), 0, NULL, &filter_config);
+        cd_values.resize(std::min(cd_nelmts, cd_values.size()));
+        supported = filter_id >= 0 && ChunkCodec::supports(filter_id, cd_values, sizeof(int16_t));
+        pipeline->filter_ids.push_back(filter_id);
+        pipeline->cd_values.push_back(cd_values);
+    }
+
+    hsize_t chunk_dims[3] = {1, 1, 1};
+    int rank = H5Pget_chunk(dcpl_id, 3, chunk_dims);
+    int16_t fill_value = 0;
+    H5Pget_fill_value(dcpl_id, H5T_NATIVE_INT16, &fill_value);
+    H5Pclose(dcpl_id);
+    if (!supported || rank < 1 || rank > 3)
+    {
+        return false;
+    }
+
+    hid_t space_id = H5Dget_space(dset_id);
+    hsize_t dims[3] = {1, 1, 1};
+    H5Sget_simple_extent_dims(space_id, dims, NULL);
+    hsize_t num_chunks = 0;
+    if (H5Dget_num_chunks(dset_id, space_id, &num_chunks) < 0)
+    {
+        H5Sclose(space_id);
+        return false;
+    }
+
+    // 未分配的分块读出来是填充值
+    hsize_t total_chunks = 1;
+    for (int d = 0; d < rank; ++d)
+    {
+        total_chunks *= (dims[d] + chunk_dims[d] - 1) / chunk_dims[d];
+    }
+    if (num_chunks < total_chunks)
+    {
+        std::fill(output, output + elements, fill_value);
+    }
+
+    for (hsize_t index = 0; index < num_chunks; ++index)
+    {
+        auto job = std::make_unique<Job>();
+        job->path = path;
+        job->pipeline = pipeline;
+        job->rank = rank;
+        job->output = output;
+        for (int d = 0; d < rank; ++d)
+        {
+            job->dims[d] = dims[d];
+            job->chunk_dims[d] = chunk_dims[d];
+        }
+
+        haddr_t address = 0;
+        hsize_t raw_size = 0;
+        if (H5Dget_chunk_info(dset_id, space_id, index, job->offset, &job->filter_mask, &address, &raw_size) < 0)
+        {
+            std::cerr << "Failed to get chunk info of " << path << std::endl;
+            H5Sclose(space_id);
+            finish();
+            failed_paths_.push_back(path);
+            return true;
+        }
+        job->raw.resize(static_cast<size_t>(raw_size));
+        uint32_t read_mask = 0;
+        if (H5Dread_chunk(dset_id, H5P_DEFAULT, job->offset, &read_mask, job->raw.data()) < 0)
+        {
+            std::cerr << "Failed to read raw chunk of " << path << std::endl;
+            H5Sclose(space_id);
+            finish();
+            failed_paths_.push_back(path);
+            return true;
+        }
+        job->filter_mask = read_mask;
+        ++chunks_read_;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            // 在途原始数据过多时等待工作线程消化
+            done_cv_.wait(lock, [this]
+                          { return in_flight_bytes_ <= max_in_flight_bytes_; });
+            in_flight_++;
+            in_flight_bytes_ += job->raw.size();
+            work_queue_.push_back(std::move(job));
+        }
+        work_cv_.notify_one();
+    }
+    H5Sclose(space_id);
+    return true;
+}
+
+bool ChunkReadEngine::decodeJob(Job &job)
+{
+    size_t chunk_elements = 1;
+    for (int d = 0; d < job.rank; ++d)
+    {
+        chunk_elements *= job.chunk_dims[d];
+    }
+    size_t chunk_bytes = chunk_elements * sizeof(int16_t);
+
+    // 过滤器按写入时的逆序解码，filter_mask 中标记跳过的过滤器不处理
+    std::vector<unsigned char> current = std::move(job.raw);
+    std::vector<unsigned char> next;
+    const Pipeline &pipeline = *job.pipeline;
+    for (size_t i = pipeline.filter_ids.size(); i-- > 0;)
+    {
+        if (job.filter_mask & (1U << i))
+        {
+            continue;
+        }
+        if (!ChunkCodec::decode(pipeline.filter_ids[i], pipeline.cd_values[i], sizeof(int16_t),
+                                current.data(), current.size(), chunk_bytes, next))
+        {
+            return false;
+        }
+        current.swap(next);
+    }
+    if (current.size() < chunk_bytes)
+    {
+        return false;
+    }
+
+    // 把分块中位于数据集范围内的部分写到输出缓冲区
+    const int16_t *chunk = reinterpret_cast<const int16_t *>(current.data());
+    hsize_t extent[3] = {1, 1, 1};
+    for (int d = 0; d < job.rank; ++d)
+    {
+        extent[d] = std::min(job.chunk_dims[d], job.dims[d] - job.offset[d]);
+    }
+    hsize_t dims1 = job.rank > 1 ? job.dims[1] : 1;
+    hsize_t dims2 = job.rank > 2 ? job.dims[2] : 1;
+    hsize_t cdims1 = job.rank > 1 ? job.chunk_dims[1] : 1;
+    hsize_t cdims2 = job.rank > 2 ? job.chunk_dims[2] : 1;
+    for (hsize_t i = 0; i < extent[0]; ++i)
+    {
+        for (hsize_t j = 0; j < extent[1]; ++j)
+        {
+            size_t dst_index = ((job.offset[0] + i) * dims1 + (job.offset[1] + j)) * dims2 + job.offset[2];
+            size_t src_index = (i * cdims1 + j) * cdims2;
+            std::memcpy(job.output + dst_index, chunk + src_index, extent[2] * sizeof(int16_t));
+        }
+    }
+    return true;
+}
+
+void ChunkReadEngine::workerLoop()
+{
+    while (true)
+    {
+        std::unique_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this]
+                          { return stopping_ || !work_queue_.empty(); });
+            if (work_queue_.empty())
+            {
+                return;
+            }
+            job = std::move(work_queue_.front());
+            work_queue_.pop_front();
+        }
+
+        size_t raw_bytes = job->raw.size();
+        bool ok = decodeJob(*job);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            in_flight_--;
+            in_flight_bytes_ -= raw_bytes;
+            if (!ok && std::find(failed_paths_.begin(), failed_paths_.end(), job->path) == failed_paths_.end())
+            {
+                failed_paths_.push_back(job->path);
+            }
+        }
+        done_cv_.notify_all();
+    }
+}
+
+bool ChunkReadEngine::finish()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]
+                  { return in_flight_ == 0; });
+    return failed_paths_.empty();
+}
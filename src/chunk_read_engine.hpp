@@ -0,0 +1,75 @@
+#ifndef CHUNK_READ_ENGINE_HPP
+#define CHUNK_READ_ENGINE_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <hdf5.h>
+
+// 分块并行解码引擎：调用者线程用 H5Dread_chunk 取出原始（已压缩）分块，
+// 工作线程在进程内按数据集的过滤器管线逆序解码并写入目标缓冲区。HDF5 调用全部发生在调用者线程上。
+class ChunkReadEngine
+{
+public:
+    explicit ChunkReadEngine(int threads);
+    ~ChunkReadEngine();
+
+    ChunkReadEngine(const ChunkReadEngine &) = delete;
+    ChunkReadEngine &operator=(const ChunkReadEngine &) = delete;
+
+    // 提交一个数据集的全部分块，解码结果按原生 int16 写入 output（须有 elements 个元素）。
+    // 数据集不是分块布局、类型不是 int16 或管线中有进程内不支持的过滤器时返回 false，调用者应改用 H5Dread。
+    // 返回 true 后原始分块已全部读出，dset_id 可以立即关闭，但 output 在 finish() 之前不能使用
+    bool submit(hid_t dset_id, const std::string &path, int16_t *output, size_t elements);
+
+    // 等待全部已提交的分块解码完成，全部成功时返回 true
+    bool finish();
+
+    // 解码失败的数据集路径
+    const std::vector<std::string> &failedPaths() const { return failed_paths_; }
+    size_t chunksRead() const { return chunks_read_; }
+    int threads() const { return static_cast<int>(workers_.size()); }
+
+private:
+    struct Pipeline
+    {
+        std::vector<int> filter_ids;
+        std::vector<std::vector<unsigned int>> cd_values;
+    };
+
+    struct Job
+    {
+        std::string path;
+        std::shared_ptr<const Pipeline> pipeline;
+        unsigned int filter_mask = 0; // 第 i 位为 1 表示该分块跳过了第 i 个过滤器
+        int rank = 0;
+        hsize_t dims[3] = {1, 1, 1};
+        hsize_t chunk_dims[3] = {1, 1, 1};
+        hsize_t offset[3] = {0, 0, 0};
+        std::vector<unsigned char> raw;
+        int16_t *output = nullptr;
+    };
+
+    void workerLoop();
+    static bool decodeJob(Job &job);
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::deque<std::unique_ptr<Job>> work_queue_;
+    size_t in_flight_ = 0;       // 已提交但尚未解码完成的分块数
+    size_t in_flight_bytes_ = 0; // 其原始数据占用的字节数
+    size_t max_in_flight_bytes_;
+    bool stopping_ = false;
+
+    std::vector<std::string> failed_paths_;
+    size_t chunks_read_ = 0;
+};
+
+#endif // CHUNK_READ_ENGINE_HPP
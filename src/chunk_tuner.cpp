@@ -0,0 +1,292 @@
+#include "chunk_tuner.hpp"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cctype>
+#include <cstdlib>
+
+using namespace std::chrono;
+
+ChunkTuner::ChunkTuner(const Options &options) : options_(options)
+{
+    if (options_.candidates.empty())
+    {
+        options_.candidates = Options().candidates;
+    }
+    std::sort(options_.candidates.begin(), options_.candidates.end());
+}
+
+bool ChunkTuner::parseChunkSize(const std::string &text, size_t &elements)
+{
+    if (text == "auto")
+    {
+        elements = kAuto;
+        return true;
+    }
+    if (text == "full")
+    {
+        elements = 0;
+        return true;
+    }
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0])))
+    {
+        return false;
+    }
+    char *end = nullptr;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    std::string suffix(end);
+    if (suffix == "K" || suffix == "k")
+    {
+        value *= 1024;
+    }
+    else if (suffix == "M" || suffix == "m")
+    {
+        value *= 1024 * 1024;
+    }
+    else if (!suffix.empty())
+    {
+        return false;
+    }
+    elements = static_cast<size_t>(value);
+    return true;
+}
+
+std::string ChunkTuner::formatChunkSize(size_t elements)
+{
+    if (elements == kAuto)
+    {
+        return "auto";
+    }
+    if (elements == 0)
+    {
+        return "full";
+    }
+    if (elements % (1024 * 1024) == 0)
+    {
+        return std::to_string(elements / (1024 * 1024)) + "M";
+    }
+    if (elements % 1024 == 0)
+    {
+        return std::to_string(elements / 1024) + "K";
+    }
+    return std::to_string(elements);
+}
+
+size_t ChunkTuner::chunkDims(int rank, const hsize_t *dims, size_t element_size,
+                             size_t chunk_elements, hsize_t *chunk_dims)
+{
+    size_t limit = kMaxChunkBytes / std::max<size_t>(element_size, 1);
+    size_t target = chunk_elements == 0 || chunk_elements == kAuto ? limit : std::min(chunk_elements, limit);
+    size_t remaining = std::max<size_t>(target, 1);
+    size_t total = 1;
+    for (int d = rank - 1; d >= 0; --d)
+    {
+        hsize_t extent = std::max<hsize_t>(dims[d], 1);
+        chunk_dims[d] = std::max<hsize_t>(1, std::min<hsize_t>(extent, remaining));
+        remaining = std::max<size_t>(1, remaining / chunk_dims[d]);
+        total *= chunk_dims[d];
+    }
+    return total;
+}
+
+double ChunkTuner::measureSliceReads(hid_t dset_id, int reads, size_t slice_elements, unsigned int seed)
+{
+    if (reads <= 0)
+    {
+        return 0.0;
+    }
+    hid_t space_id = H5Dget_space(dset_id);
+    int rank = H5Sget_simple_extent_ndims(space_id);
+    hsize_t dims[3] = {0, 1, 1};
+    if (rank < 1 || rank > 3)
+    {
+        H5Sclose(space_id);
+        return 0.0;
+    }
+    H5Sget_simple_extent_dims(space_id, dims, NULL);
+    if (dims[0] == 0)
+    {
+        H5Sclose(space_id);
+        return 0.0;
+    }
+
+    // 切片沿第一维取连续的若干行，后面各维完整读取
+    size_t row_elements = 1;
+    for (int d = 1; d < rank; ++d)
+    {
+        row_elements *= dims[d];
+    }
+    hsize_t rows = std::min<hsize_t>(dims[0], std::max<size_t>(1, slice_elements / std::max<size_t>(row_elements, 1)));
+    hsize_t count[3] = {rows, dims[1], dims[2]};
+    hsize_t start[3] = {0, 0, 0};
+    std::vector<int16_t> buffer(static_cast<size_t>(rows) * row_elements);
+    hid_t mem_space_id = H5Screate_simple(rank, count, NULL);
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<hsize_t> position(0, dims[0] - rows);
+    steady_clock::duration total(0);
+    int completed = 0;
+    for (int i = 0; i < reads; ++i)
+    {
+        start[0] = position(rng);
+        H5Sselect_hyperslab(space_id, H5S_SELECT_SET, start, NULL, count, NULL);
+        auto read_start = steady_clock::now();
+        herr_t status = H5Dread(dset_id, H5T_NATIVE_INT16, mem_space_id, space_id, H5P_DEFAULT, buffer.data());
+        total += steady_clock::now() - read_start;
+        if (status >= 0)
+        {
+            ++completed;
+        }
+    }
+    H5Sclose(mem_space_id);
+    H5Sclose(space_id);
+    return completed > 0 ? duration_cast<duration<double, std::micro>>(total).count() / completed : 0.0;
+}
+
+hsize_t ChunkTuner::sampleRows(int rank, const hsize_t *dims) const
+{
+    size_t row_elements = 1;
+    for (int d = 1; d < rank; ++d)
+    {
+        row_elements *= dims[d];
+    }
+    size_t sample_elements = options_.candidates.back() * 4;
+    hsize_t rows = (sample_elements + row_elements - 1) / std::max<size_t>(row_elements, 1);
+    return std::min<hsize_t>(dims[0], std::max<hsize_t>(rows, 1));
+}
+
+size_t ChunkTuner::tune(hid_t type_id, int rank, const hsize_t *dims, const int16_t *data,
+                        const FilterApplier &apply_filters, std::vector<Candidate> *measured) const
+{
+    // 候选在内存文件中测量，不写盘，也不影响目标文件
+    hid_t fapl_id = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_core(fapl_id, 16 * 1024 * 1024, false);
+    hid_t file_id = H5Fcreate("chunk_tuner.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    H5Pclose(fapl_id);
+    if (file_id < 0)
+    {
+        std::cerr << "Failed to create in-memory file for chunk tuning" << std::endl;
+        return 0;
+    }
+
+    // 关闭分块缓存，随机切片读取的延迟包含每次的分块解码
+    hid_t dapl_id = H5Pcreate(H5P_DATASET_ACCESS);
+    H5Pset_chunk_cache(dapl_id, 0, 0, H5D_CHUNK_CACHE_W0_DEFAULT);
+
+    hid_t space_id = H5Screate_simple(rank, dims, NULL);
+    size_t elements = 1;
+    for (int d = 0; d < rank; ++d)
+    {
+        elements *= dims[d];
+    }
+    size_t sample_bytes = elements * sizeof(int16_t);
+    size_t element_size = H5Tget_size(type_id);
+
+    std::vector<Candidate> candidates;
+    std::vector<size_t> sample_chunks;
+    for (size_t candidate : options_.candidates)
+    {
+        // 比样本还大的候选在样本上与整个样本一个分块没有区别，只保留其中最小的一个
+        hsize_t chunk_dims[3] = {1, 1, 1};
+        size_t sample_chunk = chunkDims(rank, dims, element_size, candidate, chunk_dims);
+        if (std::find(sample_chunks.begin(), sample_chunks.end(), sample_chunk) != sample_chunks.end())
+        {
+            continue;
+        }
+        sample_chunks.push_back(sample_chunk);
+
+        hid_t dcpl_id = H5Pcreate(H5P_DATASET_CREATE);
+        H5Pset_chunk(dcpl_id, rank, chunk_dims);
+        std::string name = "candidate_" + std::to_string(candidate);
+        hid_t dset_id = -1;
+        if (apply_filters(dcpl_id))
+        {
+            dset_id = H5Dcreate(file_id, name.c_str(), type_id, space_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT);
+        }
+        H5Pclose(dcpl_id);
+        if (dset_id < 0)
+        {
+            continue;
+        }
+
+        auto encode_start = steady_clock::now();
+        herr_t status = H5Dwrite(dset_id, H5T_NATIVE_INT16, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+        if (status >= 0)
+        {
+            status = H5Dflush(dset_id);
+        }
+        double encode_seconds = duration_cast<duration<double>>(steady_clock::now() - encode_start).count();
+        hsize_t storage_size = H5Dget_storage_size(dset_id);
+        H5Dclose(dset_id);
+        if (status < 0 || storage_size == 0)
+        {
+            continue;
+        }
+
+        Candidate result;
+        result.chunk_elements = candidate;
+        result.ratio = static_cast<double>(sample_bytes) / storage_size;
+        result.encode_mbps = encode_seconds > 0 ? sample_bytes / (1024.0 * 1024.0) / encode_seconds : 0.0;
+        dset_id = H5Dopen(file_id, name.c_str(), dapl_id);
+        if (dset_id >= 0)
+        {
+            result.slice_read_us = measureSliceReads(dset_id, options_.slice_reads, options_.slice_elements,
+                                                     static_cast<unsigned int>(candidate));
+            H5Dclose(dset_id);
+        }
+        candidates.push_back(result);
+    }
+    H5Sclose(space_id);
+    H5Pclose(dapl_id);
+    H5Fclose(file_id);
+
+    if (candidates.empty())
+    {
+        return 0;
+    }
+
+    // 各指标先除以候选中的最优值归一化到 (0, 1]，再按权重加权平均
+    double best_ratio = 0.0;
+    double best_mbps = 0.0;
+    double best_latency = 0.0;
+    for (const auto &candidate : candidates)
+    {
+        best_ratio = std::max(best_ratio, candidate.ratio);
+        best_mbps = std::max(best_mbps, candidate.encode_mbps);
+        if (candidate.slice_read_us > 0 && (best_latency == 0 || candidate.slice_read_us < best_latency))
+        {
+            best_latency = candidate.slice_read_us;
+        }
+    }
+    Weights weights = options_.weights;
+    if (best_latency == 0)
+    {
+        weights.read = 0;
+    }
+    double weight_sum = weights.ratio + weights.encode + weights.read;
+    if (weight_sum <= 0)
+    {
+        weights.ratio = weight_sum = 1.0;
+    }
+
+    size_t best = 0;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        Candidate &candidate = candidates[i];
+        double score = weights.ratio * candidate.ratio / best_ratio;
+        score += best_mbps > 0 ? weights.encode * candidate.encode_mbps / best_mbps : 0.0;
+        score += candidate.slice_read_us > 0 ? weights.read * best_latency / candidate.slice_read_us : 0.0;
+        candidate.score = score / weight_sum;
+        if (candidate.score > candidates[best].score)
+        {
+            best = i;
+        }
+    }
+
+    if (measured != nullptr)
+    {
+        *measured = candidates;
+    }
+    return candidates[best].chunk_elements;
+}
@@ -0,0 +1,78 @@
+#ifndef CHUNK_TUNER_HPP
+#define CHUNK_TUNER_HPP
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <hdf5.h>
+
+// Signal 数据集的分块形状：分块大小的解析、按 4 GiB 上限计算分块尺寸、随机切片读取延迟测量，
+// 以及按数据集自动选择分块大小（--chunk-sizes auto）
+class ChunkTuner
+{
+public:
+    // HDF5 的分块大小以 32 位记录，单个分块不能达到 4 GiB
+    static constexpr size_t kMaxChunkBytes = 0xFFFFFFFFull;
+    // 分块大小 0 表示整个数据集一个分块（受上限约束），kAuto 表示按数据集自动调优
+    static constexpr size_t kAuto = static_cast<size_t>(-1);
+
+    // 调优得分中压缩比、编码吞吐量和随机切片读取延迟的权重
+    struct Weights
+    {
+        double ratio = 1.0;
+        double encode = 1.0;
+        double read = 1.0;
+    };
+
+    struct Options
+    {
+        std::vector<size_t> candidates = {4096, 16384, 65536, 262144, 1048576}; // 候选分块大小（元素数）
+        Weights weights;
+        int slice_reads = 32;        // 每次测量的随机切片读取次数，0 表示不测
+        size_t slice_elements = 4096; // 每次切片读取的元素数
+    };
+
+    // 一个候选分块大小在样本上的测量结果
+    struct Candidate
+    {
+        size_t chunk_elements = 0;
+        double ratio = 0.0;
+        double encode_mbps = 0.0;
+        double slice_read_us = 0.0;
+        double score = 0.0;
+    };
+
+    // 过滤器管线加入数据集创建属性
+    using FilterApplier = std::function<bool(hid_t dcpl_id)>;
+
+    explicit ChunkTuner(const Options &options);
+
+    const Options &options() const { return options_; }
+
+    // 解析 "65536"、"64K"、"1M"、"full"（或 0）和 "auto"，K/M 按 1024 计
+    static bool parseChunkSize(const std::string &text, size_t &elements);
+    static std::string formatChunkSize(size_t elements);
+
+    // 按目标元素数计算分块尺寸：从最后一维开始尽量保留完整维度，剩余额度分给前面的维度，
+    // 并保证分块字节数不超过 kMaxChunkBytes。返回分块的元素数
+    static size_t chunkDims(int rank, const hsize_t *dims, size_t element_size,
+                            size_t chunk_elements, hsize_t *chunk_dims);
+
+    // 在已打开的数据集上做 reads 次随机位置的切片读取，返回平均延迟（微秒）；
+    // 调用者应以关闭了分块缓存的访问属性打开数据集，使每次读取都包含分块解码
+    static double measureSliceReads(hid_t dset_id, int reads, size_t slice_elements, unsigned int seed);
+
+    // 调优使用的样本行数：数据集开头的若干行，至少覆盖最大候选分块的 4 倍
+    hsize_t sampleRows(int rank, const hsize_t *dims) const;
+
+    // 把样本（dims 为样本形状，数据为 int16）按每个候选分块大小写入内存文件，
+    // 测量压缩比、编码吞吐量和随机切片读取延迟，返回得分最高的分块大小；全部失败时返回 0
+    size_t tune(hid_t type_id, int rank, const hsize_t *dims, const int16_t *data,
+                const FilterApplier &apply_filters, std::vector<Candidate> *measured = nullptr) const;
+
+private:
+    Options options_;
+};
+
+#endif // CHUNK_TUNER_HPP
@@ -0,0 +1,323 @@
+#include "chunk_write_engine.hpp"
+#include "chunk_codec.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+ChunkWriteEngine::ChunkWriteEngine(int threads)
+{
+    threads = std::max(1, threads);
+    // 限制已提交但尚未写入的分块数量，避免编码结果无限堆积在内存中
+    max_in_flight_ = static_cast<size_t>(threads) * 4;
+    for (int i = 0; i < threads; ++i)
+    {
+        workers_.emplace_back(&ChunkWriteEngine::workerLoop, this);
+    }
+}
+
+ChunkWriteEngine::~ChunkWriteEngine()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+size_t ChunkWriteEngine::ChunkLayout::chunkBytes() const
+{
+    size_t elements = 1;
+    for (int d = 0; d < rank; ++d)
+    {
+        elements *= chunk_dims[d];
+    }
+    return elements * type_size;
+}
+
+size_t ChunkWriteEngine::ChunkLayout::chunkCount() const
+{
+    size_t count = 1;
+    for (int d = 0; d < rank; ++d)
+    {
+        count *= (dims[d] + chunk_dims[d] - 1) / chunk_dims[d];
+    }
+    return count;
+}
+
+void ChunkWriteEngine::ChunkLayout::chunkOffset(size_t index, hsize_t offset[3]) const
+{
+    offset[0] = offset[1] = offset[2] = 0;
+    for (int d = rank - 1; d >= 0; --d)
+    {
+        hsize_t grid = (dims[d] + chunk_dims[d] - 1) / chunk_dims[d];
+        offset[d] = (index % grid) * chunk_dims[d];
+        index /= grid;
+    }
+}
+
+bool ChunkWriteEngine::readLayout(hid_t dset_id, ChunkLayout &layout)
+{
+    hid_t dcpl_id = H5Dget_create_plist(dset_id);
+    if (dcpl_id < 0)
+    {
+        return false;
+    }
+    if (H5Pget_layout(dcpl_id) != H5D_CHUNKED)
+    {
+        H5Pclose(dcpl_id);
+        return false;
+    }
+
+    layout.filter_ids.clear();
+    layout.cd_values.clear();
+    int nfilters = H5Pget_nfilters(dcpl_id);
+    for (int i = 0; i < nfilters; ++i)
+    {
+        unsigned int flags = 0;
+        size_t cd_nelmts = 16;
+        std::vector<unsigned int> cd_values(cd_nelmts, 0);
+        unsigned int filter_config = 0;
+        H5Z_filter_t filter_id = H5Pget_filter2(dcpl_id, static_cast<unsigned>(i), &flags, &cd_nelmts,
+                                                cd_values.data(), 0, NULL, &filter_config);
+        cd_values.resize(std::min(cd_nelmts, cd_values.size()));
+        layout.filter_ids.push_back(filter_id);
+        layout.cd_values.push_back(cd_values);
+    }
+    layout.rank = H5Pget_chunk(dcpl_id, 3, layout.chunk_dims);
+    H5Pclose(dcpl_id);
+
+    hid_t type_id = H5Dget_type(dset_id);
+    layout.type_size = H5Tget_size(type_id);
+    H5Tclose(type_id);
+
+    if (nfilters < 0 || layout.rank < 1 || layout.rank > 3)
+    {
+        return false;
+    }
+
+    hid_t space_id = H5Dget_space(dset_id);
+    H5Sget_simple_extent_dims(space_id, layout.dims, NULL);
+    H5Sclose(space_id);
+    return true;
+}
+
+bool ChunkWriteEngine::describe(hid_t dset_id, ChunkLayout &layout)
+{
+    if (!readLayout(dset_id, layout) || layout.filter_ids.empty())
+    {
+        return false;
+    }
+
+    // 过滤器在本进程不可用时库会跳过可选过滤器，直写的分块将无法被本进程校验，因此也回退
+    for (size_t i = 0; i < layout.filter_ids.size(); ++i)
+    {
+        if (layout.filter_ids[i] < 0 || H5Zfilter_avail(layout.filter_ids[i]) <= 0 ||
+            !ChunkCodec::supports(layout.filter_ids[i], layout.cd_values[i], layout.type_size))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const unsigned char *ChunkWriteEngine::gatherChunk(const ChunkLayout &layout, const unsigned char *data,
+                                                   const hsize_t offset[3], std::vector<unsigned char> &buffer)
+{
+    // 完整位于数据集内的一维分块直接引用源内存，其余情况（多维或边缘分块）
+    // 复制到按完整分块大小补零的缓冲区，与库写入边缘分块的方式一致
+    size_t type_size = layout.type_size;
+    if (layout.rank == 1 && offset[0] + layout.chunk_dims[0] <= layout.dims[0])
+    {
+        return data + offset[0] * type_size;
+    }
+
+    buffer.assign(layout.chunkBytes(), 0);
+    hsize_t extent[3] = {1, 1, 1};
+    for (int d = 0; d < layout.rank; ++d)
+    {
+        extent[d] = std::min(layout.chunk_dims[d], layout.dims[d] - offset[d]);
+    }
+    hsize_t dims1 = layout.rank > 1 ? layout.dims[1] : 1;
+    hsize_t dims2 = layout.rank > 2 ? layout.dims[2] : 1;
+    hsize_t cdims1 = layout.rank > 1 ? layout.chunk_dims[1] : 1;
+    hsize_t cdims2 = layout.rank > 2 ? layout.chunk_dims[2] : 1;
+    for (hsize_t i = 0; i < extent[0]; ++i)
+    {
+        for (hsize_t j = 0; j < extent[1]; ++j)
+        {
+            size_t src_index = ((offset[0] + i) * dims1 + (offset[1] + j)) * dims2 + offset[2];
+            size_t dst_index = (i * cdims1 + j) * cdims2;
+            std::memcpy(buffer.data() + dst_index * type_size,
+                        data + src_index * type_size,
+                        extent[2] * type_size);
+        }
+    }
+    return buffer.data();
+}
+
+bool ChunkWriteEngine::encodeChunk(const ChunkLayout &layout, const unsigned char *data, const hsize_t offset[3],
+                                   std::vector<unsigned char> &output)
+{
+    std::vector<unsigned char> gathered;
+    const unsigned char *input = gatherChunk(layout, data, offset, gathered);
+    size_t input_bytes = layout.chunkBytes();
+
+    // 各级依次编码，上一级的输出是下一级的输入
+    std::vector<unsigned char> stage_input;
+    for (size_t i = 0; i < layout.filter_ids.size(); ++i)
+    {
+        if (!ChunkCodec::encode(layout.filter_ids[i], layout.cd_values[i], layout.type_size,
+                                input, input_bytes, output))
+        {
+            return false;
+        }
+        if (i + 1 < layout.filter_ids.size())
+        {
+            stage_input.swap(output);
+            input = stage_input.data();
+            input_bytes = stage_input.size();
+        }
+    }
+    return true;
+}
+
+bool ChunkWriteEngine::submit(hid_t dset_id,
+                              const std::string &path,
+                              const unsigned char *data,
+                              std::shared_ptr<const void> keepalive)
+{
+    auto layout = std::make_shared<ChunkLayout>();
+    if (!describe(dset_id, *layout))
+    {
+        return false;
+    }
+
+    // 按行优先顺序遍历分块网格，每个分块一个任务
+    size_t chunks = layout->chunkCount();
+    for (size_t index = 0; index < chunks; ++index)
+    {
+        auto job = std::make_unique<Job>();
+        job->dset_id = dset_id;
+        job->path = path;
+        job->layout = layout;
+        layout->chunkOffset(index, job->offset);
+        job->data = data;
+        job->keepalive = keepalive;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            work_queue_.push_back(job.get());
+            pending_.push_back(std::move(job));
+        }
+        work_cv_.notify_one();
+
+        // 在途分块过多时先写出队首，限制内存占用
+        while (pending_.size() > max_in_flight_)
+        {
+            commitFront();
+        }
+    }
+    return true;
+}
+
+void ChunkWriteEngine::workerLoop()
+{
+    while (true)
+    {
+        Job *job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this]
+                          { return stopping_ || !work_queue_.empty(); });
+            if (work_queue_.empty())
+            {
+                return;
+            }
+            job = work_queue_.front();
+            work_queue_.pop_front();
+        }
+
+        job->ok = encodeChunk(*job->layout, job->data, job->offset, job->encoded);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job->done = true;
+        }
+        done_cv_.notify_all();
+    }
+}
+
+void ChunkWriteEngine::markFailed(const std::string &path)
+{
+    if (std::find(failed_paths_.begin(), failed_paths_.end(), path) == failed_paths_.end())
+    {
+        failed_paths_.push_back(path);
+    }
+}
+
+void ChunkWriteEngine::commitFront()
+{
+    std::unique_ptr<Job> job;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (pending_.empty())
+        {
+            return;
+        }
+        done_cv_.wait(lock, [this]
+                      { return pending_.front()->done; });
+        job = std::move(pending_.front());
+        pending_.pop_front();
+    }
+
+    if (!job->ok)
+    {
+        std::cerr << "Failed to encode chunk of " << job->path << std::endl;
+        markFailed(job->path);
+        return;
+    }
+
+    // filter_mask 为 0：管线中的过滤器全部已应用
+    if (H5Dwrite_chunk(job->dset_id, H5P_DEFAULT, 0, job->offset, job->encoded.size(), job->encoded.data()) < 0)
+    {
+        std::cerr << "Failed to write chunk of " << job->path << std::endl;
+        markFailed(job->path);
+        return;
+    }
+    ++chunks_written_;
+}
+
+void ChunkWriteEngine::commitReady()
+{
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.empty() || !pending_.front()->done)
+            {
+                return;
+            }
+        }
+        commitFront();
+    }
+}
+
+bool ChunkWriteEngine::finish()
+{
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.empty())
+            {
+                break;
+            }
+        }
+        commitFront();
+    }
+    return failed_paths_.empty();
+}
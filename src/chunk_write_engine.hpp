@@ -0,0 +1,108 @@
+#ifndef CHUNK_WRITE_ENGINE_HPP
+#define CHUNK_WRITE_ENGINE_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <hdf5.h>
+
+// 分块直写引擎：工作线程在进程内编码分块（不经过 HDF5 过滤器管线，因而不受库的全局锁限制），
+// 主线程按提交顺序用 H5Dwrite_chunk 写入已编码的分块。HDF5 调用全部发生在调用者线程上。
+// 数据集各级过滤器的 ID 与 cd_values 取自数据集创建属性（即库在 set_local 之后实际记录的值），
+// 按管线顺序依次编码，因此写出的分块和走过滤器管线得到的分块格式一致。
+class ChunkWriteEngine
+{
+public:
+    // 目标数据集的分块布局与过滤器管线（按写入时的应用顺序）
+    struct ChunkLayout
+    {
+        std::vector<int> filter_ids;
+        std::vector<std::vector<unsigned int>> cd_values;
+        size_t type_size = 0;
+        int rank = 0;
+        hsize_t dims[3] = {1, 1, 1};
+        hsize_t chunk_dims[3] = {1, 1, 1};
+
+        size_t chunkBytes() const;
+        size_t chunkCount() const;
+        // 第 index 个分块（行优先）的起始坐标
+        void chunkOffset(size_t index, hsize_t offset[3]) const;
+    };
+
+    // 读取数据集的分块形状与实际生效的过滤器管线，不检查是否有进程内编码器；
+    // 不是 1-3 维分块数据集时返回 false。须在持有 HDF5 调用权的线程上调用
+    static bool readLayout(hid_t dset_id, ChunkLayout &layout);
+
+    // readLayout，并且管线非空、每一级都有进程内编码器且库中可用（以便校验）时返回 true
+    static bool describe(hid_t dset_id, ChunkLayout &layout);
+
+    // 取出 data（整个数据集）中起始于 offset 的分块：完整的一维分块直接指向 data，
+    // 其余情况复制到 buffer 并补零到完整分块大小；线程安全
+    static const unsigned char *gatherChunk(const ChunkLayout &layout, const unsigned char *data,
+                                            const hsize_t offset[3], std::vector<unsigned char> &buffer);
+
+    // 按管线顺序编码 data 中起始于 offset 的分块；线程安全
+    static bool encodeChunk(const ChunkLayout &layout, const unsigned char *data, const hsize_t offset[3],
+                            std::vector<unsigned char> &output);
+
+    explicit ChunkWriteEngine(int threads);
+    ~ChunkWriteEngine();
+
+    ChunkWriteEngine(const ChunkWriteEngine &) = delete;
+    ChunkWriteEngine &operator=(const ChunkWriteEngine &) = delete;
+
+    // 提交一个已创建数据集的全部分块。数据集的过滤器管线中有进程内不支持的过滤器时返回 false，
+    // 调用者应改用 H5Dwrite。data 指向整个数据集的原生类型数据，keepalive 保证它在写入完成前有效；
+    // dset_id 由调用者持有，必须在 finish() 之后才能关闭
+    bool submit(hid_t dset_id,
+                const std::string &path,
+                const unsigned char *data,
+                std::shared_ptr<const void> keepalive);
+
+    // 写入所有已编码完成的队首分块；调用者可在提交间隙调用，以便编码与写入重叠
+    void commitReady();
+
+    // 等待全部分块编码并写入，全部成功时返回 true
+    bool finish();
+
+    // 编码或写入失败的数据集路径
+    const std::vector<std::string> &failedPaths() const { return failed_paths_; }
+    size_t chunksWritten() const { return chunks_written_; }
+    int threads() const { return static_cast<int>(workers_.size()); }
+
+private:
+    struct Job
+    {
+        hid_t dset_id = -1;
+        std::string path;
+        std::shared_ptr<const ChunkLayout> layout;
+        hsize_t offset[3] = {0, 0, 0};
+        const unsigned char *data = nullptr;
+        std::shared_ptr<const void> keepalive;
+        std::vector<unsigned char> encoded;
+        bool done = false;
+        bool ok = false;
+    };
+
+    void workerLoop();
+    void commitFront();
+    void markFailed(const std::string &path);
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::deque<Job *> work_queue_;
+    std::deque<std::unique_ptr<Job>> pending_; // 按提交顺序等待写入的分块
+    bool stopping_ = false;
+    size_t max_in_flight_;
+
+    std::vector<std::string> failed_paths_;
+    size_t chunks_written_ = 0;
+};
+
+#endif // CHUNK_WRITE_ENGINE_HPP
@@ -0,0 +1,284 @@
+#include "codec_selector.hpp"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace std::chrono;
+
+CodecSelector::CodecSelector(const Options &options) : options_(options)
+{
+    if (options_.candidates.empty())
+    {
+        options_.candidates = Options().candidates;
+    }
+}
+
+bool CodecSelector::prepare(int level, std::string &error)
+{
+    candidates_.clear();
+    for (const auto &spec : options_.candidates)
+    {
+        std::vector<FilterDefinitions::PipelineStage> pipeline_stages;
+        std::string stage_error;
+        if (!FilterDefinitions::parsePipeline(spec, pipeline_stages, stage_error))
+        {
+            std::cerr << "Skipping auto candidate " << spec << ": " << stage_error << std::endl;
+            continue;
+        }
+
+        Candidate candidate;
+        candidate.name = spec;
+        bool usable = true;
+        for (const auto &stage : pipeline_stages)
+        {
+            Stage built = {stage.filter, {}};
+            int stage_level = stage.fixed_level ? stage.level : level;
+            if (!FilterDefinitions::buildCdValues(*stage.filter, stage_level, "", built.cd_values, stage_error))
+            {
+                std::cerr << "Skipping auto candidate " << spec << ": " << stage_error << std::endl;
+                usable = false;
+                break;
+            }
+            // 与固定过滤器相同：不可用或不能编码的过滤器会被可选标志静默跳过，这样的候选没有意义
+            unsigned int filter_config = 0;
+            if (H5Zfilter_avail(stage.filter->filter_id) <= 0 ||
+                H5Zget_filter_info(stage.filter->filter_id, &filter_config) < 0 ||
+                !(filter_config & H5Z_FILTER_CONFIG_ENCODE_ENABLED))
+            {
+                std::cerr << "Skipping auto candidate " << spec << ": " << stage.filter->name
+                          << " encoder not available" << std::endl;
+                usable = false;
+                break;
+            }
+            candidate.stages.push_back(built);
+        }
+        if (usable)
+        {
+            candidates_.push_back(candidate);
+        }
+    }
+    if (candidates_.empty())
+    {
+        error = "no usable auto candidates";
+        return false;
+    }
+    return true;
+}
+
+bool CodecSelector::readSample(hid_t src_dset_id, const int16_t *arena_data, int rank, const hsize_t *dims,
+                               std::vector<int16_t> &sample, hsize_t *sample_dims) const
+{
+    if (rank < 1 || rank > 3 || dims[0] == 0)
+    {
+        return false;
+    }
+    size_t row_elements = 1;
+    for (int d = 1; d < rank; ++d)
+    {
+        row_elements *= dims[d];
+        sample_dims[d] = dims[d];
+    }
+
+    // 开头、中间、结尾三段，数据集不足三段时取整个数据集
+    hsize_t region_rows = std::max<hsize_t>(1, options_.region_bytes / sizeof(int16_t) / std::max<size_t>(row_elements, 1));
+    std::vector<hsize_t> starts;
+    if (dims[0] <= region_rows * 3)
+    {
+        region_rows = dims[0];
+        starts = {0};
+    }
+    else
+    {
+        starts = {0, dims[0] / 2 - region_rows / 2, dims[0] - region_rows};
+    }
+    sample_dims[0] = region_rows * starts.size();
+    sample.resize(static_cast<size_t>(sample_dims[0]) * row_elements);
+
+    if (arena_data != nullptr)
+    {
+        for (size_t i = 0; i < starts.size(); ++i)
+        {
+            std::memcpy(sample.data() + i * region_rows * row_elements, arena_data + starts[i] * row_elements,
+                        region_rows * row_elements * sizeof(int16_t));
+        }
+        return true;
+    }
+
+    // 三段合并为一个选择，一次 H5Dread 读出
+    hid_t file_space_id = H5Dget_space(src_dset_id);
+    hsize_t count[3] = {region_rows, rank > 1 ? dims[1] : 1, rank > 2 ? dims[2] : 1};
+    for (size_t i = 0; i < starts.size(); ++i)
+    {
+        hsize_t start[3] = {starts[i], 0, 0};
+        H5Sselect_hyperslab(file_space_id, i == 0 ? H5S_SELECT_SET : H5S_SELECT_OR, start, NULL, count, NULL);
+    }
+    hid_t mem_space_id = H5Screate_simple(rank, sample_dims, NULL);
+    herr_t status = H5Dread(src_dset_id, H5T_NATIVE_INT16, mem_space_id, file_space_id, H5P_DEFAULT, sample.data());
+    H5Sclose(mem_space_id);
+    H5Sclose(file_space_id);
+    return status >= 0;
+}
+
+bool CodecSelector::meets(const Measurement &measurement) const
+{
+    return (options_.min_encode_mbps <= 0 || measurement.encodeMbps() >= options_.min_encode_mbps) &&
+           (options_.min_decode_mbps <= 0 || measurement.decodeMbps() >= options_.min_decode_mbps);
+}
+
+int CodecSelector::select(hid_t type_id, int rank, const hsize_t *sample_dims, const int16_t *sample,
+                          std::vector<Measurement> &measured, bool &met) const
+{
+    measured.assign(candidates_.size(), Measurement());
+    met = false;
+
+    // 候选在内存文件中测量，不写盘，也不影响目标文件
+    hid_t fapl_id = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_core(fapl_id, 1024 * 1024, false);
+    hid_t file_id = H5Fcreate("codec_selector.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    H5Pclose(fapl_id);
+    if (file_id < 0)
+    {
+        std::cerr << "Failed to create in-memory file for codec selection" << std::endl;
+        return -1;
+    }
+
+    // 关闭分块缓存，每次读取都包含解码
+    hid_t dapl_id = H5Pcreate(H5P_DATASET_ACCESS);
+    H5Pset_chunk_cache(dapl_id, 0, 0, H5D_CHUNK_CACHE_W0_DEFAULT);
+    hid_t space_id = H5Screate_simple(rank, sample_dims, NULL);
+    size_t elements = 1;
+    for (int d = 0; d < rank; ++d)
+    {
+        elements *= sample_dims[d];
+    }
+    std::vector<int16_t> decoded(elements);
+
+    for (size_t c = 0; c < candidates_.size(); ++c)
+    {
+        const Candidate &candidate = candidates_[c];
+        std::string name = "candidate_" + std::to_string(c);
+        hid_t dcpl_id = H5Pcreate(H5P_DATASET_CREATE);
+        H5Pset_chunk(dcpl_id, rank, sample_dims);
+        hid_t dset_id = -1;
+        // 过滤器的 can_apply 可能拒绝该数据类型或配置，此时候选在本数据集上不参与选择
+        H5E_BEGIN_TRY
+        {
+            bool applied = true;
+            for (const auto &stage : candidate.stages)
+            {
+                applied = applied && FilterDefinitions::applyFilter(dcpl_id, *stage.filter, stage.cd_values) >= 0;
+            }
+            if (applied)
+            {
+                dset_id = H5Dcreate(file_id, name.c_str(), type_id, space_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT);
+            }
+        }
+        H5E_END_TRY;
+        H5Pclose(dcpl_id);
+        if (dset_id < 0)
+        {
+            continue;
+        }
+
+        herr_t status;
+        auto encode_start = steady_clock::now();
+        H5E_BEGIN_TRY
+        {
+            status = H5Dwrite(dset_id, H5T_NATIVE_INT16, H5S_ALL, H5S_ALL, H5P_DEFAULT, sample);
+            if (status >= 0)
+            {
+                status = H5Dflush(dset_id);
+            }
+        }
+        H5E_END_TRY;
+        long long encode_ns = duration_cast<nanoseconds>(steady_clock::now() - encode_start).count();
+        hsize_t storage_size = H5Dget_storage_size(dset_id);
+        H5Dclose(dset_id);
+        if (status < 0 || storage_size == 0)
+        {
+            continue;
+        }
+
+        // 解码取多次中最快的一次，并校验一次结果
+        long long decode_ns = 0;
+        dset_id = H5Dopen(file_id, name.c_str(), dapl_id);
+        for (int r = 0; dset_id >= 0 && r < std::max(1, options_.decode_repeats); ++r)
+        {
+            auto decode_start = steady_clock::now();
+            status = H5Dread(dset_id, H5T_NATIVE_INT16, H5S_ALL, H5S_ALL, H5P_DEFAULT, decoded.data());
+            long long ns = duration_cast<nanoseconds>(steady_clock::now() - decode_start).count();
+            if (status < 0)
+            {
+                decode_ns = 0;
+                break;
+            }
+            decode_ns = decode_ns == 0 ? ns : std::min(decode_ns, ns);
+        }
+        if (dset_id >= 0)
+        {
+            H5Dclose(dset_id);
+        }
+        if (decode_ns == 0 || std::memcmp(decoded.data(), sample, elements * sizeof(int16_t)) != 0)
+        {
+            continue;
+        }
+
+        Measurement &m = measured[c];
+        m.samples = 1;
+        m.input_bytes = elements * sizeof(int16_t);
+        m.output_bytes = static_cast<size_t>(storage_size);
+        m.encode_ns = std::max(1LL, encode_ns);
+        m.decode_ns = std::max(1LL, decode_ns);
+    }
+    H5Sclose(space_id);
+    H5Pclose(dapl_id);
+    H5Fclose(file_id);
+
+    // 满足下限的候选中取压缩后最小者（相同时取解码更快者）；没有满足的候选时取解码最快者
+    int best = -1;
+    for (size_t c = 0; c < measured.size(); ++c)
+    {
+        const Measurement &m = measured[c];
+        if (m.samples == 0 || !meets(m))
+        {
+            continue;
+        }
+        if (best < 0 || m.output_bytes < measured[best].output_bytes ||
+            (m.output_bytes == measured[best].output_bytes && m.decode_ns < measured[best].decode_ns))
+        {
+            best = static_cast<int>(c);
+        }
+    }
+    if (best >= 0)
+    {
+        met = true;
+        return best;
+    }
+    for (size_t c = 0; c < measured.size(); ++c)
+    {
+        if (measured[c].samples > 0 && (best < 0 || measured[c].decode_ns < measured[best].decode_ns))
+        {
+            best = static_cast<int>(c);
+        }
+    }
+    return best;
+}
+
+int CodecSelector::bestGlobal(const std::vector<Measurement> &totals, size_t datasets) const
+{
+    int best = -1;
+    for (size_t c = 0; c < totals.size(); ++c)
+    {
+        const Measurement &m = totals[c];
+        if (datasets == 0 || m.samples != datasets || !meets(m))
+        {
+            continue;
+        }
+        if (best < 0 || m.output_bytes < totals[best].output_bytes)
+        {
+            best = static_cast<int>(c);
+        }
+    }
+    return best;
+}
@@ -0,0 +1,86 @@
+#ifndef CODEC_SELECTOR_HPP
+#define CODEC_SELECTOR_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <hdf5.h>
+#include "filter_definitions.hpp"
+
+// --filters auto：对每个 Signal 数据集取开头、中间和结尾的小样本，用一组候选过滤器管线分别压缩，
+// 按代价模型（满足编码/解码吞吐量下限时取压缩比最高者）为每个数据集选择过滤器
+class CodecSelector
+{
+public:
+    // --filters 中表示按数据集自动选择的名称
+    static constexpr const char *kAutoFilter = "auto";
+
+    // 管线中的一级：注册表项与构造好的 cd_values
+    struct Stage
+    {
+        const FilterDefinitions::FilterSpec *filter;
+        std::vector<unsigned int> cd_values;
+    };
+
+    struct Candidate
+    {
+        std::string name; // 管线写法，例如 "SHUFFLE>GZIP:6"
+        std::vector<Stage> stages;
+    };
+
+    struct Options
+    {
+        // 候选管线，未固定级别的级使用 auto 本身的级别
+        std::vector<std::string> candidates = {"SHUFFLE>GZIP:1", "SHUFFLE>GZIP:6", "SZIP", "SHUFFLE>SZIP",
+                                               "VBZ:1", "VBZ_NATIVE:0", "SHUFFLE>ZSTD:3", "BSHUF>LZ4"};
+        double min_encode_mbps = 0.0; // 样本编码吞吐量下限（MB/s），0 表示不限制
+        double min_decode_mbps = 0.0; // 样本解码吞吐量下限（MB/s），0 表示不限制
+        size_t region_bytes = 16 * 1024; // 开头、中间、结尾各取的样本字节数
+        int decode_repeats = 3;          // 样本解码次数，取最快一次
+    };
+
+    // 一个候选在一个样本（或累计在多个样本）上的测量结果
+    struct Measurement
+    {
+        size_t samples = 0; // 成功测量的样本数
+        size_t input_bytes = 0;
+        size_t output_bytes = 0;
+        long long encode_ns = 0;
+        long long decode_ns = 0;
+
+        double ratio() const { return output_bytes > 0 ? static_cast<double>(input_bytes) / output_bytes : 0.0; }
+        double encodeMbps() const { return encode_ns > 0 ? input_bytes / (1024.0 * 1024.0) / (encode_ns / 1e9) : 0.0; }
+        double decodeMbps() const { return decode_ns > 0 ? input_bytes / (1024.0 * 1024.0) / (decode_ns / 1e9) : 0.0; }
+    };
+
+    explicit CodecSelector(const Options &options);
+
+    const Options &options() const { return options_; }
+    const std::vector<Candidate> &candidates() const { return candidates_; }
+
+    // 解析候选并构造 cd_values；不可用或不能编码的候选被跳过。没有可用候选时返回 false
+    bool prepare(int level, std::string &error);
+
+    // 取数据集开头、中间和结尾的样本行（arena_data 非空时取自内存区，否则从 src_dset_id 读取），
+    // sample_dims 为拼接后样本的形状
+    bool readSample(hid_t src_dset_id, const int16_t *arena_data, int rank, const hsize_t *dims,
+                    std::vector<int16_t> &sample, hsize_t *sample_dims) const;
+
+    // 用每个候选在内存文件中压缩样本，measured 按候选顺序返回测量结果。
+    // 返回选中的候选下标，全部失败时返回 -1；met 表示选中的候选是否满足吞吐量下限
+    // （没有候选满足时取解码最快的一个）
+    int select(hid_t type_id, int rank, const hsize_t *sample_dims, const int16_t *sample,
+               std::vector<Measurement> &measured, bool &met) const;
+
+    // 所有数据集统一使用一个候选时的最优选择：每个样本上都成功、累计吞吐量满足下限、
+    // 累计压缩后字节数最少的候选；totals 为各候选在全部样本上的累计测量，没有符合条件的候选时返回 -1
+    int bestGlobal(const std::vector<Measurement> &totals, size_t datasets) const;
+
+private:
+    bool meets(const Measurement &measurement) const;
+
+    Options options_;
+    std::vector<Candidate> candidates_;
+};
+
+#endif // CODEC_SELECTOR_HPP
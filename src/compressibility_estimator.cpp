@@ -0,0 +1,305 @@
+#include "compressibility_estimator.hpp"
+#include "hdf5_processor.hpp"
+#include "dataset_inventory.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <hdf5.h>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ESTIMATOR_X86 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // out[i] = in[i + 1] - in[i]，共 count - 1 个
+    void deltasScalar(const int16_t *in, size_t count, int16_t *out)
+    {
+        for (size_t i = 0; i + 1 < count; ++i)
+        {
+            out[i] = static_cast<int16_t>(in[i + 1] - in[i]);
+        }
+    }
+
+#ifdef ESTIMATOR_X86
+    __attribute__((target("avx2"))) void deltasAvx2(const int16_t *in, size_t count, int16_t *out)
+    {
+        size_t i = 0;
+        for (; i + 17 <= count; i += 16)
+        {
+            __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+            __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i + 1));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_sub_epi16(next, current));
+        }
+        deltasScalar(in + i, count - i, out + i);
+    }
+
+    __attribute__((target("sse2"))) void deltasSse2(const int16_t *in, size_t count, int16_t *out)
+    {
+        size_t i = 0;
+        for (; i + 9 <= count; i += 8)
+        {
+            __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_sub_epi16(next, current));
+        }
+        deltasScalar(in + i, count - i, out + i);
+    }
+#endif
+
+    using DeltaKernel = void (*)(const int16_t *, size_t, int16_t *);
+
+    DeltaKernel deltaKernel()
+    {
+#ifdef ESTIMATOR_X86
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return deltasAvx2;
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            return deltasSse2;
+        }
+#endif
+        return deltasScalar;
+    }
+
+    void histogram16(const int16_t *values, size_t count, std::vector<uint64_t> &bins)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            bins[static_cast<uint16_t>(values[i])]++;
+        }
+    }
+
+    // 字节平面直方图：四组子直方图交替累加，避免相邻元素落在同一个桶时的存储-加载依赖
+    void histogramPlanes(const int16_t *values, size_t count, std::vector<uint64_t> &low, std::vector<uint64_t> &high)
+    {
+        uint32_t low_bins[4][256] = {{0}};
+        uint32_t high_bins[4][256] = {{0}};
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                uint16_t value = static_cast<uint16_t>(values[i + lane]);
+                low_bins[lane][value & 0xFF]++;
+                high_bins[lane][value >> 8]++;
+            }
+        }
+        for (; i < count; ++i)
+        {
+            uint16_t value = static_cast<uint16_t>(values[i]);
+            low_bins[0][value & 0xFF]++;
+            high_bins[0][value >> 8]++;
+        }
+        for (size_t b = 0; b < 256; ++b)
+        {
+            low[b] += low_bins[0][b] + low_bins[1][b] + low_bins[2][b] + low_bins[3][b];
+            high[b] += high_bins[0][b] + high_bins[1][b] + high_bins[2][b] + high_bins[3][b];
+        }
+    }
+
+    // 字节平面内相邻字节对的联合直方图
+    void histogramPlanePairs(const int16_t *values, size_t count, std::vector<uint64_t> &low, std::vector<uint64_t> &high)
+    {
+        for (size_t i = 1; i < count; ++i)
+        {
+            uint16_t previous = static_cast<uint16_t>(values[i - 1]);
+            uint16_t value = static_cast<uint16_t>(values[i]);
+            low[((previous & 0xFF) << 8) | (value & 0xFF)]++;
+            high[(previous & 0xFF00) | (value >> 8)]++;
+        }
+    }
+
+    // 零阶熵（比特/符号）
+    double entropyBits(const std::vector<uint64_t> &bins)
+    {
+        uint64_t total = 0;
+        double sum = 0.0;
+        for (uint64_t count : bins)
+        {
+            if (count > 0)
+            {
+                total += count;
+                sum += count * std::log2(static_cast<double>(count));
+            }
+        }
+        return total > 0 ? std::log2(static_cast<double>(total)) - sum / total : 0.0;
+    }
+
+    // 条件熵 H(当前 | 前一) = H(前一, 当前) - H(前一)
+    double conditionalBits(const std::vector<uint64_t> &pairs)
+    {
+        std::vector<uint64_t> previous(256);
+        for (size_t i = 0; i < pairs.size(); ++i)
+        {
+            previous[i >> 8] += pairs[i];
+        }
+        return std::max(0.0, entropyBits(pairs) - entropyBits(previous));
+    }
+} // namespace
+
+CompressibilityEstimator::CompressibilityEstimator(const Options &options)
+    : options_(options), raw_(65536), delta1_(65536), delta2_(65536), low_(256), high_(256),
+      low_pairs_(65536), high_pairs_(65536)
+{
+}
+
+const char *CompressibilityEstimator::kernelName()
+{
+#ifdef ESTIMATOR_X86
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return "avx2";
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return "sse2";
+    }
+#endif
+    return "scalar";
+}
+
+void CompressibilityEstimator::addRead(const int16_t *data, size_t count)
+{
+    size_t n = std::min(count, options_.read_elements);
+    if (n == 0)
+    {
+        return;
+    }
+    static const DeltaKernel deltas = deltaKernel();
+    std::vector<int16_t> delta1(n);
+    std::vector<int16_t> delta2(n);
+    deltas(data, n, delta1.data());
+    deltas(delta1.data(), n - 1, delta2.data());
+
+    histogram16(data, n, raw_);
+    histogram16(delta1.data(), n - 1, delta1_);
+    if (n > 2)
+    {
+        histogram16(delta2.data(), n - 2, delta2_);
+    }
+    histogramPlanes(data, n, low_, high_);
+    histogramPlanePairs(data, n, low_pairs_, high_pairs_);
+    reads_++;
+    elements_ += n;
+}
+
+bool CompressibilityEstimator::addFile(const std::string &input_file, const DatasetInventory *inventory)
+{
+    hid_t file_id = H5Fopen(input_file.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file_id < 0)
+    {
+        std::cerr << "Failed to open input file for compressibility estimate: " << input_file << std::endl;
+        return false;
+    }
+    DatasetInventory scanned;
+    if (inventory == nullptr || inventory->sourceFile() != input_file)
+    {
+        scanned.scan(file_id);
+        inventory = &scanned;
+    }
+    const std::vector<size_t> &signals = inventory->signalDatasets();
+
+    // 在全部 Signal 数据集中均匀选取，每个只读开头的若干行
+    size_t wanted = std::min(signals.size(), static_cast<size_t>(std::max(1, options_.reads)));
+    std::vector<int16_t> buffer;
+    for (size_t k = 0; k < wanted; ++k)
+    {
+        const std::string &path = inventory->objects()[signals[k * signals.size() / wanted]].path;
+        hid_t dset_id = H5Dopen(file_id, path.c_str(), H5P_DEFAULT);
+        if (dset_id < 0)
+        {
+            continue;
+        }
+        hid_t space_id = H5Dget_space(dset_id);
+        int rank = H5Sget_simple_extent_ndims(space_id);
+        hsize_t dims[3] = {0, 1, 1};
+        if (rank >= 1 && rank <= 3)
+        {
+            H5Sget_simple_extent_dims(space_id, dims, NULL);
+            size_t row_elements = static_cast<size_t>((rank > 1 ? dims[1] : 1) * (rank > 2 ? dims[2] : 1));
+            hsize_t count[3] = {std::min<hsize_t>(dims[0], std::max<size_t>(1, options_.read_elements / std::max<size_t>(row_elements, 1))),
+                                dims[1], dims[2]};
+            hsize_t start[3] = {0, 0, 0};
+            buffer.resize(static_cast<size_t>(count[0]) * row_elements);
+            H5Sselect_hyperslab(space_id, H5S_SELECT_SET, start, NULL, count, NULL);
+            hid_t mem_space_id = H5Screate_simple(rank, count, NULL);
+            if (!buffer.empty() &&
+                H5Dread(dset_id, H5T_NATIVE_INT16, mem_space_id, space_id, H5P_DEFAULT, buffer.data()) >= 0)
+            {
+                addRead(buffer.data(), buffer.size());
+            }
+            H5Sclose(mem_space_id);
+        }
+        H5Sclose(space_id);
+        H5Dclose(dset_id);
+    }
+    H5Fclose(file_id);
+    return reads_ > 0;
+}
+
+CompressibilityEstimator::Entropy CompressibilityEstimator::entropy() const
+{
+    Entropy result;
+    if (elements_ == 0)
+    {
+        return result;
+    }
+    result.raw = entropyBits(raw_);
+    result.delta1 = entropyBits(delta1_);
+    result.delta2 = entropyBits(delta2_);
+    result.planes = entropyBits(low_) + entropyBits(high_);
+    result.planes_context = conditionalBits(low_pairs_) + conditionalBits(high_pairs_);
+    std::vector<uint64_t> bytes(256);
+    for (size_t b = 0; b < 256; ++b)
+    {
+        bytes[b] = low_[b] + high_[b];
+    }
+    result.bytes = 2 * entropyBits(bytes);
+    result.reads = reads_;
+    result.elements = elements_;
+    return result;
+}
+
+double CompressibilityEstimator::estimateRatio(const std::vector<FilterDefinitions::PipelineStage> &stages,
+                                               bool &exact) const
+{
+    Entropy e = entropy();
+    double bits = 16.0;
+    bool has_coder = false;
+    for (const auto &stage : stages)
+    {
+        switch (stage.filter->filter_id)
+        {
+        case H5Z_FILTER_SHUFFLE:
+        case H5Z_FILTER_FLETCHER32:
+            // 只重排或附加校验和，本身不减少字节数
+            break;
+        case H5Z_FILTER_VBZ:
+        case H5Z_FILTER_VBZ_NATIVE:
+            // delta + zigzag 之后再编码
+            has_coder = true;
+            bits = std::min({bits, e.delta1, e.delta2});
+            break;
+        case H5Z_FILTER_SZIP:
+            // Rice 编码，NN 预处理即一阶差分
+            has_coder = true;
+            bits = std::min({bits, e.raw, e.delta1});
+            break;
+        default:
+            // 通用字节流编码器（含自带 shuffle 的 BLOSC/BSHUF）：LZ 匹配能利用相邻字节的相关性，
+            // 取原始值、字节平面（零阶和一阶）或字节流中最好的一种
+            has_coder = true;
+            bits = std::min({bits, e.raw, e.planes, e.planes_context, e.bytes});
+            break;
+        }
+    }
+    exact = !has_coder;
+    if (!has_coder)
+    {
+        return 1.0;
+    }
+    return 16.0 / std::max(bits, 0.05);
+}
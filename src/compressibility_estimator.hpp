@@ -0,0 +1,67 @@
+#ifndef COMPRESSIBILITY_ESTIMATOR_HPP
+#define COMPRESSIBILITY_ESTIMATOR_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "filter_definitions.hpp"
+
+class DatasetInventory;
+
+// 可压缩性估计：在部分 Signal 数据上统计原始值、一阶/二阶差分和高低字节平面的熵，
+// 由此给出每条过滤器管线可达压缩比的估计，用于在扫描前剪除不可能进入 Pareto 前沿的配置
+class CompressibilityEstimator
+{
+public:
+    struct Options
+    {
+        int reads = 16;                // 参与统计的 Signal 数据集数（在全部数据集中均匀选取）
+        size_t read_elements = 65536;  // 每个数据集最多统计的元素数（从开头取）
+        double margin = 1.10;          // 熵估计的放大系数：估计 × margin 仍达不到前沿时才剪除
+    };
+
+    // 各种表示的熵（除 planes_context 外均为零阶），单位为每个 int16 元素的比特数
+    struct Entropy
+    {
+        double raw = 16.0;    // 原始值（65536 个桶）
+        double delta1 = 16.0; // 一阶差分
+        double delta2 = 16.0; // 二阶差分
+        double planes = 16.0; // 低字节平面 + 高字节平面（SHUFFLE 之后的字节流）
+        double planes_context = 16.0; // 字节平面的一阶条件熵（以平面内前一字节为上下文），近似 LZ/Huffman 类编码器
+        double bytes = 16.0;  // 不分平面的字节流（2 × 每字节熵）
+        size_t reads = 0;
+        size_t elements = 0;
+    };
+
+    explicit CompressibilityEstimator(const Options &options);
+
+    const Options &options() const { return options_; }
+
+    // 累加一个数据集的统计（最多 read_elements 个元素）
+    void addRead(const int16_t *data, size_t count);
+    // 从源文件中均匀选取若干 Signal 数据集读取并累加统计（没有源数据内存区时使用），
+    // inventory 为该文件的对象清单，为空时遍历文件
+    bool addFile(const std::string &input_file, const DatasetInventory *inventory = nullptr);
+
+    Entropy entropy() const;
+
+    // 管线的压缩比估计：熵编码级取其能利用的表示中熵最低者（16 / 比特数），
+    // 只含 SHUFFLE、FLETCHER32 等变换的管线为 1.0（exact 为 true，不受 margin 影响）
+    double estimateRatio(const std::vector<FilterDefinitions::PipelineStage> &stages, bool &exact) const;
+
+    static const char *kernelName();
+
+private:
+    Options options_;
+    std::vector<uint64_t> raw_;
+    std::vector<uint64_t> delta1_;
+    std::vector<uint64_t> delta2_;
+    std::vector<uint64_t> low_;
+    std::vector<uint64_t> high_;
+    std::vector<uint64_t> low_pairs_;  // (前一字节, 当前字节) 联合直方图
+    std::vector<uint64_t> high_pairs_;
+    size_t reads_ = 0;
+    size_t elements_ = 0;
+};
+
+#endif // COMPRESSIBILITY_ESTIMATOR_HPP
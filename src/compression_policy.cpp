@@ -0,0 +1,361 @@
+#include "compression_policy.hpp"
+#include "hdf5_processor.hpp"
+#include "chunk_tuner.hpp"
+#include "utils.hpp"
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    // 片段与 path 中 pos 处的字符逐个比较，? 匹配任意一个字符
+    bool partAt(const std::string &path, size_t pos, const std::string &part)
+    {
+        if (pos + part.size() > path.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < part.size(); ++i)
+        {
+            if (part[i] != '?' && part[i] != path[pos + i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 在 [from, limit) 中找片段最左边的出现位置
+    size_t findPart(const std::string &path, size_t from, size_t limit, const std::string &part)
+    {
+        for (size_t pos = from; pos + part.size() <= limit; ++pos)
+        {
+            if (partAt(path, pos, part))
+            {
+                return pos;
+            }
+        }
+        return std::string::npos;
+    }
+} // namespace
+
+CompressionPolicy::Glob CompressionPolicy::Glob::compile(const std::string &pattern)
+{
+    Glob glob;
+    glob.anchored_start = pattern.empty() || pattern.front() != '*';
+    glob.anchored_end = pattern.empty() || pattern.back() != '*';
+    // 连续的 * 等同于一个，空片段不参与匹配
+    for (const auto &part : Utils::split(pattern, '*'))
+    {
+        if (!part.empty())
+        {
+            glob.parts.push_back(part);
+        }
+    }
+    if (glob.parts.empty() && glob.anchored_start)
+    {
+        glob.parts.push_back(std::string());
+    }
+    return glob;
+}
+
+bool CompressionPolicy::Glob::match(const std::string &path) const
+{
+    if (parts.empty())
+    {
+        return true; // 只有 *
+    }
+    if (anchored_start && anchored_end && parts.size() == 1)
+    {
+        return path.size() == parts[0].size() && partAt(path, 0, parts[0]);
+    }
+
+    size_t pos = 0;
+    size_t first = 0;
+    size_t last = parts.size();
+    size_t limit = path.size();
+    if (anchored_start)
+    {
+        if (!partAt(path, 0, parts[0]))
+        {
+            return false;
+        }
+        pos = parts[0].size();
+        first = 1;
+    }
+    if (anchored_end)
+    {
+        const std::string &tail = parts.back();
+        if (tail.size() > path.size() || path.size() - tail.size() < pos ||
+            !partAt(path, path.size() - tail.size(), tail))
+        {
+            return false;
+        }
+        limit = path.size() - tail.size();
+        last = parts.size() - 1;
+    }
+    // 中间的片段依次取最左边的出现位置
+    for (size_t i = first; i < last; ++i)
+    {
+        size_t found = findPart(path, pos, limit, parts[i]);
+        if (found == std::string::npos)
+        {
+            return false;
+        }
+        pos = found + parts[i].size();
+    }
+    return true;
+}
+
+std::string CompressionPolicy::Rule::label() const
+{
+    std::string text = pattern + " -> ";
+    switch (action)
+    {
+    case Action::Test:
+        return text + "test";
+    case Action::Copy:
+        return text + "copy";
+    case Action::Recompress:
+        text += pipeline;
+        if (chunk_elements != 0)
+        {
+            text += " chunk=" + ChunkTuner::formatChunkSize(chunk_elements);
+        }
+        return text;
+    }
+    return text;
+}
+
+CompressionPolicy::CompressionPolicy()
+{
+    std::string error;
+    addRule("*/Raw/Signal -> test", error);
+    addRule("* -> copy", error);
+}
+
+bool CompressionPolicy::load(const std::string &policy_file, std::string &error)
+{
+    std::ifstream file(policy_file);
+    if (!file.is_open())
+    {
+        error = "cannot open policy file " + policy_file;
+        return false;
+    }
+    return parse(file, policy_file, error);
+}
+
+bool CompressionPolicy::parse(std::istream &in, const std::string &source, std::string &error)
+{
+    rules_.clear();
+    globs_.clear();
+    source_ = source;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line))
+    {
+        ++line_number;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+        {
+            line.erase(comment);
+        }
+        if (Utils::trim(line).empty())
+        {
+            continue;
+        }
+        std::string rule_error;
+        if (!addRule(line, rule_error))
+        {
+            error = source + ":" + std::to_string(line_number) + ": " + rule_error;
+            return false;
+        }
+    }
+    if (rules_.empty())
+    {
+        error = source + ": no rules";
+        return false;
+    }
+    return true;
+}
+
+bool CompressionPolicy::addRule(const std::string &line, std::string &error)
+{
+    // 分隔符为 "->"，也接受 "→"
+    size_t separator = line.find("->");
+    size_t separator_size = 2;
+    if (separator == std::string::npos)
+    {
+        separator = line.find("\xe2\x86\x92");
+        separator_size = 3;
+    }
+    if (separator == std::string::npos)
+    {
+        error = "expected 'PATTERN -> ACTION', got '" + Utils::trim(line) + "'";
+        return false;
+    }
+
+    Rule rule;
+    rule.pattern = Utils::trim(line.substr(0, separator));
+    // 清单中的路径相对根组，模式开头的 / 可写可不写
+    while (!rule.pattern.empty() && rule.pattern.front() == '/')
+    {
+        rule.pattern.erase(0, 1);
+    }
+    if (rule.pattern.empty())
+    {
+        error = "empty pattern";
+        return false;
+    }
+
+    std::istringstream tokens(line.substr(separator + separator_size));
+    std::string action;
+    if (!(tokens >> action))
+    {
+        error = "missing action for pattern '" + rule.pattern + "'";
+        return false;
+    }
+    std::string action_name = Utils::toLower(action);
+    if (action_name == "test")
+    {
+        rule.action = Action::Test;
+    }
+    else if (action_name == "copy")
+    {
+        rule.action = Action::Copy;
+    }
+    else
+    {
+        // 过滤器管线：固定的级别是编解码器自身的级别（ZSTD:19 即 zstd 的 19 级），
+        // 未固定级别的级取该过滤器扫描级别中的最低级别
+        std::vector<FilterDefinitions::PipelineStage> stages;
+        if (!FilterDefinitions::parsePipeline(action, stages, error))
+        {
+            return false;
+        }
+        for (const auto &stage : stages)
+        {
+            CodecSelector::Stage built = {stage.filter, {}};
+            bool ok = stage.fixed_level
+                          ? FilterDefinitions::buildNativeCdValues(*stage.filter, stage.level, "", built.cd_values, error)
+                          : FilterDefinitions::buildCdValues(*stage.filter, stage.filter->min_level, "", built.cd_values,
+                                                             error);
+            if (!ok)
+            {
+                return false;
+            }
+            rule.stages.push_back(built);
+        }
+        rule.action = Action::Recompress;
+        rule.pipeline = action;
+    }
+
+    std::string option;
+    while (tokens >> option)
+    {
+        if (option.compare(0, 6, "chunk=") == 0 && rule.action == Action::Recompress)
+        {
+            std::string value = option.substr(6);
+            if (!ChunkTuner::parseChunkSize(value, rule.chunk_elements) || rule.chunk_elements == ChunkTuner::kAuto)
+            {
+                error = "invalid chunk size '" + value + "' (expected elements such as 64K, or full)";
+                return false;
+            }
+        }
+        else
+        {
+            error = "unexpected '" + option + "' after action " + action;
+            return false;
+        }
+    }
+
+    rules_.push_back(rule);
+    globs_.push_back(Glob::compile(rule.pattern));
+    return true;
+}
+
+int CompressionPolicy::match(const std::string &path) const
+{
+    for (size_t i = 0; i < globs_.size(); ++i)
+    {
+        if (globs_[i].match(path))
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int CompressionPolicy::classOf(const DatasetInventory::Object &object) const
+{
+    if (object.type != H5O_TYPE_DATASET)
+    {
+        return -1;
+    }
+    if (HDF5Processor::isSignalPath(object.path))
+    {
+        return kSignalClass;
+    }
+    int rule = match(object.path);
+    return rule < 0 ? static_cast<int>(rules_.size()) + 1 : rule + 1;
+}
+
+const CompressionPolicy::Rule *CompressionPolicy::ruleOf(int class_index) const
+{
+    if (class_index <= kSignalClass || class_index > static_cast<int>(rules_.size()))
+    {
+        return nullptr;
+    }
+    return &rules_[class_index - 1];
+}
+
+bool CompressionPolicy::recompresses(const DatasetInventory::Object &object) const
+{
+    const Rule *rule = ruleOf(classOf(object));
+    return rule != nullptr && rule->action == Action::Recompress;
+}
+
+std::vector<StorageClass> CompressionPolicy::classes() const
+{
+    std::vector<StorageClass> result(rules_.size() + 2);
+    result[kSignalClass].name = "Signal (configuration under test)";
+    for (size_t i = 0; i < rules_.size(); ++i)
+    {
+        result[i + 1].name = rules_[i].label();
+    }
+    result.back().name = "(no rule) -> copy";
+    return result;
+}
+
+std::vector<StorageClass> CompressionPolicy::sourceUsage(const DatasetInventory &inventory) const
+{
+    std::vector<StorageClass> usage = classes();
+    for (const auto &object : inventory.objects())
+    {
+        int class_index = classOf(object);
+        if (class_index < 0)
+        {
+            continue;
+        }
+        StorageClass &entry = usage[class_index];
+        entry.datasets++;
+        entry.raw_bytes += rawBytes(object);
+        entry.stored_bytes += object.storage_size;
+    }
+    return usage;
+}
+
+size_t CompressionPolicy::rawBytes(const DatasetInventory::Object &object)
+{
+    if (object.type_image.empty())
+    {
+        return 0;
+    }
+    hid_t type_id = H5Tdecode(object.type_image.data());
+    if (type_id < 0)
+    {
+        return 0;
+    }
+    size_t bytes = H5Tget_size(type_id) * object.elements();
+    H5Tclose(type_id);
+    return bytes;
+}
@@ -0,0 +1,91 @@
+#ifndef COMPRESSION_POLICY_HPP
+#define COMPRESSION_POLICY_HPP
+
+#include <string>
+#include <vector>
+#include <istream>
+#include "codec_selector.hpp"
+#include "dataset_inventory.hpp"
+
+// 一类数据集在文件中的存储开销
+struct StorageClass
+{
+    std::string name;
+    size_t datasets = 0;
+    size_t raw_bytes = 0;    // 元素个数 × 类型大小（变长类型只计句柄，不含堆中的数据）
+    size_t stored_bytes = 0; // H5Dget_storage_size
+};
+
+// 压缩策略：按路径模式为 Signal 以外的数据集选择存储方式（复制原样，或以给定管线与分块重新写出）。
+// 规则按文件中的顺序匹配，第一条匹配的规则生效；模式在加载时编译一次，* 匹配任意字符（包括 /），? 匹配一个字符。
+// Signal 数据集始终使用被测配置，自成一类
+class CompressionPolicy
+{
+public:
+    enum class Action
+    {
+        Test,      // 被测配置（只用于 Signal 数据集，其他数据集按 Copy 处理）
+        Copy,      // H5Ocopy 原样复制，保留源文件中的布局与过滤器
+        Recompress // 以 stages 与 chunk_elements 重新创建并写出
+    };
+
+    struct Rule
+    {
+        std::string pattern;
+        Action action = Action::Copy;
+        std::string pipeline;                   // Recompress 的管线写法，例如 "SHUFFLE>ZSTD:19"（级别为编解码器自身的级别）
+        std::vector<CodecSelector::Stage> stages;
+        size_t chunk_elements = 0;              // 0 为整个数据集一个分块（受 4 GiB 上限约束）
+
+        std::string label() const; // 例如 "*/Fastq -> ZSTD:19"
+    };
+
+    // 类别：kSignalClass 为 Signal 数据集，规则 i 为类别 i + 1，最后一个类别是没有规则匹配（按复制处理）的数据集
+    static constexpr int kSignalClass = 0;
+
+    // 默认策略与不使用策略文件时的行为一致：*/Raw/Signal -> test，* -> copy
+    CompressionPolicy();
+
+    // 读取策略文件，每行 "模式 -> 动作 [chunk=大小]"，动作为 test、copy 或过滤器管线；# 之后为注释
+    bool load(const std::string &policy_file, std::string &error);
+    bool parse(std::istream &in, const std::string &source, std::string &error);
+
+    const std::vector<Rule> &rules() const { return rules_; }
+    const std::string &source() const { return source_; } // 策略文件路径，默认策略为空
+
+    // 第一条匹配 path 的规则下标，没有规则匹配时返回 -1
+    int match(const std::string &path) const;
+    // 数据集所属的类别，非数据集返回 -1
+    int classOf(const DatasetInventory::Object &object) const;
+    // 类别对应的规则，Signal 类别与未匹配类别返回 nullptr
+    const Rule *ruleOf(int class_index) const;
+    // 该数据集是否按策略重新写出（Signal 数据集与 Test/Copy 规则都不是）
+    bool recompresses(const DatasetInventory::Object &object) const;
+
+    // 全部类别，计数为 0
+    std::vector<StorageClass> classes() const;
+    // 源文件中各类数据集的存储开销（取自对象清单）
+    std::vector<StorageClass> sourceUsage(const DatasetInventory &inventory) const;
+    // 数据集的 元素个数 × 类型大小
+    static size_t rawBytes(const DatasetInventory::Object &object);
+
+private:
+    // 编译后的模式：按 * 切开的字面片段，首尾片段分别锚定在路径开头与结尾（模式不以 * 开头/结尾时）
+    struct Glob
+    {
+        std::vector<std::string> parts;
+        bool anchored_start = true;
+        bool anchored_end = true;
+
+        static Glob compile(const std::string &pattern);
+        bool match(const std::string &path) const;
+    };
+
+    bool addRule(const std::string &line, std::string &error);
+
+    std::vector<Rule> rules_;
+    std::vector<Glob> globs_; // 与 rules_ 一一对应
+    std::string source_;
+};
+
+#endif // COMPRESSION_POLICY_HPP
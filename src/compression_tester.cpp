@@ -1,10 +1,15 @@
 #include "compression_tester.hpp"
+#include "statistics.hpp"
+#include "parallel_executor.hpp"
+#include "filter_definitions.hpp"
 #include "utils.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cmath>
+#include <iterator>
 
 CompressionTester::CompressionTester() : processor_()
 {
@@ -13,6 +18,8 @@ CompressionTester::CompressionTester() : processor_()
 std::vector<CompressionResult> CompressionTester::runTestSuite(const TestConfig &config)
 {
     std::vector<CompressionResult> all_results;
+    requirements_ = config.requirements;
+    throttle_ = config.throttle;
 
     std::cout << "Starting compression test suite..." << std::endl;
     std::cout << "Input file: " << config.input_file << std::endl;
@@ -25,6 +32,126 @@ std::vector<CompressionResult> CompressionTester::runTestSuite(const TestConfig
         return all_results;
     }
 
+    ProcessorOptions options = processor_.getOptions();
+    options.in_memory = config.in_memory;
+    options.dump_image = config.dump_image;
+    options.encode_threads = config.encode_threads;
+    options.decode_threads = config.decode_threads;
+    options.mmap_source = config.mmap_source;
+    options.metadata_skeleton = config.metadata_skeleton;
+    options.policy = config.policy;
+    options.decode_scaling = config.decode_scaling;
+    options.pipeline = config.pipeline;
+    options.pipeline_read_queue_depth = config.read_queue_depth;
+    options.pipeline_write_queue_depth = config.write_queue_depth;
+    options.pipeline_inflight_bytes = config.inflight_mb * 1024 * 1024;
+    options.chunk_tuning.weights = config.tune_weights;
+    options.chunk_tuning.slice_reads = config.slice_reads;
+    options.chunk_tuning.slice_elements = config.slice_elements;
+    if (!config.auto_candidates.empty())
+    {
+        options.codec_selection.candidates = config.auto_candidates;
+    }
+    options.codec_selection.min_encode_mbps = config.auto_min_encode_mbps;
+    options.codec_selection.min_decode_mbps = config.auto_min_decode_mbps;
+    options.codec_selection.region_bytes = config.auto_sample_kb * 1024;
+    options.perf_counters = config.perf_counters;
+    options.io_trace = config.io_trace || config.throttle.enabled();
+    options.throttle = config.throttle;
+    processor_.setOptions(options);
+    if (options.io_trace)
+    {
+        std::cout << "I/O trace: HDF5 files opened through the counting VFD (sec2 underneath)"
+                  << (config.in_memory ? "; in-memory outputs use the core VFD and are not traced" : "") << std::endl;
+    }
+    if (config.throttle.enabled())
+    {
+        std::cout << "Throttling destination I/O to " << config.throttle.name << " (read "
+                  << config.throttle.read_mbps << " MB/s, write " << config.throttle.write_mbps << " MB/s, "
+                  << config.throttle.latency_us << " us per non-sequential access)"
+                  << (config.in_memory ? "; ignored for in-memory outputs" : "") << std::endl;
+    }
+    if (config.perf_counters)
+    {
+        // 先探测一次，报告计数器来源与退化原因
+        PerfCounters probe;
+        probe.start();
+        probe.stop(0);
+        std::cout << "Performance counters: " << probe.source()
+                  << (probe.note().empty() ? "" : " - " + probe.note()) << std::endl;
+    }
+    if (config.pipeline)
+    {
+        std::cout << "Signal datasets written through a read -> encode (" << std::max(1, config.encode_threads)
+                  << " threads) -> write pipeline, queue depths " << config.read_queue_depth << "/"
+                  << config.write_queue_depth << ", in-flight limit " << config.inflight_mb << " MB" << std::endl;
+    }
+    else if (config.encode_threads > 0)
+    {
+        std::cout << "Signal chunks encoded in-process by " << config.encode_threads
+                  << " threads and written with H5Dwrite_chunk" << std::endl;
+    }
+    if (config.in_memory)
+    {
+        std::cout << "Destination files are created in memory (core VFD"
+                  << (config.dump_image ? ", images dumped to disk" : ", nothing written to disk") << ")" << std::endl;
+    }
+
+    // 对象清单：遍历一次（或读取旁路文件），数据加载与之后的每个配置都不再遍历源文件
+    processor_.setInventory(nullptr);
+    if (inventory_.load(config.input_file, config.inventory_cache))
+    {
+        processor_.setInventory(&inventory_);
+    }
+    // 压缩策略：按清单给出每类数据集的数量；被非 test 规则匹配的 Signal 数据集仍使用被测配置
+    std::vector<StorageClass> source_classes;
+    if (!inventory_.empty())
+    {
+        source_classes = config.policy.sourceUsage(inventory_);
+        std::cout << "Compression policy: " << config.policy.rules().size() << " rules"
+                  << (config.policy.source().empty() ? " (default)" : " from " + config.policy.source()) << std::endl;
+        for (const auto &entry : source_classes)
+        {
+            if (entry.datasets > 0)
+            {
+                std::cout << "  " << entry.name << ": " << entry.datasets << " datasets, "
+                          << Utils::formatSize(entry.stored_bytes) << " in the input file" << std::endl;
+            }
+        }
+        size_t overridden = 0;
+        for (size_t index : inventory_.signalDatasets())
+        {
+            int rule = config.policy.match(inventory_.objects()[index].path);
+            if (rule >= 0 && config.policy.rules()[rule].action != CompressionPolicy::Action::Test)
+            {
+                overridden++;
+            }
+        }
+        if (overridden > 0)
+        {
+            std::cerr << "Warning: " << overridden << " Signal datasets match a policy rule other than 'test'; "
+                      << "they are written with the configuration under test" << std::endl;
+        }
+    }
+
+    // Signal 以外的元数据复制一次做成骨架（--jobs 的工作进程 fork 后直接使用）
+    processor_.prepareMetadata(config.input_file);
+
+    // 一次性解码全部源Signal数据，之后的每个配置只测量目标编码
+    processor_.setSourceArena(nullptr);
+    arena_.clear();
+    if (config.use_arena)
+    {
+        if (arena_.load(config.input_file, config.decode_threads, config.mmap_source, &inventory_))
+        {
+            processor_.setSourceArena(&arena_);
+        }
+        else
+        {
+            std::cerr << "Warning: Signal ingest failed, every configuration will read the source file" << std::endl;
+        }
+    }
+
     // 获取原始文件大小
     size_t original_size = Utils::getFileSize(config.input_file);
     std::cout << "Original file size: " << Utils::formatSize(original_size) << std::endl;
@@ -39,38 +166,288 @@ std::vector<CompressionResult> CompressionTester::runTestSuite(const TestConfig
     baseline.decompression_time_ms = 0;
     baseline.compressed_size_bytes = original_size;
     baseline.original_size_bytes = original_size;
+    baseline.input_file_bytes = original_size;
+    baseline.output_file_bytes = original_size;
+    baseline.file_ratio = 1.0;
+    baseline.storage_classes = source_classes;
     all_results.push_back(baseline);
 
-    // 测试每个过滤器
-    for (const auto &filter_name : config.filters_to_test)
-    {
-        std::cout << "\nTesting filter: " << filter_name << std::endl;
-        std::cout << "Description: " << HDF5Processor::getFilterDescription(filter_name) << std::endl;
+    // 熵估计：用于报告中的估计压缩比与扫描剪枝
+    estimateCompressibility(config);
+
+    // 由注册表展开 过滤器 × 参数网格 × 分块大小 × 级别
+    std::vector<SweepPoint> sweep = buildSweep(config);
 
-        // 获取该过滤器的测试级别
-        auto filter_levels = getFilterLevels();
-        std::vector<int> levels;
+    if (config.jobs > 1)
+    {
+        auto parallel_results = runParallel(config, sweep, all_results);
+        all_results.insert(all_results.end(), parallel_results.begin(), parallel_results.end());
+        std::cout << "\nTest suite completed. Total results: " << all_results.size() << std::endl;
+        return all_results;
+    }
 
-        if (config.test_all_levels && filter_levels.find(filter_name) != filter_levels.end())
+    // 测试每个过滤器配置
+    for (const auto &point : sweep)
+    {
+        std::cout << "\nTesting filter: " << point.filter_name;
+        if (!point.parameters.empty())
         {
-            levels = filter_levels[filter_name];
+            std::cout << " [" << point.parameters << "]";
         }
-        else
+        if (point.chunk_elements != 0)
         {
-            // 使用默认级别
-            levels = {1, 6, 9};
+            std::cout << ", chunk " << ChunkTuner::formatChunkSize(point.chunk_elements);
         }
+        std::cout << std::endl;
+        std::cout << "Description: " << HDF5Processor::getFilterDescription(point.filter_name) << std::endl;
 
         // 测试每个压缩级别
-        auto level_results = testFilterWithLevels(config.input_file, filter_name, levels);
+        auto level_results = testFilterWithLevels(config.input_file, point.filter_name, point.parameters,
+                                                  point.chunk_elements, point.levels, all_results,
+                                                  config.repeat, config.warmup);
         all_results.insert(all_results.end(), level_results.begin(), level_results.end());
     }
 
     std::cout << "\nTest suite completed. Total results: " << all_results.size() << std::endl;
+    if (!pruned_.empty())
+    {
+        std::cout << "Pruned configurations: " << pruned_.size() << std::endl;
+    }
 
     return all_results;
 }
 
+void CompressionTester::estimateCompressibility(const TestConfig &config)
+{
+    prune_ = config.prune;
+    prune_margin_ = std::max(1.0, config.estimate.margin);
+    pruned_.clear();
+    estimator_.reset(new CompressibilityEstimator(config.estimate));
+
+    // 有源数据内存区时直接取自内存区，否则从源文件读取
+    const auto &entries = arena_.entries();
+    if (!entries.empty())
+    {
+        size_t wanted = std::min(entries.size(), static_cast<size_t>(std::max(1, config.estimate.reads)));
+        for (size_t k = 0; k < wanted; ++k)
+        {
+            const SignalArena::Entry &entry = entries[k * entries.size() / wanted];
+            estimator_->addRead(arena_.data(entry), entry.length);
+        }
+    }
+    else
+    {
+        estimator_->addFile(config.input_file, &inventory_);
+    }
+
+    CompressibilityEstimator::Entropy e = estimator_->entropy();
+    if (e.elements == 0)
+    {
+        std::cerr << "Warning: No signal samples for the compressibility estimate, pruning only removes duplicates"
+                  << std::endl;
+        estimator_.reset();
+        return;
+    }
+    std::cout << "Compressibility estimate over " << e.reads << " reads (" << e.elements << " samples, "
+              << CompressibilityEstimator::kernelName() << " deltas): entropy bits/sample raw "
+              << Utils::formatRatio(e.raw) << ", delta1 " << Utils::formatRatio(e.delta1) << ", delta2 "
+              << Utils::formatRatio(e.delta2) << ", byte planes " << Utils::formatRatio(e.planes) << " (order-1 "
+              << Utils::formatRatio(e.planes_context) << "), bytes "
+              << Utils::formatRatio(e.bytes) << std::endl;
+}
+
+// 管线中每一级实际生效的过滤器设置，以及分块大小；相同的键会产生相同的输出文件
+static bool configKey(const std::string &filter_name, const std::string &parameters, size_t chunk_elements,
+                      int level, std::string &key)
+{
+    std::vector<FilterDefinitions::PipelineStage> stages;
+    std::string error;
+    if (!FilterDefinitions::parsePipeline(filter_name, stages, error))
+    {
+        return false;
+    }
+    key = ChunkTuner::formatChunkSize(chunk_elements);
+    for (const auto &stage : stages)
+    {
+        std::vector<unsigned int> cd_values;
+        if (!FilterDefinitions::buildCdValues(*stage.filter, stage.fixed_level ? stage.level : level, parameters,
+                                              cd_values, error))
+        {
+            return false;
+        }
+        key += std::string(">") + stage.filter->name + FilterDefinitions::describeCdValues(cd_values);
+    }
+    return true;
+}
+
+std::string CompressionTester::pruneReason(const std::string &filter_name,
+                                           const std::string &parameters,
+                                           size_t chunk_elements,
+                                           int level,
+                                           const std::vector<CompressionResult> &measured,
+                                           double &estimated_ratio) const
+{
+    estimated_ratio = 0.0;
+    std::vector<FilterDefinitions::PipelineStage> stages;
+    std::string error;
+    if (!FilterDefinitions::parsePipeline(filter_name, stages, error))
+    {
+        return "";
+    }
+    bool exact = false;
+    if (estimator_)
+    {
+        estimated_ratio = estimator_->estimateRatio(stages, exact);
+    }
+    if (!prune_)
+    {
+        return "";
+    }
+
+    // 过滤器设置完全相同（例如不使用级别的过滤器的不同级别）：结果不会不同
+    std::string key;
+    if (configKey(filter_name, parameters, chunk_elements, level, key))
+    {
+        for (const auto &other : measured)
+        {
+            std::string other_key;
+            if (configKey(other.filter_name, other.parameters, other.chunk_elements, other.compression_level, other_key) &&
+                other_key == key)
+            {
+                return "same filter settings as " + other.filter_name + " level " + std::to_string(other.compression_level);
+            }
+        }
+    }
+    if (estimated_ratio <= 0)
+    {
+        return "";
+    }
+
+    // 未测配置的乐观位置：压缩比取估计上限，其余目标取同一管线已测级别中最好的值；
+    // 只有在 Pareto 前沿的全部目标上都不差于它的已测配置才能剪除它
+    double bound = exact ? estimated_ratio : estimated_ratio * prune_margin_;
+    CompressionResult candidate;
+    candidate.filter_name = filter_name;
+    candidate.parameters = parameters;
+    candidate.chunk_elements = chunk_elements;
+    candidate.compression_level = level;
+    int covering = ParetoFrontier::coveringPoint(measured, candidate, bound);
+    if (covering >= 0)
+    {
+        const CompressionResult &other = measured[covering];
+        std::stringstream reason;
+        reason << "dominated by " << other.filter_name << " level " << other.compression_level << " (ratio "
+               << std::fixed << std::setprecision(2) << other.compression_ratio << " >= bound " << bound
+               << ", encode, decode and memory no worse)";
+        return reason.str();
+    }
+    return "";
+}
+
+std::vector<CompressionTester::SweepPoint> CompressionTester::buildSweep(const TestConfig &config) const
+{
+    std::vector<SweepPoint> sweep;
+    for (const auto &filter_name : config.filters_to_test)
+    {
+        // 每个 --filters 项是一条过滤器管线（单个过滤器是只有一级的管线）
+        std::vector<FilterDefinitions::PipelineStage> stages;
+        std::string error;
+        bool parsed = FilterDefinitions::parsePipeline(filter_name, stages, error);
+
+        // 级别由管线最后一级决定：固定了级别时只测该级别，否则取注册表中的扫描级别
+        std::vector<int> levels = {1, 6, 9};
+        if (filter_name == CodecSelector::kAutoFilter)
+        {
+            // auto 只运行一次，候选中未固定级别的级使用级别 6
+            levels = {6};
+        }
+        else if (parsed && stages.back().fixed_level)
+        {
+            levels = {stages.back().level};
+        }
+        else if (parsed && config.test_all_levels)
+        {
+            levels.assign(stages.back().filter->sweep_levels.begin(), stages.back().filter->sweep_levels.end());
+        }
+
+        std::vector<std::string> grid = {""};
+        if (parsed)
+        {
+            grid = FilterDefinitions::expandPipelineGrid(stages, config.param_overrides, config.param_grid);
+        }
+        for (const auto &parameters : grid)
+        {
+            for (size_t chunk_elements : config.chunk_sizes)
+            {
+                sweep.push_back({filter_name, parameters, chunk_elements, levels});
+            }
+        }
+    }
+    return sweep;
+}
+
+std::vector<CompressionResult> CompressionTester::runParallel(
+    const TestConfig &config,
+    const std::vector<SweepPoint> &sweep,
+    const std::vector<CompressionResult> &measured)
+{
+    // 并行运行前只能对照已有结果（基准）剪枝，并去掉与已排定配置设置相同的重复配置
+    std::vector<ParallelExecutor::Task> tasks;
+    std::vector<double> estimates;
+    std::vector<CompressionResult> planned = measured;
+    for (const auto &point : sweep)
+    {
+        for (int level : point.levels)
+        {
+            double estimate = 0.0;
+            std::string reason = pruneReason(point.filter_name, point.parameters, point.chunk_elements, level,
+                                             planned, estimate);
+            if (!reason.empty())
+            {
+                std::cout << "Pruned " << point.filter_name << " level " << level << ": " << reason << std::endl;
+                pruned_.push_back({point.filter_name, point.parameters, point.chunk_elements, level, estimate, reason});
+                continue;
+            }
+            ParallelExecutor::Task task;
+            task.filter_name = point.filter_name;
+            task.parameters = point.parameters;
+            task.chunk_elements = point.chunk_elements;
+            task.compression_level = level;
+            tasks.push_back(task);
+            estimates.push_back(estimate);
+
+            // 已排定的配置只用于去重，不参与支配比较
+            CompressionResult pending;
+            pending.filter_name = point.filter_name;
+            pending.parameters = point.parameters;
+            pending.chunk_elements = point.chunk_elements;
+            pending.compression_level = level;
+            pending.error = "pending";
+            planned.push_back(pending);
+        }
+    }
+
+    // 工作进程的输出写入日志文件，避免多个进程的输出交错在一起
+    std::string log_dir = config.output_dir + "/logs";
+    if (!Utils::createDirectory(log_dir))
+    {
+        std::cerr << "Warning: Failed to create worker log directory: " << log_dir << std::endl;
+        log_dir.clear();
+    }
+
+    // 工作进程由 fork 产生，继承父进程已加载的源数据内存区（写时复制，无需重新解码）
+    ParallelExecutor executor(config.jobs, config.job_timeout, log_dir);
+    std::vector<CompressionResult> results =
+        executor.run(tasks, [&](const ParallelExecutor::Task &task)
+                     { return runRepeated(config.input_file, task.filter_name, task.parameters, task.chunk_elements,
+                                          task.compression_level, "results", config.repeat, config.warmup); });
+    for (size_t i = 0; i < results.size() && i < estimates.size(); ++i)
+    {
+        results[i].estimated_ratio = estimates[i];
+    }
+    return results;
+}
+
 bool CompressionTester::generateReport(
     const std::vector<CompressionResult> &results,
     const std::string &output_file,
@@ -98,6 +475,28 @@ bool CompressionTester::generateReport(
         return false;
     }
 
+    // Pareto 前沿散点图与报告放在同一目录，三种格式共用
+    fs::path svg_path(output_file);
+    svg_path.replace_filename(svg_path.stem().string() + "_pareto.svg");
+    if (ParetoFrontier(results, requirements_).writeSvg(svg_path.string(), results))
+    {
+        std::cout << "Pareto plot saved: " << svg_path.string() << std::endl;
+    }
+
+    // 逐数据集明细表同样与报告放在一起
+    bool has_reads = std::any_of(results.begin(), results.end(),
+                                 [](const CompressionResult &r)
+                                 { return !r.reads.empty(); });
+    if (has_reads)
+    {
+        fs::path reads_path(output_file);
+        reads_path.replace_filename(reads_path.stem().string() + "_reads.csv");
+        if (Utils::saveConfig(reads_path.string(), generateReadTableCSV(results)))
+        {
+            std::cout << "Per-read table saved: " << reads_path.string() << std::endl;
+        }
+    }
+
     // 保存报告到文件
     if (Utils::saveConfig(output_file, report_content))
     {
@@ -111,29 +510,6 @@ bool CompressionTester::generateReport(
     }
 }
 
-std::map<std::string, std::vector<int>> CompressionTester::getFilterLevels()
-{
-    std::map<std::string, std::vector<int>> levels;
-
-    levels["GZIP"] = {1, 6, 9};
-
-    levels["SZIP"] = {1, 6, 9};
-
-    levels["SHUFFLE"] = {1, 6, 9};
-
-    levels["LZ4"] = {1, 6, 9};
-
-    levels["ZSTD"] = {1, 6, 9};
-
-    levels["VBZ"] = {1, 6, 9};
-
-    levels["BLOSC"] = {1, 6, 9};
-
-    levels["BLOSC2"] = {1, 6, 9};
-
-    return levels;
-}
-
 std::map<std::string, std::string> CompressionTester::getFilterParameters()
 {
     std::map<std::string, std::string> params;
@@ -152,9 +528,15 @@ std::map<std::string, std::string> CompressionTester::getFilterParameters()
 std::vector<CompressionResult> CompressionTester::testFilterWithLevels(
     const std::string &input_file,
     const std::string &filter_name,
-    const std::vector<int> &levels)
+    const std::string &parameters,
+    size_t chunk_elements,
+    const std::vector<int> &levels,
+    const std::vector<CompressionResult> &measured,
+    int repeat,
+    int warmup)
 {
     std::vector<CompressionResult> results;
+    std::vector<CompressionResult> seen = measured;
 
     // 从输入文件路径生成输出目录
     std::string base_name = Utils::getBaseName(input_file);
@@ -165,55 +547,206 @@ std::vector<CompressionResult> CompressionTester::testFilterWithLevels(
     {
         std::cout << "  Testing level " << level << "... ";
 
-        CompressionResult result = processor_.testCompression(
-            input_file, filter_name, "", level, output_dir);
+        // 估计压缩比达不到当前前沿（或与已测配置设置相同）时跳过
+        double estimate = 0.0;
+        std::string reason = pruneReason(filter_name, parameters, chunk_elements, level, seen, estimate);
+        if (!reason.empty())
+        {
+            std::cout << "pruned: " << reason << std::endl;
+            pruned_.push_back({filter_name, parameters, chunk_elements, level, estimate, reason});
+            continue;
+        }
+
+        CompressionResult result = runRepeated(input_file, filter_name, parameters, chunk_elements, level,
+                                               output_dir, repeat, warmup);
+        result.estimated_ratio = estimate;
         results.push_back(result);
+        seen.push_back(result);
 
         std::cout << "Ratio: " << Utils::formatRatio(result.compression_ratio)
-                  << ", Time: " << result.compression_time_ms << " ms" << std::endl;
+                  << ", Time: " << result.compression_time_ms << " ms"
+                  << ", Decode: " << Utils::formatRatio(result.decompression_mbps) << " MB/s";
+        if (result.compression_stats.samples > 1)
+        {
+            std::cout << " (median of " << result.compression_stats.samples << " runs)";
+        }
+        std::cout << std::endl;
     }
 
     return results;
 }
 
-std::vector<CompressionResult> CompressionTester::testFilterWithShuffle(
+CompressionResult CompressionTester::runRepeated(
     const std::string &input_file,
     const std::string &filter_name,
-    int level)
+    const std::string &parameters,
+    size_t chunk_elements,
+    int level,
+    const std::string &output_dir,
+    int repeat,
+    int warmup)
 {
-    std::vector<CompressionResult> results;
+    repeat = std::max(1, repeat);
+    warmup = std::max(0, warmup);
 
-    // 从输入文件路径生成输出目录
-    std::string base_name = Utils::getBaseName(input_file);
-    std::string name_without_ext = Utils::removeExtension(base_name);
-    std::string output_dir = "results/" + name_without_ext + "_" + filter_name + "_SHUFFLE";
+    ProcessorOptions options = processor_.getOptions();
+    options.chunk_elements = chunk_elements;
+    processor_.setOptions(options);
+
+    // 预热运行：填充页缓存、加载插件，结果丢弃
+    for (int i = 0; i < warmup; ++i)
+    {
+        processor_.testCompression(input_file, filter_name, parameters, level, output_dir);
+    }
+
+    std::vector<CompressionResult> runs;
+    std::vector<double> compress_ms;
+    std::vector<double> decompress_ms;
+    size_t peak_memory = 0;
+    for (int i = 0; i < repeat; ++i)
+    {
+        // 峰值常驻内存每次运行前重置为当前值，增量即为该配置运行时的内存开销（不含已加载的源数据内存区）
+        bool peak_reset = Utils::resetPeakResidentMemory();
+        size_t resident_before = Utils::getResidentMemory();
+        ResourceUsage usage_before = ResourceUsage::capture();
+        runs.push_back(processor_.testCompression(input_file, filter_name, parameters, level, output_dir));
+        runs.back().resources = ResourceUsage::capture().since(usage_before);
+        size_t peak = Utils::getPeakResidentMemory();
+        if (peak_reset && peak > resident_before)
+        {
+            peak_memory = std::max(peak_memory, peak - resident_before);
+        }
+        compress_ms.push_back(runs.back().phases.totalNs() / 1.0e6);
+        decompress_ms.push_back(runs.back().decompression_time_ns / 1.0e6);
+    }
+
+    TimingStats compress_stats = Statistics::summarize(compress_ms);
+    TimingStats decompress_stats = Statistics::summarize(decompress_ms);
+
+    // 选取压缩耗时最接近中位数的一次运行作为代表（分阶段耗时等明细来自这一次）
+    size_t representative = 0;
+    for (size_t i = 1; i < runs.size(); ++i)
+    {
+        if (std::abs(compress_ms[i] - compress_stats.median) <
+            std::abs(compress_ms[representative] - compress_stats.median))
+        {
+            representative = i;
+        }
+    }
 
-    // 确保输出目录存在
-    if (!Utils::createDirectory(output_dir))
+    CompressionResult result = runs[representative];
+    result.compression_stats = compress_stats;
+    result.decompression_stats = decompress_stats;
+    result.compression_time_ms = static_cast<long long>(std::llround(compress_stats.median));
+    result.decompression_time_ms = static_cast<long long>(std::llround(decompress_stats.median));
+    result.peak_memory_bytes = peak_memory;
+    if (compress_stats.median > 0.0)
     {
-        std::cerr << "Warning: Failed to create output directory: " << output_dir << std::endl;
-        output_dir = ""; // 使用默认输出目录
+        result.compression_mbps = (result.signal_bytes / (1024.0 * 1024.0)) / (compress_stats.median / 1000.0);
     }
 
-    // 测试SHUFFLE + 过滤器的组合
-    std::string combined_name = "SHUFFLE+" + filter_name;
-    std::string parameters = "shuffle=1";
+    // 逐数据集的编码/解码耗时取各次运行的中位数，与整体耗时的口径一致
+    if (runs.size() > 1)
+    {
+        ReadTable &reads = result.reads;
+        for (size_t row = 0; row < reads.size(); ++row)
+        {
+            std::vector<double> encode_ns;
+            std::vector<double> decode_ns;
+            for (const auto &run : runs)
+            {
+                long run_row = run.reads.find(reads.paths[row]);
+                if (run_row < 0)
+                {
+                    continue;
+                }
+                if (run.reads.encode_ns[run_row] >= 0)
+                {
+                    encode_ns.push_back(static_cast<double>(run.reads.encode_ns[run_row]));
+                }
+                if (run.reads.decode_ns[run_row] >= 0)
+                {
+                    decode_ns.push_back(static_cast<double>(run.reads.decode_ns[run_row]));
+                }
+            }
+            if (!encode_ns.empty())
+            {
+                reads.encode_ns[row] = std::llround(Statistics::quantile(encode_ns, 0.5));
+            }
+            if (!decode_ns.empty())
+            {
+                reads.decode_ns[row] = std::llround(Statistics::quantile(decode_ns, 0.5));
+            }
+        }
+    }
 
-    std::cout << "  Testing " << combined_name << " (level " << level << ")... ";
+    // 任何一次运行校验失败或出错都需要体现在结果中
+    for (const auto &run : runs)
+    {
+        result.verification_failures = std::max(result.verification_failures, run.verification_failures);
+        if (result.error.empty() && !run.error.empty())
+        {
+            result.error = run.error;
+        }
+    }
 
-    CompressionResult result = processor_.testCompression(
-        input_file, filter_name, parameters, level, output_dir);
+    return result;
+}
 
-    // 修改过滤器名称以反映组合
-    result.filter_name = combined_name;
-    result.parameters = parameters;
+// 写放大：目标文件经 VFD 写入的字节数 / 数据集存储大小，未追踪时为 0
+static double ioAmplification(const CompressionResult &result)
+{
+    long long written = result.destination_io.total(IoStats::kWrite).bytes;
+    return written > 0 && result.compressed_size_bytes > 0
+               ? static_cast<double>(written) / result.compressed_size_bytes
+               : 0.0;
+}
 
-    results.push_back(result);
+// 报告中模拟的存储层：全部预设，加上 --throttle 给出的自定义设备
+static std::vector<StorageProfile> storageTiers(const StorageProfile &throttle)
+{
+    std::vector<StorageProfile> tiers = StorageProfile::presets();
+    if (throttle.enabled() && throttle.name == "custom")
+    {
+        tiers.push_back(throttle);
+    }
+    return tiers;
+}
 
-    std::cout << "Ratio: " << Utils::formatRatio(result.compression_ratio)
-              << ", Time: " << result.compression_time_ms << " ms" << std::endl;
+// 在给定存储层上的端到端写入（压缩全过程）与恢复（解压校验）吞吐量：实测耗时减去目标文件实测的 VFD 耗时，
+// 再加上同一组访问在该设备上的模型耗时。源文件的读取保持实测值。未追踪 I/O 时返回 false
+static bool tierThroughput(const CompressionResult &result, const StorageProfile &tier,
+                           double &ingest_mbps, double &restore_mbps)
+{
+    if (!result.destination_io.collected() || result.signal_bytes == 0)
+    {
+        return false;
+    }
+    double mb = result.signal_bytes / (1024.0 * 1024.0);
+    long long dst_ns = result.destination_io.total(IoStats::kRead).ns + result.destination_io.total(IoStats::kWrite).ns;
+    long long ingest_ns = std::max(1LL, result.phases.totalNs() - dst_ns + result.destination_io.deviceNs(tier));
+    long long restore_ns = std::max(1LL, result.decompression_time_ns - result.decode_io.total(IoStats::kRead).ns +
+                                             result.decode_io.deviceNs(tier));
+    ingest_mbps = mb / (ingest_ns / 1.0e9);
+    restore_mbps = mb / (restore_ns / 1.0e9);
+    return true;
+}
 
-    return results;
+// 分块大小列："full"、"64K"，自动调优时附带各数据集选中的分块大小，例如 "auto (64K x18, 16K x2)"
+static std::string chunkLabel(const CompressionResult &result)
+{
+    std::string label = ChunkTuner::formatChunkSize(result.chunk_elements);
+    if (!result.tuned_chunks.empty())
+    {
+        label += " (";
+        for (size_t i = 0; i < result.tuned_chunks.size(); ++i)
+        {
+            label += (i > 0 ? ", " : "") + ChunkTuner::formatChunkSize(result.tuned_chunks[i].first) +
+                     " x" + std::to_string(result.tuned_chunks[i].second);
+        }
+        label += ")";
+    }
+    return label;
 }
 
 std::string CompressionTester::generateMarkdownReport(const std::vector<CompressionResult> &results)
@@ -231,61 +764,994 @@ std::string CompressionTester::generateMarkdownReport(const std::vector<Compress
     ss << "- Test Time: " << Utils::getCurrentTimeString() << "\n";
     ss << "- System: " << Utils::getSystemInfo() << "\n";
     ss << "- CPU: " << Utils::getCPUInfo() << "\n";
-    ss << "- Available Memory: " << Utils::formatSize(Utils::getAvailableMemory()) << "\n\n";
+    ss << "- Available Memory: " << Utils::formatSize(Utils::getAvailableMemory()) << "\n";
+    bool in_memory = std::any_of(results.begin(), results.end(),
+                                 [](const CompressionResult &r)
+                                 { return r.in_memory; });
+    ss << "- Destination: " << (in_memory ? "in-memory (HDF5 core VFD, no backing store)" : "disk") << "\n";
+    if (throttle_.enabled() && !in_memory)
+    {
+        ss << "- Storage Emulation: destination writes and decode reads throttled to " << throttle_.name << " ("
+           << std::defaultfloat << std::setprecision(6)
+           << throttle_.read_mbps << " MB/s read, " << throttle_.write_mbps << " MB/s write, " << throttle_.latency_us
+           << " us per non-sequential access); measured times include the emulated device\n";
+    }
+    int encode_threads = 0;
+    for (const auto &result : results)
+    {
+        encode_threads = std::max(encode_threads, result.encode_threads);
+    }
+    if (encode_threads > 0)
+    {
+        ss << "- Chunk Encoding: " << encode_threads << " in-process encoder threads, chunks written with H5Dwrite_chunk"
+           << " (configurations without an in-process codec use the HDF5 filter pipeline)\n";
+    }
+    else
+    {
+        ss << "- Chunk Encoding: HDF5 filter pipeline\n";
+    }
+    int decode_threads = 0;
+    for (const auto &result : results)
+    {
+        decode_threads = std::max(decode_threads, result.decode_threads);
+    }
+    if (decode_threads > 0)
+    {
+        ss << "- Chunk Decoding: " << decode_threads << " in-process decoder threads over H5Dread_chunk"
+           << " (datasets without an in-process codec use H5Dread)\n";
+    }
+    else
+    {
+        ss << "- Chunk Decoding: H5Dread\n";
+    }
+    if (!arena_.empty())
+    {
+        ss << "- Source Ingest: " << arena_.entries().size() << " Signal datasets ("
+           << Utils::formatSize(arena_.totalBytes()) << ") decoded once in "
+           << std::fixed << std::setprecision(3) << arena_.loadTimeNs() / 1.0e6
+           << " ms; configurations write from memory\n";
+        if (arena_.mappedEntries() > 0)
+        {
+            ss << "- Source Mapping: " << arena_.mappedEntries() << " contiguous unfiltered datasets ("
+               << Utils::formatSize(arena_.mappedBytes()) << ") read in place from the mmap'd source file\n";
+        }
+    }
+    else
+    {
+        ss << "- Source Ingest: none, each configuration reads and decodes the source file\n";
+    }
+    if (!inventory_.empty())
+    {
+        ss << "- Dataset Inventory: " << inventory_.objects().size() << " objects, "
+           << inventory_.signalDatasets().size() << " Signal datasets, "
+           << (inventory_.fromSidecar() ? "read from " : "scanned once in ")
+           << (inventory_.fromSidecar() ? DatasetInventory::sidecarPath(inventory_.sourceFile()) + " in " : "")
+           << std::fixed << std::setprecision(3) << inventory_.loadTimeNs() / 1.0e6
+           << " ms; configurations do not traverse the source file\n";
+    }
+    if (processor_.skeletonBytes() > 0)
+    {
+        const MetadataReplicator::Stats &stats = processor_.skeletonStats();
+        ss << "- Metadata Skeleton: " << stats.groups_created << " groups (" << stats.attributes_copied
+           << " attributes), " << stats.subtrees_copied << " subtrees copied with H5Ocopy, " << stats.links_created
+           << " links (" << Utils::formatSize(processor_.skeletonBytes()) << ") built once in "
+           << std::fixed << std::setprecision(3) << processor_.skeletonBuildNs() / 1.0e6
+           << " ms; every output file starts from it";
+        if (stats.datasets_recompressed > 0)
+        {
+            ss << ", including " << stats.datasets_recompressed << " datasets recompressed by policy";
+        }
+        ss << "\n";
+    }
+    const CompressionPolicy &policy = processor_.getOptions().policy;
+    ss << "- Compression Policy: " << (policy.source().empty() ? "default" : policy.source()) << " (";
+    for (size_t i = 0; i < policy.rules().size(); ++i)
+    {
+        ss << (i > 0 ? "; " : "") << "`" << policy.rules()[i].label() << "`";
+    }
+    ss << "); Signal datasets always use the configuration under test\n";
+    ss << "\n";
 
     // 结果表格
     ss << "## Test Results\n\n";
-    ss << "| Filter | Parameters | Level | Ratio | Comp Time (ms) | Decomp Time (ms) | Size | Original Size |\n";
-    ss << "|--------|------------|-------|-------|----------------|------------------|------|---------------|\n";
+    ss << "| Filter | Parameters | Level | Chunk | Ratio | File Ratio | Est. Ratio | Comp Time (ms) | Decomp Time (ms) | Decode MB/s | Slice Read (us) | Verified | Size | Original Size |\n";
+    ss << "|--------|------------|-------|-------|-------|------------|------------|----------------|------------------|-------------|-----------------|----------|------|---------------|\n";
 
     for (const auto &result : results)
     {
         ss << "| " << result.filter_name
            << " | " << result.parameters
            << " | " << result.compression_level
+           << " | " << chunkLabel(result)
            << " | " << std::fixed << std::setprecision(2) << result.compression_ratio
+           << " | " << (result.file_ratio > 0 ? Utils::formatRatio(result.file_ratio) : "-")
+           << " | " << (result.estimated_ratio > 0 ? Utils::formatRatio(result.estimated_ratio) : "-")
            << " | " << result.compression_time_ms
            << " | " << result.decompression_time_ms
+           << " | " << std::fixed << std::setprecision(2) << result.decompression_mbps
+           << " | " << std::fixed << std::setprecision(1) << result.slice_read_us
+           << " | " << (result.verified_datasets - result.verification_failures) << "/" << result.verified_datasets
+           << (result.verification_failures > 0 ? " FAIL" : "")
+           << (result.error.empty() ? "" : " ERROR")
            << " | " << Utils::formatSize(result.compressed_size_bytes)
            << " | " << Utils::formatSize(result.original_size_bytes)
            << " |\n";
     }
 
-    // 分析部分
-    ss << "\n## Analysis\n\n";
-
-    // 声明变量
-    std::vector<CompressionResult>::const_iterator max_ratio, min_time, best_balance;
-    bool has_results = !results.empty();
+    // 整个文件的存储：各类数据集的原始与存储字节数，剩余部分为元数据、属性与空闲空间
+    bool has_classes = std::any_of(results.begin(), results.end(),
+                                   [](const CompressionResult &r)
+                                   { return !r.storage_classes.empty(); });
+    if (has_classes)
+    {
+        ss << "\n## Whole-File Storage\n\n";
+        ss << "Ratio and Size above cover the Signal datasets only. File Ratio is input file bytes / output file "
+           << "bytes. Below, every dataset is assigned to the first policy rule matching its path (Signal datasets "
+           << "form their own class) and charged its storage size; the None row is the input file. Raw is elements "
+           << "x type size (variable-length data counts its handles only); Other is the rest of the file: groups, "
+           << "attributes, object headers and free space. The File row compares the input file (Raw) with the output file "
+           << "(Stored).\n\n";
+        ss << "| Filter | Level | Class | Datasets | Raw | Stored | Ratio | Share of File |\n";
+        ss << "|--------|-------|-------|----------|-----|--------|-------|---------------|\n";
+        for (const auto &result : results)
+        {
+            if (result.storage_classes.empty())
+            {
+                continue;
+            }
+            size_t file_bytes = result.output_file_bytes;
+            size_t dataset_bytes = 0;
+            auto share = [file_bytes](size_t bytes)
+            {
+                return file_bytes > 0 ? Utils::formatRatio(100.0 * bytes / file_bytes) + "%" : std::string("-");
+            };
+            for (const auto &entry : result.storage_classes)
+            {
+                if (entry.datasets == 0)
+                {
+                    continue;
+                }
+                dataset_bytes += entry.stored_bytes;
+                ss << "| " << result.filter_name
+                   << " | " << result.compression_level
+                   << " | " << entry.name
+                   << " | " << entry.datasets
+                   << " | " << Utils::formatSize(entry.raw_bytes)
+                   << " | " << Utils::formatSize(entry.stored_bytes)
+                   << " | " << (entry.stored_bytes > 0 ? Utils::formatRatio(static_cast<double>(entry.raw_bytes) /
+                                                                              entry.stored_bytes)
+                                                         : "-")
+                   << " | " << share(entry.stored_bytes)
+                   << " |\n";
+            }
+            size_t other_bytes = file_bytes > dataset_bytes ? file_bytes - dataset_bytes : 0;
+            ss << "| " << result.filter_name
+               << " | " << result.compression_level
+               << " | Other | - | - | " << Utils::formatSize(other_bytes)
+               << " | - | " << share(other_bytes)
+               << " |\n";
+            ss << "| " << result.filter_name
+               << " | " << result.compression_level
+               << " | **File** | - | " << Utils::formatSize(result.input_file_bytes)
+               << " | " << Utils::formatSize(file_bytes)
+               << " | " << (result.file_ratio > 0 ? Utils::formatRatio(result.file_ratio) : "-")
+               << " | 100.00% |\n";
+        }
+    }
 
-    if (has_results)
+    // 可压缩性估计与被剪除的配置
+    if (estimator_)
     {
-        // 找到最佳压缩比
-        max_ratio = std::max_element(results.begin(), results.end(),
-                                     [](const CompressionResult &a, const CompressionResult &b)
-                                     {
-                                         return a.compression_ratio < b.compression_ratio;
-                                     });
+        CompressibilityEstimator::Entropy e = estimator_->entropy();
+        ss << "\n## Compressibility Estimate\n\n";
+        ss << "Entropy over " << e.reads << " reads (" << e.elements << " samples, "
+           << CompressibilityEstimator::kernelName() << " delta kernels). Est. Ratio is 16 bits divided by the "
+           << "lowest entropy among the representations a pipeline's coder can exploit; configurations are pruned "
+           << "when Est. Ratio x " << std::fixed << std::setprecision(2) << prune_margin_
+           << " cannot beat an already measured point that is also no worse in encode MB/s, decode MB/s and peak "
+           << "memory than the best measured level of the same pipeline.\n\n";
+        ss << "| Representation | Bits/Sample | Ratio Bound |\n";
+        ss << "|----------------|-------------|-------------|\n";
+        const std::pair<const char *, double> rows[] = {{"Raw values", e.raw},
+                                                        {"First deltas", e.delta1},
+                                                        {"Second deltas", e.delta2},
+                                                        {"Byte planes (low + high)", e.planes},
+                                                        {"Byte planes, order-1 context", e.planes_context},
+                                                        {"Interleaved bytes", e.bytes}};
+        for (const auto &row : rows)
+        {
+            ss << "| " << row.first << " | " << std::fixed << std::setprecision(3) << row.second
+               << " | " << std::setprecision(2) << 16.0 / std::max(row.second, 0.05) << " |\n";
+        }
+    }
+    if (!pruned_.empty())
+    {
+        ss << "\n## Pruned Configurations\n\n";
+        ss << "| Filter | Parameters | Level | Chunk | Est. Ratio | Reason |\n";
+        ss << "|--------|------------|-------|-------|------------|--------|\n";
+        for (const auto &config : pruned_)
+        {
+            ss << "| " << config.filter_name
+               << " | " << config.parameters
+               << " | " << config.level
+               << " | " << ChunkTuner::formatChunkSize(config.chunk_elements)
+               << " | " << (config.estimated_ratio > 0 ? Utils::formatRatio(config.estimated_ratio) : "-")
+               << " | " << config.reason
+               << " |\n";
+        }
+    }
 
-        // 找到最快压缩
-        min_time = std::min_element(results.begin(), results.end(),
-                                    [](const CompressionResult &a, const CompressionResult &b)
-                                    {
-                                        return a.compression_time_ms < b.compression_time_ms;
-                                    });
+    // 分阶段耗时（毫秒，来自纳秒计时）
+    ss << "\n## Phase Breakdown (ms)\n\n";
+    ss << "| Filter | Level | Source Open | Metadata Copy | Source Read | Dataset Create | Encode+Write | Flush/Close | Total |\n";
+    ss << "|--------|-------|-------------|---------------|-------------|----------------|--------------|-------------|-------|\n";
 
-        // 找到最佳平衡（压缩比/时间）
-        best_balance = std::max_element(results.begin(), results.end(),
-                                        [](const CompressionResult &a, const CompressionResult &b)
-                                        {
-                                            double score_a = a.compression_ratio / (a.compression_time_ms + 1.0);
-                                            double score_b = b.compression_ratio / (b.compression_time_ms + 1.0);
-                                            return score_a < score_b;
-                                        });
+    auto ns_to_ms = [](long long ns)
+    { return ns / 1.0e6; };
+    for (const auto &result : results)
+    {
+        const PhaseTimings &p = result.phases;
+        ss << "| " << result.filter_name
+           << " | " << result.compression_level
+           << std::fixed << std::setprecision(3)
+           << " | " << ns_to_ms(p.source_open_ns)
+           << " | " << ns_to_ms(p.metadata_copy_ns)
+           << " | " << ns_to_ms(p.source_read_ns)
+           << " | " << ns_to_ms(p.dataset_create_ns)
+           << " | " << ns_to_ms(p.encode_write_ns)
+           << " | " << ns_to_ms(p.flush_close_ns)
+           << " | " << ns_to_ms(p.totalNs())
+           << " |\n";
+    }
 
-        ss << "### Best Compression Ratio\n";
-        ss << "- **Filter**: " << max_ratio->filter_name << "\n";
-        ss << "- **Level**: " << max_ratio->compression_level << "\n";
+    // 资源消耗（getrusage 与 /proc/self/io 的差值，与墙钟时间并列）
+    ss << "\n## Resource Usage\n\n";
+    ss << "getrusage and /proc/self/io deltas over one run of each configuration (the representative run when "
+       << "repeated), measured by the process that ran it. CPU s/GB is user + system time per GB of Signal data; "
+       << "Max RSS is the process peak during the run; I/O read/write are bytes submitted to the storage layer, "
+       << "syscall bytes (rchar/wchar) in parentheses.\n\n";
+    ss << "| Filter | Level | Comp Time (ms) | Decomp Time (ms) | User (s) | Sys (s) | CPU s/GB | Max RSS | Minor Faults | Major Faults | Vol. CS | Invol. CS | I/O Read | I/O Write |\n";
+    ss << "|--------|-------|----------------|------------------|----------|---------|----------|---------|--------------|--------------|---------|-----------|----------|-----------|\n";
+    auto io_cell = [](long long storage, long long syscall)
+    {
+        if (storage < 0)
+        {
+            return std::string("-");
+        }
+        return Utils::formatSize(static_cast<size_t>(storage)) + " (" +
+               Utils::formatSize(static_cast<size_t>(std::max(0LL, syscall))) + ")";
+    };
+    for (const auto &result : results)
+    {
+        if (result.filter_name == "None")
+        {
+            continue;
+        }
+        const ResourceUsage &u = result.resources;
+        ss << "| " << result.filter_name
+           << " | " << result.compression_level
+           << " | " << result.compression_time_ms
+           << " | " << result.decompression_time_ms
+           << std::fixed << std::setprecision(3)
+           << " | " << u.user_seconds
+           << " | " << u.system_seconds
+           << " | " << std::setprecision(2) << u.cpuSecondsPerGb(result.signal_bytes)
+           << " | " << (u.max_rss_bytes > 0 ? Utils::formatSize(u.max_rss_bytes) : "-")
+           << " | " << u.minor_faults
+           << " | " << u.major_faults
+           << " | " << u.voluntary_switches
+           << " | " << u.involuntary_switches
+           << " | " << io_cell(u.io_read_bytes, u.io_rchar)
+           << " | " << io_cell(u.io_write_bytes, u.io_wchar)
+           << " |\n";
+    }
+
+    // 计数 VFD：HDF5 实际发出的读写
+    bool has_io = std::any_of(results.begin(), results.end(),
+                              [](const CompressionResult &r)
+                              { return r.destination_io.collected() || r.source_io.collected(); });
+    if (has_io)
+    {
+        ss << "\n## I/O Trace\n\n";
+        ss << "Calls issued by HDF5 through the counting VFD (sec2 underneath). Amplification is destination bytes "
+           << "written / compressed payload (dataset storage size); values well above 1 or many small or "
+           << "unaligned (not 4 KiB aligned) writes point at chunk or metadata settings. Decode reads are the "
+           << "verification pass over the output file.\n\n";
+        ss << "| Filter | Level | Dst Writes | Written | Amplification | Meta Writes | Meta Written | Small Writes (<4K) | Unaligned Writes | Mean Write (us) | Src Reads | Src Read | Decode Reads | Decode Read |\n";
+        ss << "|--------|-------|------------|---------|---------------|-------------|--------------|--------------------|------------------|-----------------|-----------|----------|--------------|-------------|\n";
+        for (const auto &result : results)
+        {
+            if (!result.destination_io.collected() && !result.source_io.collected())
+            {
+                continue;
+            }
+            IoOpStats writes = result.destination_io.total(IoStats::kWrite);
+            const IoOpStats &meta_writes = result.destination_io.at(IoStats::kMetadata, IoStats::kWrite);
+            IoOpStats src_reads = result.source_io.total(IoStats::kRead);
+            IoOpStats decode_reads = result.decode_io.total(IoStats::kRead);
+            ss << "| " << result.filter_name
+               << " | " << result.compression_level
+               << " | " << writes.calls
+               << " | " << Utils::formatSize(static_cast<size_t>(writes.bytes))
+               << " | " << std::fixed << std::setprecision(3) << ioAmplification(result)
+               << " | " << meta_writes.calls
+               << " | " << Utils::formatSize(static_cast<size_t>(meta_writes.bytes))
+               << " | " << writes.small()
+               << " | " << writes.unaligned
+               << " | " << std::setprecision(1) << writes.meanUs()
+               << " | " << src_reads.calls
+               << " | " << Utils::formatSize(static_cast<size_t>(src_reads.bytes))
+               << " | " << decode_reads.calls
+               << " | " << Utils::formatSize(static_cast<size_t>(decode_reads.bytes))
+               << " |\n";
+        }
+
+        ss << "\n### Destination Write Sizes\n\n";
+        ss << "| Filter | Level | Access |";
+        for (int b = 0; b < IoOpStats::kSizeBuckets; ++b)
+        {
+            ss << " " << IoOpStats::bucketLabel(b) << " |";
+        }
+        ss << "\n|--------|-------|--------|";
+        for (int b = 0; b < IoOpStats::kSizeBuckets; ++b)
+        {
+            ss << "------|";
+        }
+        ss << "\n";
+        for (const auto &result : results)
+        {
+            if (!result.destination_io.collected())
+            {
+                continue;
+            }
+            const std::pair<const char *, IoStats::Access> accesses[] = {{"metadata", IoStats::kMetadata},
+                                                                         {"raw", IoStats::kRaw}};
+            for (const auto &access : accesses)
+            {
+                const IoOpStats &op = result.destination_io.at(access.second, IoStats::kWrite);
+                ss << "| " << result.filter_name << " | " << result.compression_level << " | " << access.first << " |";
+                for (int b = 0; b < IoOpStats::kSizeBuckets; ++b)
+                {
+                    ss << " " << op.size_hist[b] << " |";
+                }
+                ss << "\n";
+            }
+        }
+    }
+
+    // 存储层模拟：每个配置在各存储层上的端到端吞吐量，以及每层最快的配置
+    if (has_io)
+    {
+        std::vector<StorageProfile> tiers = storageTiers(throttle_);
+        ss << "\n## Storage Tiers (MB/s of Signal data)\n\n";
+        ss << "End-to-end ingest (compression run) and restore (decode verification) throughput with the output "
+           << "file on each emulated tier: the measured time minus the measured destination VFD time, plus the "
+           << "same traced accesses on the modelled device (one latency per non-sequential access, bytes at the "
+           << "tier bandwidth). Source reads keep their measured cost. Tiers:";
+        for (size_t t = 0; t < tiers.size(); ++t)
+        {
+            ss << (t > 0 ? "," : "") << " " << tiers[t].name << " " << std::defaultfloat << std::setprecision(6)
+               << tiers[t].read_mbps << "/" << tiers[t].write_mbps << " MB/s r/w, " << tiers[t].latency_us << " us";
+        }
+        ss << ".\n\n";
+        ss << "| Filter | Level |";
+        for (const auto &tier : tiers)
+        {
+            ss << " " << tier.name << " Ingest | " << tier.name << " Restore |";
+        }
+        ss << "\n|--------|-------|";
+        for (size_t t = 0; t < tiers.size(); ++t)
+        {
+            ss << "------|------|";
+        }
+        ss << "\n";
+        std::vector<int> best_ingest(tiers.size(), -1);
+        std::vector<int> best_restore(tiers.size(), -1);
+        std::vector<double> best_ingest_mbps(tiers.size(), 0.0);
+        std::vector<double> best_restore_mbps(tiers.size(), 0.0);
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const CompressionResult &result = results[i];
+            double ingest_mbps = 0.0;
+            double restore_mbps = 0.0;
+            if (!tierThroughput(result, tiers[0], ingest_mbps, restore_mbps))
+            {
+                continue;
+            }
+            bool usable = result.error.empty() && result.verification_failures == 0;
+            ss << "| " << result.filter_name << " | " << result.compression_level << " |";
+            for (size_t t = 0; t < tiers.size(); ++t)
+            {
+                tierThroughput(result, tiers[t], ingest_mbps, restore_mbps);
+                ss << " " << std::fixed << std::setprecision(1) << ingest_mbps << " | " << restore_mbps << " |";
+                if (usable && ingest_mbps > best_ingest_mbps[t])
+                {
+                    best_ingest_mbps[t] = ingest_mbps;
+                    best_ingest[t] = static_cast<int>(i);
+                }
+                if (usable && restore_mbps > best_restore_mbps[t])
+                {
+                    best_restore_mbps[t] = restore_mbps;
+                    best_restore[t] = static_cast<int>(i);
+                }
+            }
+            ss << "\n";
+        }
+
+        ss << "\n### Best Configuration per Tier\n\n";
+        ss << "| Tier | Fastest Ingest | Ingest MB/s | Fastest Restore | Restore MB/s |\n";
+        ss << "|------|----------------|-------------|-----------------|--------------|\n";
+        auto config_name = [&](int index)
+        {
+            return index < 0 ? std::string("-")
+                             : results[index].filter_name + " L" + std::to_string(results[index].compression_level);
+        };
+        for (size_t t = 0; t < tiers.size(); ++t)
+        {
+            ss << "| " << tiers[t].name
+               << " | " << config_name(best_ingest[t])
+               << " | " << std::fixed << std::setprecision(1) << best_ingest_mbps[t]
+               << " | " << config_name(best_restore[t])
+               << " | " << best_restore_mbps[t]
+               << " |\n";
+        }
+    }
+
+    // 性能计数器（每 MB Signal 原始数据）
+    bool has_counters = std::any_of(results.begin(), results.end(),
+                                    [](const CompressionResult &r)
+                                    { return r.encode_counters.collected(); });
+    if (has_counters)
+    {
+        ss << "\n## Performance Counters (per MB)\n\n";
+        ss << "Counted over compression (source open to destination close) and decode verification, normalized by "
+           << "the Signal bytes. \"hardware\" rows come from perf_event_open cycle/instruction/cache counters "
+           << "(user space); \"software\" and \"rusage\" rows only have CPU time and context switches because "
+           << "the kernel denied hardware counters. High LLC MPKI with low IPC points to a memory-bound codec.\n\n";
+        ss << "| Filter | Level | Phase | Source | CPU ms/MB | Cycles/MB | Instructions/MB | IPC | LLC Misses/MB | LLC MPKI | Branch Misses/MB | Ctx Switches/MB |\n";
+        ss << "|--------|-------|-------|--------|-----------|-----------|-----------------|-----|---------------|----------|------------------|-----------------|\n";
+        auto count_cell = [](double value, int precision)
+        {
+            std::stringstream cell;
+            if (value < 0)
+            {
+                cell << "-";
+            }
+            else
+            {
+                cell << std::fixed << std::setprecision(precision) << value;
+            }
+            return cell.str();
+        };
+        for (const auto &result : results)
+        {
+            const std::pair<const char *, const CounterSample *> phases[] = {{"encode", &result.encode_counters},
+                                                                              {"decode", &result.decode_counters}};
+            for (const auto &phase : phases)
+            {
+                const CounterSample &c = *phase.second;
+                if (!c.collected())
+                {
+                    continue;
+                }
+                ss << "| " << result.filter_name
+                   << " | " << result.compression_level
+                   << " | " << phase.first
+                   << " | " << c.source
+                   << " | " << count_cell(c.perMb(c.task_clock_ns) / 1.0e6, 3)
+                   << " | " << count_cell(c.perMb(c.cycles), 0)
+                   << " | " << count_cell(c.perMb(c.instructions), 0)
+                   << " | " << count_cell(c.cycles > 0 && c.instructions >= 0 ? c.ipc() : -1.0, 2)
+                   << " | " << count_cell(c.perMb(c.llc_misses), 0)
+                   << " | " << count_cell(c.llcMpki(), 2)
+                   << " | " << count_cell(c.perMb(c.branch_misses), 0)
+                   << " | " << count_cell(c.perMb(c.context_switches), 2)
+                   << " |\n";
+            }
+        }
+    }
+
+    // 逐数据集分布：每个配置的分位数摘要，以及按 log2(读长) 分组的压缩比
+    bool has_reads = std::any_of(results.begin(), results.end(),
+                                 [](const CompressionResult &r)
+                                 { return r.filter_name != "None" && !r.reads.empty(); });
+    if (has_reads)
+    {
+        ss << "\n## Per-Read Distribution\n\n";
+        ss << "Quantiles over the Signal datasets (reads) of each configuration; the full per-read table is "
+           << "written next to this report as `*_reads.csv`. Encode time per read is only attributable on the "
+           << "H5Dwrite path (not with --encode-threads or --pipeline), decode time only with H5Dread "
+           << "(not with --decode-threads); \"-\" marks configurations without per-read timings.\n\n";
+        ss << "| Filter | Level | Reads | Length p50 | Ratio p10 | Ratio p50 | Ratio p90 | Encode MB/s p10 | Encode MB/s p50 | Decode MB/s p10 | Decode MB/s p50 |\n";
+        ss << "|--------|-------|-------|------------|-----------|-----------|-----------|-----------------|-----------------|-----------------|-----------------|\n";
+        auto quantile_cell = [](const std::vector<double> &values, double q)
+        {
+            std::stringstream cell;
+            if (values.empty())
+            {
+                cell << "-";
+            }
+            else
+            {
+                cell << std::fixed << std::setprecision(2) << Statistics::quantile(values, q);
+            }
+            return cell.str();
+        };
+        for (const auto &result : results)
+        {
+            const ReadTable &reads = result.reads;
+            if (result.filter_name == "None" || reads.empty())
+            {
+                continue;
+            }
+            std::vector<double> lengths;
+            std::vector<double> ratios;
+            std::vector<double> encode_mbps;
+            std::vector<double> decode_mbps;
+            for (size_t row = 0; row < reads.size(); ++row)
+            {
+                lengths.push_back(static_cast<double>(reads.elements[row]));
+                if (reads.ratio(row) > 0)
+                {
+                    ratios.push_back(reads.ratio(row));
+                }
+                if (reads.encodeMbps(row) > 0)
+                {
+                    encode_mbps.push_back(reads.encodeMbps(row));
+                }
+                if (reads.decodeMbps(row) > 0)
+                {
+                    decode_mbps.push_back(reads.decodeMbps(row));
+                }
+            }
+            ss << "| " << result.filter_name
+               << " | " << result.compression_level
+               << " | " << reads.size()
+               << " | " << static_cast<size_t>(Statistics::quantile(lengths, 0.5))
+               << " | " << quantile_cell(ratios, 0.1)
+               << " | " << quantile_cell(ratios, 0.5)
+               << " | " << quantile_cell(ratios, 0.9)
+               << " | " << quantile_cell(encode_mbps, 0.1)
+               << " | " << quantile_cell(encode_mbps, 0.5)
+               << " | " << quantile_cell(decode_mbps, 0.1)
+               << " | " << quantile_cell(decode_mbps, 0.5)
+               << " |\n";
+        }
+
+        // 读长分组作为列，所有配置共用同一组列
+        std::vector<int> bucket_keys;
+        for (const auto &result : results)
+        {
+            for (const auto &bucket : result.reads.lengthBuckets())
+            {
+                if (std::find(bucket_keys.begin(), bucket_keys.end(), bucket.log2_elements) == bucket_keys.end())
+                {
+                    bucket_keys.push_back(bucket.log2_elements);
+                }
+            }
+        }
+        std::sort(bucket_keys.begin(), bucket_keys.end());
+
+        ss << "\n### Ratio by Read Length\n\n";
+        ss << "Aggregate compression ratio (sum of original bytes / sum of compressed bytes) of the reads whose "
+           << "sample count falls in each power-of-two range. Short reads pay a fixed per-dataset overhead "
+           << "(chunk index, filter headers) that long reads amortize. Column headers give the number of reads.\n\n";
+        // 各配置的数据集相同，每组的读数取第一个非空配置
+        std::vector<ReadTable::LengthBucket> reference;
+        for (const auto &result : results)
+        {
+            if (!result.reads.empty())
+            {
+                reference = result.reads.lengthBuckets();
+                break;
+            }
+        }
+        ss << "| Filter | Level |";
+        for (int key : bucket_keys)
+        {
+            size_t count = 0;
+            for (const auto &bucket : reference)
+            {
+                if (bucket.log2_elements == key)
+                {
+                    count = bucket.reads;
+                }
+            }
+            ss << " " << ReadTable::bucketLabel(key) << " (" << count << ") |";
+        }
+        ss << "\n|--------|-------|";
+        for (size_t k = 0; k < bucket_keys.size(); ++k)
+        {
+            ss << "------|";
+        }
+        ss << "\n";
+        for (const auto &result : results)
+        {
+            if (result.filter_name == "None" || result.reads.empty())
+            {
+                continue;
+            }
+            std::vector<ReadTable::LengthBucket> buckets = result.reads.lengthBuckets();
+            ss << "| " << result.filter_name << " | " << result.compression_level << " |";
+            for (int key : bucket_keys)
+            {
+                auto it = std::find_if(buckets.begin(), buckets.end(),
+                                       [key](const ReadTable::LengthBucket &b)
+                                       { return b.log2_elements == key; });
+                if (it == buckets.end())
+                {
+                    ss << " - |";
+                }
+                else
+                {
+                    ss << " " << std::fixed << std::setprecision(3) << it->ratio() << " |";
+                }
+            }
+            ss << "\n";
+        }
+    }
+
+    // 重复测量的统计摘要
+    bool has_repeats = std::any_of(results.begin(), results.end(),
+                                   [](const CompressionResult &r)
+                                   { return r.compression_stats.samples > 1; });
+    if (has_repeats)
+    {
+        auto stats_cells = [](const TimingStats &t)
+        {
+            std::stringstream cell;
+            cell << std::fixed << std::setprecision(3)
+                 << t.min << " | " << t.median << " | " << t.mean << " | " << t.p95 << " | " << t.stddev
+                 << " | [" << t.ci_low << ", " << t.ci_high << "]";
+            return cell.str();
+        };
+
+        ss << "\n## Timing Statistics (ms)\n\n";
+        ss << "Median confidence intervals are 95% percentile bootstrap intervals.\n\n";
+        ss << "| Filter | Level | Runs | Comp Min | Comp Median | Comp Mean | Comp P95 | Comp Stddev | Comp CI "
+           << "| Decomp Min | Decomp Median | Decomp Mean | Decomp P95 | Decomp Stddev | Decomp CI |\n";
+        ss << "|--------|-------|------|----------|-------------|-----------|----------|-------------|---------"
+           << "|------------|---------------|-------------|------------|---------------|-----------|\n";
+        for (const auto &result : results)
+        {
+            if (result.compression_stats.samples == 0)
+            {
+                continue;
+            }
+            ss << "| " << result.filter_name
+               << " | " << result.compression_level
+               << " | " << result.compression_stats.samples
+               << " | " << stats_cells(result.compression_stats)
+               << " | " << stats_cells(result.decompression_stats)
+               << " |\n";
+        }
+
+        // 置信区间重叠的配置两两列出
+        ss << "\n## Statistically Indistinguishable Configurations\n\n";
+        bool any_overlap = false;
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            for (size_t j = i + 1; j < results.size(); ++j)
+            {
+                const auto &a = results[i];
+                const auto &b = results[j];
+                if (a.compression_stats.samples < 2 || b.compression_stats.samples < 2)
+                {
+                    continue;
+                }
+                bool comp_overlap = Statistics::intervalsOverlap(a.compression_stats, b.compression_stats);
+                bool decomp_overlap = Statistics::intervalsOverlap(a.decompression_stats, b.decompression_stats);
+                if (!comp_overlap && !decomp_overlap)
+                {
+                    continue;
+                }
+                any_overlap = true;
+                ss << "- " << a.filter_name << " L" << a.compression_level
+                   << " vs " << b.filter_name << " L" << b.compression_level << ": ";
+                if (comp_overlap && decomp_overlap)
+                {
+                    ss << "compression and decompression times";
+                }
+                else if (comp_overlap)
+                {
+                    ss << "compression time";
+                }
+                else
+                {
+                    ss << "decompression time";
+                }
+                ss << " statistically indistinguishable\n";
+            }
+        }
+        if (!any_overlap)
+        {
+            ss << "All configurations have non-overlapping confidence intervals.\n";
+        }
+    }
+
+    // 流水线各阶段利用率，利用率最高的阶段即瓶颈
+    bool has_pipeline = std::any_of(results.begin(), results.end(),
+                                    [](const CompressionResult &r)
+                                    { return r.pipeline.wall_ns > 0; });
+    if (has_pipeline)
+    {
+        ss << "\n## Pipeline Utilization\n\n";
+        ss << "Utilization is busy time divided by pipeline wall time (encoder busy time is divided by the thread count).\n\n";
+        ss << "| Filter | Level | Wall (ms) | Reader | Encoders | Writer | Reader Blocked (ms) | Peak In-flight | Bottleneck |\n";
+        ss << "|--------|-------|-----------|--------|----------|--------|---------------------|----------------|------------|\n";
+        for (const auto &result : results)
+        {
+            const PipelineStats &p = result.pipeline;
+            if (p.wall_ns == 0)
+            {
+                continue;
+            }
+            double reader = p.readerUtilization();
+            double encoders = p.encoderUtilization();
+            double writer = p.writerUtilization();
+            std::string bottleneck = "reader";
+            if (encoders >= reader && encoders >= writer)
+            {
+                bottleneck = "encoders";
+            }
+            else if (writer >= reader && writer >= encoders)
+            {
+                bottleneck = "writer";
+            }
+            ss << "| " << result.filter_name
+               << " | " << result.compression_level
+               << std::fixed << std::setprecision(3)
+               << " | " << p.wall_ns / 1.0e6
+               << std::setprecision(1)
+               << " | " << reader * 100 << "%"
+               << " | " << encoders * 100 << "% (x" << p.encoder_threads << ")"
+               << " | " << writer * 100 << "%"
+               << std::setprecision(3)
+               << " | " << p.reader_blocked_ns / 1.0e6
+               << " | " << Utils::formatSize(p.peak_inflight_bytes)
+               << " | " << bottleneck
+               << " |\n";
+        }
+    }
+
+    // 多级过滤器管线每一级的开销
+    bool has_stages = std::any_of(results.begin(), results.end(),
+                                  [](const CompressionResult &r)
+                                  { return !r.stage_costs.empty(); });
+    if (has_stages)
+    {
+        ss << "\n## Filter Pipeline Stages\n\n";
+        ss << "Each stage is encoded separately in-process on the output of the previous stage; "
+           << "stages without an in-process encoder (and the stages after them) cannot be measured.\n\n";
+        ss << "| Pipeline | Parameters | Level | Stage | Input | Output | Stage Ratio | Encode (ms) | Throughput (MB/s) |\n";
+        ss << "|----------|------------|-------|-------|-------|--------|-------------|-------------|-------------------|\n";
+        for (const auto &result : results)
+        {
+            for (const auto &cost : result.stage_costs)
+            {
+                ss << "| " << result.filter_name
+                   << " | " << result.parameters
+                   << " | " << result.compression_level
+                   << " | " << cost.filter_name;
+                if (!cost.measured)
+                {
+                    ss << " | n/a | n/a | n/a | n/a | n/a |\n";
+                    continue;
+                }
+                double seconds = cost.encode_ns / 1.0e9;
+                ss << " | " << Utils::formatSize(cost.input_bytes)
+                   << " | " << Utils::formatSize(cost.output_bytes)
+                   << std::fixed << std::setprecision(2)
+                   << " | " << (cost.output_bytes > 0 ? static_cast<double>(cost.input_bytes) / cost.output_bytes : 0.0)
+                   << std::setprecision(3)
+                   << " | " << cost.encode_ns / 1.0e6
+                   << std::setprecision(2)
+                   << " | " << (seconds > 0 ? cost.input_bytes / (1024.0 * 1024.0) / seconds : 0.0)
+                   << " |\n";
+            }
+        }
+    }
+
+    // 分块自动调优：每个数据集选中的分块大小与调优耗时
+    bool has_tuning = std::any_of(results.begin(), results.end(),
+                                  [](const CompressionResult &r)
+                                  { return !r.tuned_chunks.empty(); });
+    if (has_tuning)
+    {
+        ss << "\n## Chunk Auto-Tuning\n\n";
+        ss << "Each Signal dataset is sampled and written with every candidate chunk size in memory; the size with the "
+           << "best weighted score of compression ratio, encode throughput and random-slice read latency is used. "
+           << "Tuning time is not included in the compression time.\n\n";
+        ss << "| Filter | Parameters | Level | Chosen Chunk Sizes | Tune Time (ms) |\n";
+        ss << "|--------|------------|-------|--------------------|----------------|\n";
+        for (const auto &result : results)
+        {
+            if (result.tuned_chunks.empty())
+            {
+                continue;
+            }
+            ss << "| " << result.filter_name
+               << " | " << result.parameters
+               << " | " << result.compression_level
+               << " | " << chunkLabel(result)
+               << " | " << std::fixed << std::setprecision(3) << result.chunk_tune_ns / 1.0e6
+               << " |\n";
+        }
+    }
+
+    // 按数据集选择过滤器：各候选被选中的数据集数，以及相对统一使用最优单一候选的收益
+    bool has_selection = std::any_of(results.begin(), results.end(),
+                                     [](const CompressionResult &r)
+                                     { return !r.codec_mix.empty(); });
+    if (has_selection)
+    {
+        ss << "\n## Per-Dataset Codec Selection\n\n";
+        ss << "Each Signal dataset is sampled at its start, middle and end and compressed in memory with every "
+           << "candidate pipeline; the smallest output that meets the encode/decode throughput limits is written to "
+           << "that dataset. Gain compares the summed sample output against the best single candidate used for every "
+           << "dataset under the same limits. Selection time is not included in the compression time.\n\n";
+        ss << "| Filter | Level | Codec Mix | Best Single Filter | Gain | Fallbacks | Selection Time (ms) |\n";
+        ss << "|--------|-------|-----------|--------------------|------|-----------|---------------------|\n";
+        for (const auto &result : results)
+        {
+            if (result.codec_mix.empty())
+            {
+                continue;
+            }
+            std::string mix;
+            for (size_t i = 0; i < result.codec_mix.size(); ++i)
+            {
+                mix += (i > 0 ? ", " : "") + result.codec_mix[i].first + " x" + std::to_string(result.codec_mix[i].second);
+            }
+            ss << "| " << result.filter_name
+               << " | " << result.compression_level
+               << " | " << mix
+               << " | " << (result.codec_global_best.empty() ? "-" : result.codec_global_best)
+               << " | ";
+            if (result.codec_global_best.empty())
+            {
+                ss << "-";
+            }
+            else
+            {
+                ss << std::fixed << std::setprecision(2) << (result.codec_gain - 1.0) * 100.0 << "%";
+            }
+            ss << " | " << result.codec_fallbacks
+               << " | " << std::fixed << std::setprecision(3) << result.codec_select_ns / 1.0e6
+               << " |\n";
+        }
+    }
+
+    // 解码吞吐量随线程数的变化
+    bool has_scaling = std::any_of(results.begin(), results.end(),
+                                   [](const CompressionResult &r)
+                                   { return !r.decode_scaling.empty(); });
+    if (has_scaling)
+    {
+        ss << "\n## Decode Scaling (MB/s)\n\n";
+        ss << "Each cell decodes every Signal dataset of the output file once. "
+           << "H5Dread is the single-threaded library path; numbered columns use the parallel chunk decoder.\n\n";
+        std::vector<int> columns;
+        for (const auto &result : results)
+        {
+            for (const auto &point : result.decode_scaling)
+            {
+                if (std::find(columns.begin(), columns.end(), point.first) == columns.end())
+                {
+                    columns.push_back(point.first);
+                }
+            }
+        }
+        std::sort(columns.begin(), columns.end());
+        ss << "| Filter | Level |";
+        for (int threads : columns)
+        {
+            ss << " " << (threads == 0 ? std::string("H5Dread") : std::to_string(threads) + " thr") << " |";
+        }
+        ss << " Speedup |\n|--------|-------|";
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            ss << "------|";
+        }
+        ss << "---------|\n";
+        for (const auto &result : results)
+        {
+            if (result.decode_scaling.empty())
+            {
+                continue;
+            }
+            ss << "| " << result.filter_name << " | " << result.compression_level << " |";
+            double baseline = 0.0;
+            double best = 0.0;
+            for (int threads : columns)
+            {
+                auto it = std::find_if(result.decode_scaling.begin(), result.decode_scaling.end(),
+                                       [threads](const std::pair<int, double> &p)
+                                       { return p.first == threads; });
+                if (it == result.decode_scaling.end())
+                {
+                    ss << " - |";
+                    continue;
+                }
+                ss << " " << std::fixed << std::setprecision(2) << it->second << " |";
+                if (threads == 0)
+                {
+                    baseline = it->second;
+                }
+                best = std::max(best, it->second);
+            }
+            ss << " " << std::fixed << std::setprecision(2) << (baseline > 0.0 ? best / baseline : 0.0) << "x |\n";
+        }
+    }
+
+    // 解压校验失败的配置单独列出
+    bool has_failures = std::any_of(results.begin(), results.end(),
+                                    [](const CompressionResult &r)
+                                    { return r.verification_failures > 0; });
+    if (has_failures)
+    {
+        ss << "\n## Verification Failures\n\n";
+        for (const auto &result : results)
+        {
+            if (result.verification_failures > 0)
+            {
+                ss << "- **" << result.filter_name << "** level " << result.compression_level
+                   << ": " << result.verification_failures << " of " << result.verified_datasets
+                   << " Signal datasets did not decode to the source data\n";
+            }
+        }
+    }
+
+    // 未能完成的配置（失败、崩溃或超时）单独列出，且不参与分析
+    bool has_errors = std::any_of(results.begin(), results.end(),
+                                  [](const CompressionResult &r)
+                                  { return !r.error.empty(); });
+    if (has_errors)
+    {
+        ss << "\n## Failed Configurations\n\n";
+        for (const auto &result : results)
+        {
+            if (!result.error.empty())
+            {
+                ss << "- **" << result.filter_name << "** level " << result.compression_level
+                   << ": " << result.error << "\n";
+            }
+        }
+    }
+
+    std::vector<CompressionResult> completed;
+    std::copy_if(results.begin(), results.end(), std::back_inserter(completed),
+                 [](const CompressionResult &r)
+                 { return r.error.empty(); });
+
+    // 分析部分
+    ss << "\n## Analysis\n\n";
+
+    // 声明变量
+    std::vector<CompressionResult>::const_iterator max_ratio, min_time;
+    bool has_results = !completed.empty();
+    ParetoFrontier frontier(results, requirements_);
+    int recommended = frontier.recommended();
+
+    if (has_results)
+    {
+        // 找到最佳压缩比
+        max_ratio = std::max_element(completed.begin(), completed.end(),
+                                     [](const CompressionResult &a, const CompressionResult &b)
+                                     {
+                                         return a.compression_ratio < b.compression_ratio;
+                                     });
+
+        // 找到最快压缩
+        min_time = std::min_element(completed.begin(), completed.end(),
+                                    [](const CompressionResult &a, const CompressionResult &b)
+                                    {
+                                        return a.compression_time_ms < b.compression_time_ms;
+                                    });
+
+        ss << "### Best Compression Ratio\n";
+        ss << "- **Filter**: " << max_ratio->filter_name << "\n";
+        ss << "- **Level**: " << max_ratio->compression_level << "\n";
         ss << "- **Ratio**: " << std::fixed << std::setprecision(2) << max_ratio->compression_ratio << "\n";
         ss << "- **Time**: " << max_ratio->compression_time_ms << " ms\n\n";
 
@@ -295,14 +1761,62 @@ std::string CompressionTester::generateMarkdownReport(const std::vector<Compress
         ss << "- **Ratio**: " << std::fixed << std::setprecision(2) << min_time->compression_ratio << "\n";
         ss << "- **Time**: " << min_time->compression_time_ms << " ms\n\n";
 
-        ss << "### Best Balance (Ratio/Time)\n";
-        ss << "- **Filter**: " << best_balance->filter_name << "\n";
-        ss << "- **Level**: " << best_balance->compression_level << "\n";
-        ss << "- **Ratio**: " << std::fixed << std::setprecision(2) << best_balance->compression_ratio << "\n";
-        ss << "- **Time**: " << best_balance->compression_time_ms << " ms\n";
+        // 压缩比、编码吞吐量、解码吞吐量、峰值内存上的 Pareto 前沿
+        ss << "### Pareto Frontier\n\n";
+        ss << "Objectives: maximize ratio, encode MB/s and decode MB/s, minimize peak memory. A configuration is "
+           << "dominated when another one is at least as good on every objective and better on one "
+           << "(peak memory is compared at 1 MiB resolution). "
+           << "The uncompressed baseline, failed and unverified configurations are excluded.\n\n";
+        ss << "| Filter | Parameters | Level | Chunk | Ratio | Encode MB/s | Decode MB/s | Peak Mem | Requirements | Status |\n";
+        ss << "|--------|------------|-------|-------|-------|-------------|-------------|----------|--------------|--------|\n";
+        for (const auto &point : frontier.points())
+        {
+            const CompressionResult &result = results[point.index];
+            ss << "| " << result.filter_name
+               << " | " << result.parameters
+               << " | " << result.compression_level
+               << " | " << chunkLabel(result)
+               << " | " << std::fixed << std::setprecision(2) << result.compression_ratio
+               << " | " << result.compression_mbps
+               << " | " << result.decompression_mbps
+               << " | " << (result.peak_memory_bytes > 0 ? Utils::formatSize(result.peak_memory_bytes) : "-")
+               << " | " << (frontier.constraints().empty() ? "-" : (point.feasible ? "met" : "not met"))
+               << " | ";
+            if (point.on_frontier)
+            {
+                ss << "**frontier**";
+            }
+            else if (point.dominated_by >= 0)
+            {
+                const CompressionResult &by = results[point.dominated_by];
+                ss << "dominated by " << by.filter_name << " level " << by.compression_level;
+            }
+            ss << (static_cast<int>(point.index) == recommended ? " (recommended)" : "") << " |\n";
+        }
 
-        double balance_score = best_balance->compression_ratio / (best_balance->compression_time_ms + 1.0);
-        ss << "- **Score**: " << std::fixed << std::setprecision(4) << balance_score << " ratio/ms\n";
+        ss << "\n### Recommendation\n";
+        if (!frontier.constraints().empty())
+        {
+            ss << "- **Requirements**:";
+            for (const auto &constraint : frontier.constraints())
+            {
+                ss << " `" << constraint.text << "`";
+            }
+            ss << "\n";
+        }
+        if (recommended >= 0)
+        {
+            const CompressionResult &best = results[recommended];
+            ss << "- **Filter**: " << best.filter_name << (best.parameters.empty() ? "" : " (" + best.parameters + ")") << "\n";
+            ss << "- **Level**: " << best.compression_level << "\n";
+            ss << "- **Chunk**: " << chunkLabel(best) << "\n";
+            ss << "- **Ratio**: " << std::fixed << std::setprecision(2) << best.compression_ratio << "\n";
+            ss << "- **Encode**: " << best.compression_mbps << " MB/s, **Decode**: " << best.decompression_mbps << " MB/s\n";
+        }
+        else
+        {
+            ss << "- No configuration satisfies the requirements.\n";
+        }
     }
     else
     {
@@ -318,10 +1832,199 @@ std::string CompressionTester::generateMarkdownReport(const std::vector<Compress
     ss << "2. **For fastest compression**: Use "
        << (has_results ? min_time->filter_name + " level " + std::to_string(min_time->compression_level) : "LZ4 level 1")
        << "\n";
-    ss << "3. **For best balance**: Use "
-       << (has_results ? best_balance->filter_name + " level " + std::to_string(best_balance->compression_level) : "GZIP level 6")
-       << "\n";
+    if (requirements_.empty())
+    {
+        ss << "3. **For other trade-offs**: Pick from the Pareto frontier:";
+        bool first = true;
+        for (const auto &point : frontier.points())
+        {
+            if (point.on_frontier)
+            {
+                ss << (first ? " " : ", ") << results[point.index].filter_name << " level "
+                   << results[point.index].compression_level;
+                first = false;
+            }
+        }
+        ss << (first ? " none" : "") << "\n";
+    }
+    else
+    {
+        ss << "3. **Under the requirements**: Use "
+           << (recommended >= 0 ? results[recommended].filter_name + " level " + std::to_string(results[recommended].compression_level)
+                                : std::string("none (no configuration qualifies)"))
+           << "\n";
+    }
+
+    return ss.str();
+}
+
+// Pareto 分析中的状态："frontier"、"dominated"，不参与分析时为 "excluded"；dominated_by 为支配它的前沿配置
+static std::string paretoStatus(const ParetoFrontier &frontier, const std::vector<CompressionResult> &results,
+                                size_t index, std::string &dominated_by)
+{
+    dominated_by.clear();
+    const ParetoFrontier::Point *point = frontier.find(index);
+    if (point == nullptr)
+    {
+        return "excluded";
+    }
+    if (point->dominated_by >= 0)
+    {
+        const CompressionResult &by = results[point->dominated_by];
+        dominated_by = by.filter_name + " level " + std::to_string(by.compression_level);
+    }
+    return point->on_frontier ? "frontier" : "dominated";
+}
+
+// 统计摘要的 CSV 字段（每个字段后带逗号）
+static std::string csvStats(const TimingStats &t)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(4)
+       << t.min << "," << t.median << "," << t.mean << "," << t.p95 << ","
+       << t.stddev << "," << t.ci_low << "," << t.ci_high << ",";
+    return ss.str();
+}
+
+// 计数器的 CSV 字段（每 MB，不可用为 -1；每个字段后带逗号）
+static std::string csvCounterHeader(const std::string &prefix)
+{
+    std::string header;
+    for (const char *name : {"cpu_ms_per_mb", "cycles_per_mb", "instructions_per_mb", "ipc", "llc_misses_per_mb",
+                             "llc_mpki", "branch_misses_per_mb", "context_switches_per_mb"})
+    {
+        header += prefix + "_" + name + ",";
+    }
+    return header;
+}
+
+static std::string csvCounters(const CounterSample &c)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(4)
+       << (c.collected() ? c.perMb(c.task_clock_ns) / 1.0e6 : -1.0) << ","
+       << c.perMb(c.cycles) << ","
+       << c.perMb(c.instructions) << ","
+       << (c.cycles > 0 && c.instructions >= 0 ? c.ipc() : -1.0) << ","
+       << c.perMb(c.llc_misses) << ","
+       << c.llcMpki() << ","
+       << c.perMb(c.branch_misses) << ","
+       << (c.collected() ? c.perMb(c.context_switches) : -1.0) << ",";
+    return ss.str();
+}
+
+// vfd_* 列
+static std::string csvIo(const CompressionResult &result)
+{
+    IoOpStats writes = result.destination_io.total(IoStats::kWrite);
+    const IoOpStats &meta_writes = result.destination_io.at(IoStats::kMetadata, IoStats::kWrite);
+    IoOpStats src_reads = result.source_io.total(IoStats::kRead);
+    IoOpStats decode_reads = result.decode_io.total(IoStats::kRead);
+    std::stringstream ss;
+    ss << writes.calls << "," << writes.bytes << "," << meta_writes.calls << "," << meta_writes.bytes << ","
+       << writes.small() << "," << writes.unaligned << "," << writes.ns << ","
+       << std::fixed << std::setprecision(4) << ioAmplification(result) << ","
+       << src_reads.calls << "," << src_reads.bytes << ","
+       << decode_reads.calls << "," << decode_reads.bytes << ",";
+    return ss.str();
+}
 
+// 各存储层的模型吞吐量，例如 "nvme:812.3/1540.2;hdd:95.1/160.4"（写入/恢复 MB/s）
+static std::string csvStorageTiers(const CompressionResult &result, const StorageProfile &throttle)
+{
+    std::stringstream ss;
+    for (const auto &tier : storageTiers(throttle))
+    {
+        double ingest_mbps = 0.0;
+        double restore_mbps = 0.0;
+        if (tierThroughput(result, tier, ingest_mbps, restore_mbps))
+        {
+            ss << tier.name << ":" << std::fixed << std::setprecision(2) << ingest_mbps << "/" << restore_mbps << ";";
+        }
+    }
+    return ss.str();
+}
+
+// 解码扩展曲线的 CSV 字段："线程数:MB/s" 以分号分隔
+static std::string csvScaling(const std::vector<std::pair<int, double>> &scaling)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < scaling.size(); ++i)
+    {
+        ss << (i > 0 ? ";" : "") << scaling[i].first << ":" << scaling[i].second;
+    }
+    return ss.str();
+}
+
+// 管线各级开销的 CSV 字段："过滤器:输入字节:输出字节:编码纳秒" 以分号分隔，未测量的级只有过滤器名
+static std::string csvStageCosts(const std::vector<StageCost> &costs)
+{
+    std::stringstream ss;
+    for (size_t i = 0; i < costs.size(); ++i)
+    {
+        ss << (i > 0 ? ";" : "") << costs[i].filter_name;
+        if (costs[i].measured)
+        {
+            ss << ":" << costs[i].input_bytes << ":" << costs[i].output_bytes << ":" << costs[i].encode_ns;
+        }
+    }
+    return ss.str();
+}
+
+// 存储类别的 CSV 字段："类别:数据集数:原始字节数:存储字节数" 以分号分隔（类别名本身可能含冒号，数值取最后三段）
+static std::string csvStorageClasses(const std::vector<StorageClass> &classes)
+{
+    std::stringstream ss;
+    bool first = true;
+    for (const auto &entry : classes)
+    {
+        if (entry.datasets == 0)
+        {
+            continue;
+        }
+        ss << (first ? "" : ";") << entry.name << ":" << entry.datasets << ":" << entry.raw_bytes << ":"
+           << entry.stored_bytes;
+        first = false;
+    }
+    return ss.str();
+}
+
+// 自动调优选中分块的 CSV 字段："分块元素数:数据集数" 以分号分隔
+static std::string csvTunedChunks(const std::vector<std::pair<size_t, size_t>> &tuned)
+{
+    std::stringstream ss;
+    for (size_t i = 0; i < tuned.size(); ++i)
+    {
+        ss << (i > 0 ? ";" : "") << tuned[i].first << ":" << tuned[i].second;
+    }
+    return ss.str();
+}
+
+// 按数据集选择的 CSV 字段："候选:数据集数" 以分号分隔
+static std::string csvCodecMix(const std::vector<std::pair<std::string, size_t>> &mix)
+{
+    std::stringstream ss;
+    for (size_t i = 0; i < mix.size(); ++i)
+    {
+        ss << (i > 0 ? ";" : "") << mix[i].first << ":" << mix[i].second;
+    }
+    return ss.str();
+}
+
+// 统计摘要的 JSON 对象
+static std::string jsonStats(const TimingStats &t)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(4)
+       << "{\"samples\": " << t.samples
+       << ", \"min\": " << t.min
+       << ", \"median\": " << t.median
+       << ", \"mean\": " << t.mean
+       << ", \"p95\": " << t.p95
+       << ", \"stddev\": " << t.stddev
+       << ", \"ci_low\": " << t.ci_low
+       << ", \"ci_high\": " << t.ci_high << "}";
     return ss.str();
 }
 
@@ -331,25 +2034,187 @@ std::string CompressionTester::generateCSVReport(const std::vector<CompressionRe
 
     // CSV头部
     ss << "filter_name,parameters,compression_level,compression_ratio,"
-       << "compression_time_ms,decompression_time_ms,"
-       << "compressed_size_bytes,original_size_bytes\n";
+       << "compression_time_ms,decompression_time_ms,decompression_mbps,"
+       << "verified_datasets,verification_failures,"
+       << "source_open_ns,metadata_copy_ns,source_read_ns,dataset_create_ns,encode_write_ns,flush_close_ns,"
+       << "runs,comp_min_ms,comp_median_ms,comp_mean_ms,comp_p95_ms,comp_stddev_ms,comp_ci_low_ms,comp_ci_high_ms,"
+       << "decomp_min_ms,decomp_median_ms,decomp_mean_ms,decomp_p95_ms,decomp_stddev_ms,decomp_ci_low_ms,decomp_ci_high_ms,"
+       << "compressed_size_bytes,original_size_bytes,in_memory,encode_threads,direct_chunks,"
+       << "decode_threads,decode_scaling_mbps,"
+       << "pipeline_wall_ns,pipeline_reader_busy_ns,pipeline_encoder_busy_ns,pipeline_writer_busy_ns,"
+       << "pipeline_reader_blocked_ns,pipeline_peak_inflight_bytes,stage_costs,"
+       << "chunk_size,tuned_chunks,chunk_tune_ns,slice_read_us,"
+       << "codec_mix,codec_global_best,codec_gain,codec_fallbacks,codec_select_ns,estimated_ratio,"
+       << "compression_mbps,peak_memory_bytes,pareto,dominated_by,meets_requirements,recommended,"
+       << "counters_source," << csvCounterHeader("enc") << csvCounterHeader("dec")
+       << "signal_bytes,user_s,sys_s,cpu_s_per_gb,max_rss_bytes,minor_faults,major_faults,"
+       << "voluntary_switches,involuntary_switches,io_rchar,io_wchar,io_read_bytes,io_write_bytes,"
+       << "vfd_dst_writes,vfd_dst_write_bytes,vfd_dst_meta_writes,vfd_dst_meta_write_bytes,vfd_dst_small_writes,"
+       << "vfd_dst_unaligned_writes,vfd_dst_write_ns,vfd_amplification,vfd_src_reads,vfd_src_read_bytes,"
+       << "vfd_decode_reads,vfd_decode_read_bytes,storage_tiers,"
+       << "input_file_bytes,output_file_bytes,file_ratio,storage_classes,error\n";
 
     // 数据行
-    for (const auto &result : results)
+    ParetoFrontier frontier(results, requirements_);
+    std::string dominated_by;
+    for (size_t i = 0; i < results.size(); ++i)
     {
+        const CompressionResult &result = results[i];
+        const ParetoFrontier::Point *point = frontier.find(i);
         ss << result.filter_name << ","
            << "\"" << result.parameters << "\","
            << result.compression_level << ","
            << std::fixed << std::setprecision(4) << result.compression_ratio << ","
            << result.compression_time_ms << ","
            << result.decompression_time_ms << ","
+           << std::fixed << std::setprecision(4) << result.decompression_mbps << ","
+           << result.verified_datasets << ","
+           << result.verification_failures << ","
+           << result.phases.source_open_ns << ","
+           << result.phases.metadata_copy_ns << ","
+           << result.phases.source_read_ns << ","
+           << result.phases.dataset_create_ns << ","
+           << result.phases.encode_write_ns << ","
+           << result.phases.flush_close_ns << ","
+           << result.compression_stats.samples << ","
+           << csvStats(result.compression_stats)
+           << csvStats(result.decompression_stats)
            << result.compressed_size_bytes << ","
-           << result.original_size_bytes << "\n";
+           << result.original_size_bytes << ","
+           << (result.in_memory ? 1 : 0) << ","
+           << result.encode_threads << ","
+           << result.direct_chunks << ","
+           << result.decode_threads << ","
+           << "\"" << csvScaling(result.decode_scaling) << "\","
+           << result.pipeline.wall_ns << ","
+           << result.pipeline.reader_busy_ns << ","
+           << result.pipeline.encoder_busy_ns << ","
+           << result.pipeline.writer_busy_ns << ","
+           << result.pipeline.reader_blocked_ns << ","
+           << result.pipeline.peak_inflight_bytes << ","
+           << "\"" << csvStageCosts(result.stage_costs) << "\","
+           << ChunkTuner::formatChunkSize(result.chunk_elements) << ","
+           << "\"" << csvTunedChunks(result.tuned_chunks) << "\","
+           << result.chunk_tune_ns << ","
+           << std::fixed << std::setprecision(2) << result.slice_read_us << ","
+           << "\"" << csvCodecMix(result.codec_mix) << "\","
+           << "\"" << result.codec_global_best << "\","
+           << std::fixed << std::setprecision(4) << result.codec_gain << ","
+           << result.codec_fallbacks << ","
+           << result.codec_select_ns << ","
+           << std::fixed << std::setprecision(4) << result.estimated_ratio << ","
+           << result.compression_mbps << ","
+           << result.peak_memory_bytes << ","
+           << paretoStatus(frontier, results, i, dominated_by) << ","
+           << "\"" << dominated_by << "\","
+           << (point != nullptr && point->feasible ? 1 : 0) << ","
+           << (static_cast<int>(i) == frontier.recommended() ? 1 : 0) << ","
+           << result.encode_counters.source << ","
+           << csvCounters(result.encode_counters) << csvCounters(result.decode_counters)
+           << result.signal_bytes << ","
+           << result.resources.user_seconds << ","
+           << result.resources.system_seconds << ","
+           << result.resources.cpuSecondsPerGb(result.signal_bytes) << ","
+           << result.resources.max_rss_bytes << ","
+           << result.resources.minor_faults << ","
+           << result.resources.major_faults << ","
+           << result.resources.voluntary_switches << ","
+           << result.resources.involuntary_switches << ","
+           << result.resources.io_rchar << ","
+           << result.resources.io_wchar << ","
+           << result.resources.io_read_bytes << ","
+           << result.resources.io_write_bytes << ","
+           << csvIo(result)
+           << "\"" << csvStorageTiers(result, throttle_) << "\","
+           << result.input_file_bytes << ","
+           << result.output_file_bytes << ","
+           << std::fixed << std::setprecision(4) << result.file_ratio << ","
+           << "\"" << csvStorageClasses(result.storage_classes) << "\","
+           << "\"" << result.error << "\"\n";
     }
 
     return ss.str();
 }
 
+std::string CompressionTester::generateReadTableCSV(const std::vector<CompressionResult> &results)
+{
+    std::stringstream ss;
+    ss << "filter_name,parameters,compression_level,chunk_size,path,samples,"
+       << "original_bytes,compressed_bytes,ratio,encode_ns,decode_ns\n";
+    for (const auto &result : results)
+    {
+        const ReadTable &reads = result.reads;
+        for (size_t row = 0; row < reads.size(); ++row)
+        {
+            ss << result.filter_name << ","
+               << "\"" << result.parameters << "\","
+               << result.compression_level << ","
+               << ChunkTuner::formatChunkSize(result.chunk_elements) << ","
+               << "\"" << reads.paths[row] << "\","
+               << reads.elements[row] << ","
+               << reads.original_bytes[row] << ","
+               << reads.compressed_bytes[row] << ","
+               << std::fixed << std::setprecision(4) << reads.ratio(row) << ","
+               << reads.encode_ns[row] << ","
+               << reads.decode_ns[row] << "\n";
+        }
+    }
+    return ss.str();
+}
+
+// 数值列，例如 [1, 2, 3]
+template <typename T>
+static std::string jsonColumn(const std::vector<T> &values)
+{
+    std::stringstream ss;
+    ss << "[";
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        ss << (i > 0 ? ", " : "") << values[i];
+    }
+    ss << "]";
+    return ss.str();
+}
+
+// 一个文件的 VFD 统计：元数据/原始数据 × 读/写
+static std::string jsonIo(const IoStats &io)
+{
+    static const char *names[2][2] = {{"metadata_read", "metadata_write"}, {"raw_read", "raw_write"}};
+    std::stringstream ss;
+    ss << "{";
+    for (int a = 0; a < 2; ++a)
+    {
+        for (int d = 0; d < 2; ++d)
+        {
+            const IoOpStats &op = io.ops[a][d];
+            ss << (a + d > 0 ? ", " : "") << "\"" << names[a][d] << "\": {\"calls\": " << op.calls
+               << ", \"bytes\": " << op.bytes << ", \"ns\": " << op.ns << ", \"max_ns\": " << op.max_ns
+               << ", \"unaligned\": " << op.unaligned << ", \"size_hist\": [";
+            for (int b = 0; b < IoOpStats::kSizeBuckets; ++b)
+            {
+                ss << (b > 0 ? ", " : "") << op.size_hist[b];
+            }
+            ss << "]}";
+        }
+    }
+    ss << "}";
+    return ss.str();
+}
+
+// 一个阶段的原始计数（不可用为 -1）与处理字节数
+static std::string jsonCounters(const CounterSample &c)
+{
+    std::stringstream ss;
+    ss << "{\"cycles\": " << c.cycles
+       << ", \"instructions\": " << c.instructions
+       << ", \"llc_misses\": " << c.llc_misses
+       << ", \"branch_misses\": " << c.branch_misses
+       << ", \"context_switches\": " << c.context_switches
+       << ", \"task_clock_ns\": " << c.task_clock_ns
+       << ", \"bytes\": " << c.bytes << "}";
+    return ss.str();
+}
+
 std::string CompressionTester::generateJSONReport(const std::vector<CompressionResult> &results)
 {
     std::stringstream ss;
@@ -364,6 +2229,8 @@ std::string CompressionTester::generateJSONReport(const std::vector<CompressionR
     ss << "    },\n";
     ss << "    \"results\": [\n";
 
+    ParetoFrontier frontier(results, requirements_);
+    std::string dominated_by;
     for (size_t i = 0; i < results.size(); ++i)
     {
         const auto &result = results[i];
@@ -374,8 +2241,138 @@ std::string CompressionTester::generateJSONReport(const std::vector<CompressionR
         ss << "        \"compression_ratio\": " << std::fixed << std::setprecision(4) << result.compression_ratio << ",\n";
         ss << "        \"compression_time_ms\": " << result.compression_time_ms << ",\n";
         ss << "        \"decompression_time_ms\": " << result.decompression_time_ms << ",\n";
+        ss << "        \"decompression_mbps\": " << std::fixed << std::setprecision(4) << result.decompression_mbps << ",\n";
+        ss << "        \"verified_datasets\": " << result.verified_datasets << ",\n";
+        ss << "        \"verification_failures\": " << result.verification_failures << ",\n";
+        ss << "        \"phases_ns\": {\n";
+        ss << "          \"source_open\": " << result.phases.source_open_ns << ",\n";
+        ss << "          \"metadata_copy\": " << result.phases.metadata_copy_ns << ",\n";
+        ss << "          \"source_read\": " << result.phases.source_read_ns << ",\n";
+        ss << "          \"dataset_create\": " << result.phases.dataset_create_ns << ",\n";
+        ss << "          \"encode_write\": " << result.phases.encode_write_ns << ",\n";
+        ss << "          \"flush_close\": " << result.phases.flush_close_ns << "\n";
+        ss << "        },\n";
+        ss << "        \"compression_stats_ms\": " << jsonStats(result.compression_stats) << ",\n";
+        ss << "        \"decompression_stats_ms\": " << jsonStats(result.decompression_stats) << ",\n";
         ss << "        \"compressed_size_bytes\": " << result.compressed_size_bytes << ",\n";
-        ss << "        \"original_size_bytes\": " << result.original_size_bytes << "\n";
+        ss << "        \"original_size_bytes\": " << result.original_size_bytes << ",\n";
+        ss << "        \"in_memory\": " << (result.in_memory ? "true" : "false") << ",\n";
+        ss << "        \"encode_threads\": " << result.encode_threads << ",\n";
+        ss << "        \"direct_chunks\": " << result.direct_chunks << ",\n";
+        ss << "        \"decode_threads\": " << result.decode_threads << ",\n";
+        ss << "        \"decode_scaling_mbps\": [";
+        for (size_t j = 0; j < result.decode_scaling.size(); ++j)
+        {
+            ss << (j > 0 ? ", " : "") << "{\"threads\": " << result.decode_scaling[j].first
+               << ", \"mbps\": " << std::fixed << std::setprecision(4) << result.decode_scaling[j].second << "}";
+        }
+        ss << "],\n";
+        ss << "        \"chunk_size\": \"" << ChunkTuner::formatChunkSize(result.chunk_elements) << "\",\n";
+        ss << "        \"tuned_chunks\": [";
+        for (size_t c = 0; c < result.tuned_chunks.size(); ++c)
+        {
+            ss << (c > 0 ? ", " : "") << "{\"chunk_elements\": " << result.tuned_chunks[c].first
+               << ", \"datasets\": " << result.tuned_chunks[c].second << "}";
+        }
+        ss << "],\n";
+        ss << "        \"chunk_tune_ns\": " << result.chunk_tune_ns << ",\n";
+        ss << "        \"slice_read_us\": " << std::fixed << std::setprecision(2) << result.slice_read_us << ",\n";
+        ss << "        \"codec_mix\": [";
+        for (size_t c = 0; c < result.codec_mix.size(); ++c)
+        {
+            ss << (c > 0 ? ", " : "") << "{\"filter\": \"" << result.codec_mix[c].first
+               << "\", \"datasets\": " << result.codec_mix[c].second << "}";
+        }
+        ss << "],\n";
+        ss << "        \"codec_global_best\": \"" << result.codec_global_best << "\",\n";
+        ss << "        \"codec_gain\": " << std::fixed << std::setprecision(4) << result.codec_gain << ",\n";
+        ss << "        \"codec_fallbacks\": " << result.codec_fallbacks << ",\n";
+        ss << "        \"codec_select_ns\": " << result.codec_select_ns << ",\n";
+        ss << "        \"estimated_ratio\": " << std::fixed << std::setprecision(4) << result.estimated_ratio << ",\n";
+        ss << "        \"compression_mbps\": " << std::fixed << std::setprecision(4) << result.compression_mbps << ",\n";
+        ss << "        \"peak_memory_bytes\": " << result.peak_memory_bytes << ",\n";
+        std::string status = paretoStatus(frontier, results, i, dominated_by);
+        const ParetoFrontier::Point *point = frontier.find(i);
+        ss << "        \"pareto\": {\"status\": \"" << status << "\", \"dominated_by\": \"" << dominated_by
+           << "\", \"meets_requirements\": " << (point != nullptr && point->feasible ? "true" : "false")
+           << ", \"recommended\": " << (static_cast<int>(i) == frontier.recommended() ? "true" : "false") << "},\n";
+        ss << "        \"stage_costs\": [";
+        for (size_t s = 0; s < result.stage_costs.size(); ++s)
+        {
+            const StageCost &cost = result.stage_costs[s];
+            ss << (s > 0 ? ", " : "")
+               << "{\"filter\": \"" << cost.filter_name << "\""
+               << ", \"measured\": " << (cost.measured ? "true" : "false")
+               << ", \"input_bytes\": " << cost.input_bytes
+               << ", \"output_bytes\": " << cost.output_bytes
+               << ", \"encode_ns\": " << cost.encode_ns << "}";
+        }
+        ss << "],\n";
+        const ResourceUsage &u = result.resources;
+        ss << "        \"signal_bytes\": " << result.signal_bytes << ",\n";
+        ss << "        \"resources\": {\"user_s\": " << std::fixed << std::setprecision(6) << u.user_seconds
+           << ", \"sys_s\": " << u.system_seconds
+           << ", \"cpu_s_per_gb\": " << u.cpuSecondsPerGb(result.signal_bytes)
+           << ", \"max_rss_bytes\": " << u.max_rss_bytes
+           << ", \"minor_faults\": " << u.minor_faults
+           << ", \"major_faults\": " << u.major_faults
+           << ", \"voluntary_switches\": " << u.voluntary_switches
+           << ", \"involuntary_switches\": " << u.involuntary_switches
+           << ", \"io_rchar\": " << u.io_rchar
+           << ", \"io_wchar\": " << u.io_wchar
+           << ", \"io_read_bytes\": " << u.io_read_bytes
+           << ", \"io_write_bytes\": " << u.io_write_bytes << "},\n";
+        ss << "        \"counters\": {\"source\": \"" << result.encode_counters.source << "\", \"encode\": "
+           << jsonCounters(result.encode_counters) << ", \"decode\": " << jsonCounters(result.decode_counters) << "},\n";
+        ss << "        \"io\": {\"amplification\": " << std::fixed << std::setprecision(4) << ioAmplification(result)
+           << ", \"source\": " << jsonIo(result.source_io)
+           << ", \"destination\": " << jsonIo(result.destination_io)
+           << ", \"decode\": " << jsonIo(result.decode_io) << "},\n";
+        ss << "        \"file\": {\"input_bytes\": " << result.input_file_bytes
+           << ", \"output_bytes\": " << result.output_file_bytes
+           << ", \"ratio\": " << std::fixed << std::setprecision(4) << result.file_ratio << "},\n";
+        ss << "        \"storage_classes\": [";
+        for (size_t c = 0; c < result.storage_classes.size(); ++c)
+        {
+            const StorageClass &entry = result.storage_classes[c];
+            ss << (c > 0 ? ", " : "") << "{\"class\": \"" << entry.name << "\", \"datasets\": " << entry.datasets
+               << ", \"raw_bytes\": " << entry.raw_bytes << ", \"stored_bytes\": " << entry.stored_bytes << "}";
+        }
+        ss << "],\n";
+        ss << "        \"storage_tiers\": [";
+        bool first_tier = true;
+        for (const auto &tier : storageTiers(throttle_))
+        {
+            double ingest_mbps = 0.0;
+            double restore_mbps = 0.0;
+            if (tierThroughput(result, tier, ingest_mbps, restore_mbps))
+            {
+                ss << (first_tier ? "" : ", ") << "{\"tier\": \"" << tier.name << "\", \"ingest_mbps\": "
+                   << std::fixed << std::setprecision(4) << ingest_mbps << ", \"restore_mbps\": " << restore_mbps << "}";
+                first_tier = false;
+            }
+        }
+        ss << "],\n";
+        const ReadTable &reads = result.reads;
+        ss << "        \"reads\": {\"paths\": [";
+        for (size_t row = 0; row < reads.size(); ++row)
+        {
+            ss << (row > 0 ? ", " : "") << "\"" << reads.paths[row] << "\"";
+        }
+        ss << "], \"samples\": " << jsonColumn(reads.elements)
+           << ", \"original_bytes\": " << jsonColumn(reads.original_bytes)
+           << ", \"compressed_bytes\": " << jsonColumn(reads.compressed_bytes)
+           << ", \"encode_ns\": " << jsonColumn(reads.encode_ns)
+           << ", \"decode_ns\": " << jsonColumn(reads.decode_ns) << "},\n";
+        ss << "        \"pipeline\": {\"wall_ns\": " << result.pipeline.wall_ns
+           << ", \"reader_busy_ns\": " << result.pipeline.reader_busy_ns
+           << ", \"encoder_busy_ns\": " << result.pipeline.encoder_busy_ns
+           << ", \"writer_busy_ns\": " << result.pipeline.writer_busy_ns
+           << ", \"reader_blocked_ns\": " << result.pipeline.reader_blocked_ns
+           << ", \"encoder_threads\": " << result.pipeline.encoder_threads
+           << ", \"items\": " << result.pipeline.chunks
+           << ", \"peak_inflight_bytes\": " << result.pipeline.peak_inflight_bytes << "},\n";
+        ss << "        \"error\": \"" << result.error << "\"\n";
         ss << "      }";
 
         if (i < results.size() - 1)
@@ -385,7 +2382,42 @@ std::string CompressionTester::generateJSONReport(const std::vector<CompressionR
         ss << "\n";
     }
 
-    ss << "    ]\n";
+    ss << "    ],\n";
+    ss << "    \"pruned\": [";
+    for (size_t i = 0; i < pruned_.size(); ++i)
+    {
+        const PrunedConfig &config = pruned_[i];
+        ss << (i > 0 ? "," : "") << "\n      {\"filter_name\": \"" << config.filter_name
+           << "\", \"parameters\": \"" << config.parameters
+           << "\", \"compression_level\": " << config.level
+           << ", \"chunk_size\": \"" << ChunkTuner::formatChunkSize(config.chunk_elements)
+           << "\", \"estimated_ratio\": " << std::fixed << std::setprecision(4) << config.estimated_ratio
+           << ", \"reason\": \"" << config.reason << "\"}";
+    }
+    ss << (pruned_.empty() ? "],\n" : "\n    ],\n");
+
+    // Pareto 前沿：目标、约束、前沿配置与推荐配置（results 中的下标）
+    ss << "    \"pareto\": {\n";
+    ss << "      \"objectives\": [\"max ratio\", \"max encode_mbps\", \"max decode_mbps\", \"min peak_mem_mb\"],\n";
+    ss << "      \"requirements\": [";
+    for (size_t i = 0; i < frontier.constraints().size(); ++i)
+    {
+        ss << (i > 0 ? ", " : "") << "\"" << frontier.constraints()[i].text << "\"";
+    }
+    ss << "],\n";
+    ss << "      \"frontier\": [";
+    bool first = true;
+    for (const auto &point : frontier.points())
+    {
+        if (point.on_frontier)
+        {
+            ss << (first ? "" : ", ") << point.index;
+            first = false;
+        }
+    }
+    ss << "],\n";
+    ss << "      \"recommended\": " << frontier.recommended() << "\n";
+    ss << "    }\n";
     ss << "  }\n";
     ss << "}\n";
 
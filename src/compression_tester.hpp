@@ -4,7 +4,11 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 #include "hdf5_processor.hpp"
+#include "signal_arena.hpp"
+#include "compressibility_estimator.hpp"
+#include "pareto_frontier.hpp"
 
 class CompressionTester
 {
@@ -21,6 +25,45 @@ public:
         bool test_all_levels = true;
         bool include_shuffle = true;
         bool verbose = false;
+        bool in_memory = false;  // 目标文件只在内存中创建（core VFD）
+        bool dump_image = false; // in_memory 模式下是否把文件映像写到results目录
+        int repeat = 1;          // 每个配置计入统计的运行次数
+        int warmup = 0;          // 每个配置在计时前丢弃的预热次数
+        bool use_arena = true;   // 预先把全部 Signal 解码到内存区，所有配置从内存区写出
+        bool mmap_source = true; // 连续、未压缩的 Signal 直接映射源文件，不复制
+        bool inventory_cache = true; // 对象清单读写输入文件旁的 .inventory 旁路文件
+        bool metadata_skeleton = true; // Signal 以外的元数据只复制一次，输出文件从骨架开始
+        int jobs = 1;            // 并行运行配置的工作进程数，1 表示在当前进程中顺序运行
+        int job_timeout = 0;     // 单个配置的超时时间（秒），0 表示不限制；仅在 jobs > 1 时生效
+        int encode_threads = 0;  // 分块直写的编码线程数，0 表示使用 HDF5 过滤器管线
+        int decode_threads = 0;  // 分块并行解码线程数（源数据加载与解压校验），0 表示使用 H5Dread
+        bool decode_scaling = false; // 记录 1..N 个解码线程的解码吞吐量曲线
+        bool pipeline = false;               // Signal 写出使用 读取 → 编码 → 写入 三阶段流水线
+        size_t read_queue_depth = 8;         // 流水线 读取 → 编码 队列容量
+        size_t write_queue_depth = 8;        // 流水线 编码 → 写入 队列容量
+        size_t inflight_mb = 256;            // 流水线在途内存上限（MB）
+        // 过滤器 → 参数名 → 要扫描的取值（--param）
+        std::map<std::string, std::map<std::string, std::vector<int>>> param_overrides;
+        bool param_grid = false; // 扫描注册表中每个参数的全部 grid 取值
+        // Signal 分块大小（元素数）扫描，0 为整个数据集一个分块，ChunkTuner::kAuto 为按数据集自动调优
+        std::vector<size_t> chunk_sizes = {0};
+        ChunkTuner::Weights tune_weights; // 自动调优得分的权重（压缩比、编码吞吐量、切片读取延迟）
+        int slice_reads = 32;             // 随机切片读取次数，0 表示不测
+        size_t slice_elements = 4096;     // 每次切片读取的元素数
+        // --filters auto 的候选管线与代价模型（为空时使用 CodecSelector 的默认候选）
+        std::vector<std::string> auto_candidates;
+        double auto_min_encode_mbps = 0.0; // 样本编码吞吐量下限（MB/s）
+        double auto_min_decode_mbps = 0.0; // 样本解码吞吐量下限（MB/s）
+        size_t auto_sample_kb = 16;        // 开头、中间、结尾各取的样本大小（KB）
+        // 可压缩性估计与剪枝：跳过在 Pareto 前沿全部目标上都不可能胜出的配置
+        bool prune = true;
+        CompressibilityEstimator::Options estimate;
+        // --require：推荐配置须满足的约束（例如 decode_mbps>=500）
+        std::vector<ParetoFrontier::Constraint> requirements;
+        bool perf_counters = false; // 压缩与解压校验阶段的 perf_event_open 计数器
+        bool io_trace = false;      // 源文件、目标文件与解压校验读取经计数 VFD 打开
+        StorageProfile throttle;    // --throttle：目标文件按该存储模型限速（隐含 io_trace）
+        CompressionPolicy policy;   // --policy：Signal 以外数据集按路径模式复制或重新写出
     };
 
     // 运行完整测试套件
@@ -32,27 +75,89 @@ public:
         const std::string &output_file,
         const std::string &format = "markdown");
 
-    static std::map<std::string, std::vector<int>> getFilterLevels();
     static std::map<std::string, std::string> getFilterParameters();
 
 private:
+    // 一个过滤器在参数网格中的一个点，以及要测试的级别
+    struct SweepPoint
+    {
+        std::string filter_name;
+        std::string parameters;
+        size_t chunk_elements;
+        std::vector<int> levels;
+    };
+
+    // 被剪除的配置：估计压缩比与原因
+    struct PrunedConfig
+    {
+        std::string filter_name;
+        std::string parameters;
+        size_t chunk_elements;
+        int level;
+        double estimated_ratio;
+        std::string reason;
+    };
+
+    // 根据注册表的级别与参数网格展开要测试的配置
+    std::vector<SweepPoint> buildSweep(const TestConfig &config) const;
+
+    // 在源数据样本上统计熵，供估计压缩比与剪枝使用
+    void estimateCompressibility(const TestConfig &config);
+
+    // 配置的估计压缩比（无法估计时为 0），以及它是否应被剪除：与已测（或已排定）配置的过滤器设置完全相同，
+    // 或已测配置中有压缩比不低于其估计上限、且编码、解码吞吐量与峰值内存都不差于同一管线已测级别最好值的点
+    // （见 ParetoFrontier::coveringPoint）。返回剪除原因，不剪除时为空
+    std::string pruneReason(const std::string &filter_name,
+                            const std::string &parameters,
+                            size_t chunk_elements,
+                            int level,
+                            const std::vector<CompressionResult> &measured,
+                            double &estimated_ratio) const;
+
     // 内部测试方法
     std::vector<CompressionResult> testFilterWithLevels(
         const std::string &input_file,
         const std::string &filter_name,
-        const std::vector<int> &levels);
+        const std::string &parameters,
+        size_t chunk_elements,
+        const std::vector<int> &levels,
+        const std::vector<CompressionResult> &measured,
+        int repeat = 1,
+        int warmup = 0);
 
-    std::vector<CompressionResult> testFilterWithShuffle(
+    // 对同一配置运行 warmup + repeat 次，返回中位数附近的一次结果并附带统计摘要
+    CompressionResult runRepeated(
         const std::string &input_file,
         const std::string &filter_name,
-        int level);
+        const std::string &parameters,
+        size_t chunk_elements,
+        int level,
+        const std::string &output_dir,
+        int repeat,
+        int warmup);
+
+    // 把全部 过滤器 × 参数 × 分块大小 × 级别 配置分发到多个工作进程并行运行，结果按配置顺序返回
+    std::vector<CompressionResult> runParallel(
+        const TestConfig &config,
+        const std::vector<SweepPoint> &sweep,
+        const std::vector<CompressionResult> &measured);
 
     // 报告生成
     std::string generateMarkdownReport(const std::vector<CompressionResult> &results);
     std::string generateCSVReport(const std::vector<CompressionResult> &results);
     std::string generateJSONReport(const std::vector<CompressionResult> &results);
+    // 逐数据集明细表（<报告名>_reads.csv），每个配置 × 数据集一行
+    std::string generateReadTableCSV(const std::vector<CompressionResult> &results);
 
     HDF5Processor processor_;
+    SignalArena arena_;
+    DatasetInventory inventory_;
+    bool prune_ = true;
+    double prune_margin_ = 1.0;
+    std::unique_ptr<CompressibilityEstimator> estimator_;
+    std::vector<PrunedConfig> pruned_;
+    std::vector<ParetoFrontier::Constraint> requirements_;
+    StorageProfile throttle_;
 };
 
 #endif // COMPRESSION_TESTER_HPP
@@ -0,0 +1,347 @@
+#include "counting_vfd.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <sys/types.h>
+
+using namespace std::chrono;
+
+namespace
+{
+    // 驱动信息（fapl 中保存的内容）
+    struct CountingFapl
+    {
+        IoStats *stats;
+        const StorageProfile *throttle;
+    };
+
+    // 打开的文件：H5FD_t 必须是第一个成员，HDF5 只认识这一部分
+    struct CountingFile
+    {
+        H5FD_t pub;
+        H5FD_t *inner; // sec2
+        IoStats *stats;
+        const StorageProfile *throttle;
+        haddr_t next_addr; // 上一次访问的结束地址
+        long long debt_ns; // 尚未休眠的模拟耗时
+    };
+
+    hid_t g_driver_id = H5I_INVALID_HID;
+
+    // 与 sec2 相同的最大地址（off_t 的最大值）
+    const haddr_t kMaxAddr = ((haddr_t)1 << (8 * sizeof(off_t) - 1)) - 1;
+
+    CountingFile *asCounting(H5FD_t *file) { return reinterpret_cast<CountingFile *>(file); }
+    const CountingFile *asCounting(const H5FD_t *file) { return reinterpret_cast<const CountingFile *>(file); }
+
+    IoStats::Access accessOf(H5FD_mem_t type)
+    {
+        return type == H5FD_MEM_DRAW ? IoStats::kRaw : IoStats::kMetadata;
+    }
+
+    // 按存储模型累计模拟耗时，攒够 1 ms 再休眠（sleep_for 对微秒级的时长不准确），实际休眠时长从欠账中扣除
+    void throttleAccess(CountingFile *file, size_t size, bool contiguous, bool write)
+    {
+        if (file->throttle == nullptr)
+        {
+            return;
+        }
+        file->debt_ns += file->throttle->deviceNs(static_cast<long long>(size), contiguous ? 0 : 1, write);
+        if (file->debt_ns >= 1000000)
+        {
+            auto start = steady_clock::now();
+            std::this_thread::sleep_for(nanoseconds(file->debt_ns));
+            file->debt_ns -= duration_cast<nanoseconds>(steady_clock::now() - start).count();
+        }
+    }
+
+    herr_t vfdTerminate()
+    {
+        g_driver_id = H5I_INVALID_HID;
+        return 0;
+    }
+
+    void *faplGet(H5FD_t *file)
+    {
+        CountingFapl *fa = static_cast<CountingFapl *>(std::malloc(sizeof(CountingFapl)));
+        if (fa != nullptr)
+        {
+            fa->stats = asCounting(file)->stats;
+            fa->throttle = asCounting(file)->throttle;
+        }
+        return fa;
+    }
+
+    void *faplCopy(const void *old_fa)
+    {
+        CountingFapl *fa = static_cast<CountingFapl *>(std::malloc(sizeof(CountingFapl)));
+        if (fa != nullptr)
+        {
+            std::memcpy(fa, old_fa, sizeof(CountingFapl));
+        }
+        return fa;
+    }
+
+    herr_t faplFree(void *fa)
+    {
+        std::free(fa);
+        return 0;
+    }
+
+    H5FD_t *vfdOpen(const char *name, unsigned flags, hid_t fapl_id, haddr_t maxaddr)
+    {
+        const CountingFapl *fa = nullptr;
+        if (H5Pget_driver(fapl_id) == g_driver_id)
+        {
+            fa = static_cast<const CountingFapl *>(H5Pget_driver_info(fapl_id));
+        }
+
+        hid_t inner_fapl = H5Pcreate(H5P_FILE_ACCESS);
+        if (inner_fapl < 0)
+        {
+            return nullptr;
+        }
+        H5Pset_fapl_sec2(inner_fapl);
+        // H5Fcreate 会先试探性地打开一次（文件可能不存在），内部调用是独立的 API 调用，失败时会自行打印错误栈；
+        // 真正的打开失败仍由外层的 H5Fopen/H5Fcreate 报告
+        H5FD_t *inner = nullptr;
+        H5E_BEGIN_TRY
+        {
+            inner = H5FDopen(name, flags, inner_fapl, maxaddr);
+        }
+        H5E_END_TRY;
+        H5Pclose(inner_fapl);
+        if (inner == nullptr)
+        {
+            return nullptr;
+        }
+
+        CountingFile *file = static_cast<CountingFile *>(std::calloc(1, sizeof(CountingFile)));
+        if (file == nullptr)
+        {
+            H5FDclose(inner);
+            return nullptr;
+        }
+        file->inner = inner;
+        file->stats = fa != nullptr ? fa->stats : nullptr;
+        file->throttle = fa != nullptr ? fa->throttle : nullptr;
+        file->next_addr = HADDR_UNDEF;
+        return &file->pub;
+    }
+
+    herr_t vfdClose(H5FD_t *file)
+    {
+        CountingFile *counting = asCounting(file);
+        // 关闭前付清剩余的模拟耗时
+        if (counting->debt_ns > 0)
+        {
+            std::this_thread::sleep_for(nanoseconds(counting->debt_ns));
+        }
+        herr_t status = H5FDclose(counting->inner);
+        std::free(counting);
+        return status;
+    }
+
+    int vfdCmp(const H5FD_t *f1, const H5FD_t *f2)
+    {
+        return H5FDcmp(asCounting(f1)->inner, asCounting(f2)->inner);
+    }
+
+    herr_t vfdQuery(const H5FD_t *file, unsigned long *flags)
+    {
+        // 沿用 sec2 的特性（元数据聚合、数据筛选缓冲等），这样计到的就是 sec2 实际发出的访问
+        if (file == nullptr)
+        {
+            return H5FDdriver_query(H5FD_SEC2, flags);
+        }
+        return H5FDquery(asCounting(file)->inner, flags) < 0 ? -1 : 0;
+    }
+
+    haddr_t vfdGetEoa(const H5FD_t *file, H5FD_mem_t type)
+    {
+        return H5FDget_eoa(asCounting(file)->inner, type);
+    }
+
+    herr_t vfdSetEoa(H5FD_t *file, H5FD_mem_t type, haddr_t addr)
+    {
+        return H5FDset_eoa(asCounting(file)->inner, type, addr);
+    }
+
+    haddr_t vfdGetEof(const H5FD_t *file, H5FD_mem_t type)
+    {
+        return H5FDget_eof(asCounting(file)->inner, type);
+    }
+
+    herr_t vfdGetHandle(H5FD_t *file, hid_t fapl, void **file_handle)
+    {
+        return H5FDget_vfd_handle(asCounting(file)->inner, fapl, file_handle);
+    }
+
+    herr_t vfdRead(H5FD_t *file, H5FD_mem_t type, hid_t dxpl, haddr_t addr, size_t size, void *buffer)
+    {
+        CountingFile *counting = asCounting(file);
+        bool contiguous = addr == counting->next_addr;
+        auto start = steady_clock::now();
+        herr_t status = H5FDread(counting->inner, type, dxpl, addr, size, buffer);
+        if (status >= 0)
+        {
+            throttleAccess(counting, size, contiguous, false);
+            counting->next_addr = addr + size;
+        }
+        if (counting->stats != nullptr && status >= 0)
+        {
+            counting->stats->at(accessOf(type), IoStats::kRead)
+                .record(addr, size, duration_cast<nanoseconds>(steady_clock::now() - start).count(), contiguous);
+        }
+        return status;
+    }
+
+    herr_t vfdWrite(H5FD_t *file, H5FD_mem_t type, hid_t dxpl, haddr_t addr, size_t size, const void *buffer)
+    {
+        CountingFile *counting = asCounting(file);
+        bool contiguous = addr == counting->next_addr;
+        auto start = steady_clock::now();
+        herr_t status = H5FDwrite(counting->inner, type, dxpl, addr, size, buffer);
+        if (status >= 0)
+        {
+            throttleAccess(counting, size, contiguous, true);
+            counting->next_addr = addr + size;
+        }
+        if (counting->stats != nullptr && status >= 0)
+        {
+            counting->stats->at(accessOf(type), IoStats::kWrite)
+                .record(addr, size, duration_cast<nanoseconds>(steady_clock::now() - start).count(), contiguous);
+        }
+        return status;
+    }
+
+    herr_t vfdFlush(H5FD_t *file, hid_t dxpl, hbool_t closing)
+    {
+        return H5FDflush(asCounting(file)->inner, dxpl, closing);
+    }
+
+    herr_t vfdTruncate(H5FD_t *file, hid_t dxpl, hbool_t closing)
+    {
+        return H5FDtruncate(asCounting(file)->inner, dxpl, closing);
+    }
+
+    herr_t vfdLock(H5FD_t *file, hbool_t rw)
+    {
+        return H5FDlock(asCounting(file)->inner, rw);
+    }
+
+    herr_t vfdUnlock(H5FD_t *file)
+    {
+        return H5FDunlock(asCounting(file)->inner);
+    }
+
+    const H5FD_class_t kCountingClass = {
+        "counting",            // name
+        kMaxAddr,              // maxaddr
+        H5F_CLOSE_WEAK,        // fc_degree
+        vfdTerminate,          // terminate
+        nullptr,               // sb_size
+        nullptr,               // sb_encode
+        nullptr,               // sb_decode
+        sizeof(CountingFapl),  // fapl_size
+        faplGet,               // fapl_get
+        faplCopy,              // fapl_copy
+        faplFree,              // fapl_free
+        0,                     // dxpl_size
+        nullptr,               // dxpl_copy
+        nullptr,               // dxpl_free
+        vfdOpen,               // open
+        vfdClose,              // close
+        vfdCmp,                // cmp
+        vfdQuery,              // query
+        nullptr,               // get_type_map
+        nullptr,               // alloc
+        nullptr,               // free
+        vfdGetEoa,             // get_eoa
+        vfdSetEoa,             // set_eoa
+        vfdGetEof,             // get_eof
+        vfdGetHandle,          // get_handle
+        vfdRead,               // read
+        vfdWrite,              // write
+        vfdFlush,              // flush
+        vfdTruncate,           // truncate
+        vfdLock,               // lock
+        vfdUnlock,             // unlock
+        H5FD_FLMAP_DICHOTOMY   // fl_map
+    };
+} // namespace
+
+void IoOpStats::record(haddr_t addr, size_t size, long long elapsed_ns, bool contiguous)
+{
+    calls++;
+    if (contiguous)
+    {
+        sequential++;
+    }
+    bytes += static_cast<long long>(size);
+    ns += elapsed_ns;
+    max_ns = std::max(max_ns, elapsed_ns);
+    if (addr % 4096 != 0)
+    {
+        unaligned++;
+    }
+    int bucket = size < 512 ? 0 : size < 4096 ? 1 : size < 65536 ? 2 : size < 1048576 ? 3 : 4;
+    size_hist[bucket]++;
+}
+
+void IoOpStats::merge(const IoOpStats &other)
+{
+    calls += other.calls;
+    bytes += other.bytes;
+    ns += other.ns;
+    max_ns = std::max(max_ns, other.max_ns);
+    unaligned += other.unaligned;
+    sequential += other.sequential;
+    for (int b = 0; b < kSizeBuckets; ++b)
+    {
+        size_hist[b] += other.size_hist[b];
+    }
+}
+
+const char *IoOpStats::bucketLabel(int bucket)
+{
+    static const char *labels[kSizeBuckets] = {"<512B", "512B-4K", "4K-64K", "64K-1M", ">=1M"};
+    return bucket >= 0 && bucket < kSizeBuckets ? labels[bucket] : "";
+}
+
+IoOpStats IoStats::total(Direction direction) const
+{
+    IoOpStats sum = ops[kMetadata][direction];
+    sum.merge(ops[kRaw][direction]);
+    return sum;
+}
+
+long long IoStats::deviceNs(const StorageProfile &profile) const
+{
+    IoOpStats reads = total(kRead);
+    IoOpStats writes = total(kWrite);
+    return profile.deviceNs(reads.bytes, reads.calls - reads.sequential, false) +
+           profile.deviceNs(writes.bytes, writes.calls - writes.sequential, true);
+}
+
+hid_t CountingVfd::driverId()
+{
+    if (g_driver_id < 0 || H5Iis_valid(g_driver_id) <= 0)
+    {
+        g_driver_id = H5FDregister(&kCountingClass);
+    }
+    return g_driver_id;
+}
+
+bool CountingVfd::setFapl(hid_t fapl_id, IoStats *stats, const StorageProfile *throttle)
+{
+    hid_t driver_id = driverId();
+    if (driver_id < 0)
+    {
+        return false;
+    }
+    CountingFapl fa = {stats, throttle};
+    return H5Pset_driver(fapl_id, driver_id, &fa) >= 0;
+}
@@ -0,0 +1,67 @@
+#ifndef COUNTING_VFD_HPP
+#define COUNTING_VFD_HPP
+
+#include <hdf5.h>
+#include <cstddef>
+#include "storage_profile.hpp"
+
+// 一类访问（元数据/原始数据 × 读/写）的调用统计
+struct IoOpStats
+{
+    // 访问大小分组：<512 B、<4 KiB、<64 KiB、<1 MiB、>=1 MiB
+    static const int kSizeBuckets = 5;
+
+    long long calls = 0;
+    long long bytes = 0;
+    long long ns = 0;         // VFD 调用耗时之和（限速时含休眠）
+    long long max_ns = 0;
+    long long unaligned = 0;  // 起始地址不是 4 KiB 对齐的访问
+    long long sequential = 0; // 紧接上一次访问（任意类型）结束地址的访问，存储模型中不付延迟
+    long long size_hist[kSizeBuckets] = {};
+
+    void record(haddr_t addr, size_t size, long long elapsed_ns, bool contiguous);
+    void merge(const IoOpStats &other);
+    long long small() const { return size_hist[0] + size_hist[1]; } // 小于 4 KiB 的访问
+    double meanUs() const { return calls > 0 ? ns / 1.0e3 / calls : 0.0; }
+
+    static const char *bucketLabel(int bucket);
+};
+
+// 一个 HDF5 文件经计数驱动发出的全部 I/O
+struct IoStats
+{
+    enum Access
+    {
+        kMetadata = 0,
+        kRaw = 1
+    };
+    enum Direction
+    {
+        kRead = 0,
+        kWrite = 1
+    };
+
+    IoOpStats ops[2][2]; // [Access][Direction]
+
+    IoOpStats &at(Access access, Direction direction) { return ops[access][direction]; }
+    const IoOpStats &at(Access access, Direction direction) const { return ops[access][direction]; }
+    // 元数据与原始数据合并
+    IoOpStats total(Direction direction) const;
+    bool collected() const { return total(kRead).calls > 0 || total(kWrite).calls > 0; }
+    // 全部访问在给定存储设备上的模型耗时（纳秒）
+    long long deviceNs(const StorageProfile &profile) const;
+};
+
+// 计数虚拟文件驱动：所有调用转发给内部的 sec2 文件，同时按访问类型记录调用次数、大小分布与延迟；
+// 给出存储模型时每次读写之后按模型耗时休眠，模拟较慢的设备。
+// 统计写入 setFapl 给出的 IoStats，文件关闭前该对象（以及存储模型）必须有效；HDF5 调用在本程序中是串行的，统计不加锁
+class CountingVfd
+{
+public:
+    // 在文件访问属性列表上设置计数驱动，throttle 非空时限速
+    static bool setFapl(hid_t fapl_id, IoStats *stats, const StorageProfile *throttle = nullptr);
+    // 注册（首次调用时）并返回驱动 ID，失败返回 -1
+    static hid_t driverId();
+};
+
+#endif // COUNTING_VFD_HPP
@@ -0,0 +1,468 @@
+#include "dataset_inventory.hpp"
+#include "hdf5_processor.hpp"
+#include "utils.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std::chrono;
+
+namespace
+{
+    // 旁路文件格式：魔数、版本、输入文件的大小与修改时间、对象个数，之后逐个对象。
+    // 整数按本机字节序写出，旁路文件只在生成它的机器上使用
+    const char kMagic[8] = {'H', '5', 'C', 'B', 'I', 'N', 'V', '\0'};
+    const uint32_t kVersion = 2; // 2：软链接与外部链接不再解析为目标对象
+
+    class BinaryWriter
+    {
+    public:
+        template <typename T>
+        void put(T value)
+        {
+            putBytes(&value, sizeof(value));
+        }
+        void putBytes(const void *data, size_t size)
+        {
+            out_.append(static_cast<const char *>(data), size);
+        }
+        void putString(const std::string &value)
+        {
+            put<uint32_t>(static_cast<uint32_t>(value.size()));
+            putBytes(value.data(), value.size());
+        }
+        const std::string &str() const { return out_; }
+
+    private:
+        std::string out_;
+    };
+
+    // 越界或长度不合理时置 ok 为 false，之后的读取都失败
+    class BinaryReader
+    {
+    public:
+        explicit BinaryReader(const std::string &in) : in_(in) {}
+
+        template <typename T>
+        bool get(T &value)
+        {
+            return getBytes(&value, sizeof(value));
+        }
+        bool getBytes(void *data, size_t size)
+        {
+            if (!ok_ || size > in_.size() - pos_)
+            {
+                ok_ = false;
+                return false;
+            }
+            std::memcpy(data, in_.data() + pos_, size);
+            pos_ += size;
+            return true;
+        }
+        bool getString(std::string &value)
+        {
+            uint32_t size = 0;
+            if (!get(size) || !fits(size, 1))
+            {
+                return false;
+            }
+            value.assign(in_.data() + pos_, size);
+            pos_ += size;
+            return true;
+        }
+        // 还剩下至少 count 个 element_size 字节的元素（防止损坏的长度字段导致巨大的分配）
+        bool fits(uint64_t count, size_t element_size)
+        {
+            ok_ = ok_ && count <= (in_.size() - pos_) / element_size;
+            return ok_;
+        }
+        bool ok() const { return ok_; }
+        bool atEnd() const { return pos_ == in_.size(); }
+
+    private:
+        const std::string &in_;
+        size_t pos_ = 0;
+        bool ok_ = true;
+    };
+
+    void describeDataset(hid_t dset_id, DatasetInventory::Object &object)
+    {
+        hid_t type_id = H5Dget_type(dset_id);
+        size_t type_image_size = 0;
+        if (type_id >= 0 && H5Tencode(type_id, NULL, &type_image_size) >= 0)
+        {
+            object.type_image.resize(type_image_size);
+            H5Tencode(type_id, object.type_image.data(), &type_image_size);
+        }
+        if (type_id >= 0)
+        {
+            H5Tclose(type_id);
+        }
+
+        hid_t space_id = H5Dget_space(dset_id);
+        int rank = H5Sget_simple_extent_ndims(space_id);
+        if (rank > 0)
+        {
+            object.dims.resize(static_cast<size_t>(rank));
+            H5Sget_simple_extent_dims(space_id, object.dims.data(), NULL);
+        }
+
+        hid_t dcpl_id = H5Dget_create_plist(dset_id);
+        if (dcpl_id >= 0)
+        {
+            object.layout = H5Pget_layout(dcpl_id);
+            int nfilters = H5Pget_nfilters(dcpl_id);
+            for (int i = 0; i < nfilters; ++i)
+            {
+                unsigned flags = 0;
+                size_t cd_nelmts = 0;
+                object.filters.push_back(H5Pget_filter2(dcpl_id, static_cast<unsigned>(i), &flags, &cd_nelmts,
+                                                        NULL, 0, NULL, NULL));
+            }
+            if (object.layout == H5D_CHUNKED && rank > 0)
+            {
+                object.chunk_dims.resize(static_cast<size_t>(rank));
+                H5Pget_chunk(dcpl_id, rank, object.chunk_dims.data());
+            }
+            H5Pclose(dcpl_id);
+        }
+        object.storage_size = H5Dget_storage_size(dset_id);
+        if (object.layout == H5D_CONTIGUOUS)
+        {
+            object.offset = H5Dget_offset(dset_id);
+        }
+
+        // Signal 数据集的分块位置（过滤后的大小与 filter mask），供直接按分块读取
+        if (object.layout == H5D_CHUNKED && HDF5Processor::isSignalPath(object.path))
+        {
+            hsize_t num_chunks = 0;
+            if (H5Dget_num_chunks(dset_id, space_id, &num_chunks) >= 0)
+            {
+                object.chunks.resize(static_cast<size_t>(num_chunks));
+                for (hsize_t index = 0; index < num_chunks; ++index)
+                {
+                    DatasetInventory::Chunk &chunk = object.chunks[index];
+                    if (H5Dget_chunk_info(dset_id, space_id, index, NULL, &chunk.filter_mask,
+                                          &chunk.address, &chunk.size) < 0)
+                    {
+                        object.chunks.clear();
+                        break;
+                    }
+                }
+            }
+        }
+        H5Sclose(space_id);
+    }
+} // namespace
+
+size_t DatasetInventory::Object::elements() const
+{
+    size_t count = 1;
+    for (hsize_t dim : dims)
+    {
+        count *= static_cast<size_t>(dim);
+    }
+    return count;
+}
+
+std::string DatasetInventory::sidecarPath(const std::string &input_file)
+{
+    return input_file + ".inventory";
+}
+
+bool DatasetInventory::fileKey(const std::string &path, uint64_t &size, int64_t &mtime_ns)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+    {
+        return false;
+    }
+    size = static_cast<uint64_t>(st.st_size);
+    mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    return true;
+}
+
+bool DatasetInventory::load(const std::string &input_file, bool persist)
+{
+    clear();
+    auto load_start = steady_clock::now();
+
+    uint64_t size = 0;
+    int64_t mtime_ns = 0;
+    bool keyed = fileKey(input_file, size, mtime_ns);
+    std::string sidecar = sidecarPath(input_file);
+    if (persist && keyed && readSidecar(sidecar, size, mtime_ns))
+    {
+        from_sidecar_ = true;
+    }
+    else
+    {
+        hid_t file_id = H5Fopen(input_file.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        if (file_id < 0)
+        {
+            std::cerr << "Failed to open input file for inventory: " << input_file << std::endl;
+            return false;
+        }
+        bool scanned = scan(file_id);
+        H5Fclose(file_id);
+        if (!scanned)
+        {
+            clear();
+            return false;
+        }
+        // 输入文件所在目录不可写时只是不保存，下次仍需遍历
+        if (persist && keyed && !writeSidecar(sidecar, size, mtime_ns))
+        {
+            std::cerr << "Warning: Could not write dataset inventory: " << sidecar << std::endl;
+        }
+    }
+    source_file_ = input_file;
+    load_time_ns_ = duration_cast<nanoseconds>(steady_clock::now() - load_start).count();
+
+    std::cout << "Dataset inventory: " << objects_.size() << " objects, " << signals_.size() << " signal datasets "
+              << (from_sidecar_ ? "read from " : "scanned in ")
+              << (from_sidecar_ ? sidecar + " in " : "")
+              << std::fixed << std::setprecision(3) << load_time_ns_ / 1.0e6 << " ms"
+              << (!from_sidecar_ && persist && keyed ? ", saved to " + sidecar : "") << std::endl;
+    return true;
+}
+
+bool DatasetInventory::scan(hid_t file_id)
+{
+    objects_.clear();
+    auto visit_callback = [](hid_t group, const char *name, const H5L_info_t *info, void *operator_data) -> herr_t
+    {
+        std::vector<Object> *objects = static_cast<std::vector<Object> *>(operator_data);
+        Object object;
+        object.path = name;
+        // 软链接与外部链接只记录路径（类型为 H5O_TYPE_UNKNOWN），不解析目标：本文件中的目标已有自己的硬链接条目，
+        // 外部目标不属于本文件，悬空链接解析时还会打印 HDF5 错误栈
+        if (info->type != H5L_TYPE_HARD)
+        {
+            objects->push_back(std::move(object));
+            return 0;
+        }
+
+        // 只取基本信息（类型），不读取属性个数等需要访问对象头其余部分的字段
+        H5O_info_t obj_info;
+        if (H5Oget_info_by_name2(group, name, &obj_info, H5O_INFO_BASIC, H5P_DEFAULT) >= 0)
+        {
+            object.type = obj_info.type;
+        }
+        if (object.type == H5O_TYPE_DATASET)
+        {
+            hid_t dset_id = H5Dopen(group, name, H5P_DEFAULT);
+            if (dset_id >= 0)
+            {
+                describeDataset(dset_id, object);
+                H5Dclose(dset_id);
+            }
+        }
+        objects->push_back(std::move(object));
+        return 0;
+    };
+
+    herr_t status = H5Lvisit_by_name(file_id, "/", H5_INDEX_NAME, H5_ITER_NATIVE,
+                                     visit_callback, &objects_, H5P_DEFAULT);
+    if (status < 0)
+    {
+        std::cerr << "Failed to traverse file for inventory" << std::endl;
+        objects_.clear();
+    }
+    reindex();
+    return status >= 0;
+}
+
+void DatasetInventory::clear()
+{
+    objects_.clear();
+    signals_.clear();
+    index_.clear();
+    source_file_.clear();
+    from_sidecar_ = false;
+    load_time_ns_ = 0;
+}
+
+const DatasetInventory::Object *DatasetInventory::find(const std::string &path) const
+{
+    auto it = index_.find(path);
+    return it == index_.end() ? nullptr : &objects_[it->second];
+}
+
+void DatasetInventory::reindex()
+{
+    signals_.clear();
+    index_.clear();
+    for (size_t i = 0; i < objects_.size(); ++i)
+    {
+        index_.emplace(objects_[i].path, i);
+        if (objects_[i].type == H5O_TYPE_DATASET && HDF5Processor::isSignalPath(objects_[i].path))
+        {
+            signals_.push_back(i);
+        }
+    }
+}
+
+bool DatasetInventory::readSidecar(const std::string &sidecar, uint64_t size, int64_t mtime_ns)
+{
+    std::ifstream file(sidecar, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string content = buffer.str();
+
+    BinaryReader in(content);
+    char magic[sizeof(kMagic)];
+    uint32_t version = 0;
+    uint64_t stored_size = 0;
+    int64_t stored_mtime = 0;
+    uint64_t count = 0;
+    if (!in.getBytes(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !in.get(version) || version != kVersion || !in.get(stored_size) || !in.get(stored_mtime) ||
+        stored_size != size || stored_mtime != mtime_ns || !in.get(count) || !in.fits(count, 5))
+    {
+        return false;
+    }
+
+    std::vector<Object> objects(static_cast<size_t>(count));
+    for (Object &object : objects)
+    {
+        int32_t type = 0;
+        if (!in.getString(object.path) || !in.get(type))
+        {
+            return false;
+        }
+        object.type = static_cast<H5O_type_t>(type);
+        if (object.type != H5O_TYPE_DATASET)
+        {
+            continue;
+        }
+
+        uint32_t type_image_size = 0;
+        uint8_t rank = 0;
+        uint8_t nfilters = 0;
+        uint8_t chunk_rank = 0;
+        int32_t layout = 0;
+        uint64_t chunks = 0;
+        if (!in.get(type_image_size) || !in.fits(type_image_size, 1))
+        {
+            return false;
+        }
+        object.type_image.resize(type_image_size);
+        in.getBytes(object.type_image.data(), type_image_size);
+        in.get(rank);
+        object.dims.resize(rank);
+        in.getBytes(object.dims.data(), rank * sizeof(hsize_t));
+        in.get(layout);
+        object.layout = static_cast<H5D_layout_t>(layout);
+        in.get(nfilters);
+        for (uint8_t i = 0; i < nfilters; ++i)
+        {
+            int32_t filter = 0;
+            in.get(filter);
+            object.filters.push_back(static_cast<H5Z_filter_t>(filter));
+        }
+        in.get(chunk_rank);
+        object.chunk_dims.resize(chunk_rank);
+        in.getBytes(object.chunk_dims.data(), chunk_rank * sizeof(hsize_t));
+        in.get(object.storage_size);
+        in.get(object.offset);
+        if (!in.get(chunks) || !in.fits(chunks, sizeof(haddr_t) + sizeof(hsize_t) + sizeof(uint32_t)))
+        {
+            return false;
+        }
+        object.chunks.resize(static_cast<size_t>(chunks));
+        for (Chunk &chunk : object.chunks)
+        {
+            uint32_t filter_mask = 0;
+            in.get(chunk.address);
+            in.get(chunk.size);
+            in.get(filter_mask);
+            chunk.filter_mask = filter_mask;
+        }
+        if (!in.ok())
+        {
+            return false;
+        }
+    }
+    if (!in.ok() || !in.atEnd())
+    {
+        return false;
+    }
+
+    objects_ = std::move(objects);
+    reindex();
+    return true;
+}
+
+bool DatasetInventory::writeSidecar(const std::string &sidecar, uint64_t size, int64_t mtime_ns) const
+{
+    BinaryWriter out;
+    out.putBytes(kMagic, sizeof(kMagic));
+    out.put<uint32_t>(kVersion);
+    out.put<uint64_t>(size);
+    out.put<int64_t>(mtime_ns);
+    out.put<uint64_t>(objects_.size());
+    for (const Object &object : objects_)
+    {
+        out.putString(object.path);
+        out.put<int32_t>(object.type);
+        if (object.type != H5O_TYPE_DATASET)
+        {
+            continue;
+        }
+        out.put<uint32_t>(static_cast<uint32_t>(object.type_image.size()));
+        out.putBytes(object.type_image.data(), object.type_image.size());
+        out.put<uint8_t>(static_cast<uint8_t>(object.dims.size()));
+        out.putBytes(object.dims.data(), object.dims.size() * sizeof(hsize_t));
+        out.put<int32_t>(object.layout);
+        out.put<uint8_t>(static_cast<uint8_t>(object.filters.size()));
+        for (H5Z_filter_t filter : object.filters)
+        {
+            out.put<int32_t>(filter);
+        }
+        out.put<uint8_t>(static_cast<uint8_t>(object.chunk_dims.size()));
+        out.putBytes(object.chunk_dims.data(), object.chunk_dims.size() * sizeof(hsize_t));
+        out.put<hsize_t>(object.storage_size);
+        out.put<haddr_t>(object.offset);
+        out.put<uint64_t>(object.chunks.size());
+        for (const Chunk &chunk : object.chunks)
+        {
+            out.put<haddr_t>(chunk.address);
+            out.put<hsize_t>(chunk.size);
+            out.put<uint32_t>(chunk.filter_mask);
+        }
+    }
+
+    // 先写临时文件再改名，并发运行（--jobs、多个终端）不会读到写了一半的旁路文件
+    std::string temp = sidecar + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        file.write(out.str().data(), static_cast<std::streamsize>(out.str().size()));
+        if (!file.good())
+        {
+            file.close();
+            std::remove(temp.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temp.c_str(), sidecar.c_str()) != 0)
+    {
+        std::remove(temp.c_str());
+        return false;
+    }
+    return true;
+}
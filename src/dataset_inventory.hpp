@@ -0,0 +1,76 @@
+#ifndef DATASET_INVENTORY_HPP
+#define DATASET_INVENTORY_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <hdf5.h>
+
+// 输入文件的对象清单：一次 H5Lvisit 遍历收集全部链接的对象类型，以及数据集的类型、形状、过滤器、
+// 存储大小和数据位置（连续存储的偏移、Signal 数据集的分块偏移）。
+// 结果以紧凑的二进制旁路文件 <input>.inventory 保存在输入文件旁边，按文件大小与修改时间判断是否过期，
+// 之后的运行直接读取旁路文件，不再遍历
+class DatasetInventory
+{
+public:
+    struct Chunk
+    {
+        haddr_t address = HADDR_UNDEF;
+        hsize_t size = 0;          // 文件中的字节数（过滤后）
+        unsigned filter_mask = 0;  // 未应用的过滤器
+    };
+
+    struct Object
+    {
+        std::string path;                      // 与 H5Lvisit 给出的名称一致（相对根组）
+        H5O_type_t type = H5O_TYPE_UNKNOWN;    // 软链接、外部链接与无法取得信息的对象为 H5O_TYPE_UNKNOWN
+        // 以下只对数据集有效
+        std::vector<unsigned char> type_image; // 文件类型（H5Tencode）
+        std::vector<hsize_t> dims;
+        H5D_layout_t layout = H5D_LAYOUT_ERROR;
+        std::vector<H5Z_filter_t> filters;     // 按管线顺序
+        std::vector<hsize_t> chunk_dims;
+        hsize_t storage_size = 0;
+        haddr_t offset = HADDR_UNDEF;          // 连续存储的数据在文件中的偏移
+        std::vector<Chunk> chunks;             // 只为 Signal 数据集收集
+
+        size_t elements() const;
+    };
+
+    DatasetInventory() = default;
+
+    // 旁路文件存在且与输入文件一致时直接读取，否则遍历输入文件；persist 为 true 时把遍历结果写入旁路文件
+    bool load(const std::string &input_file, bool persist = true);
+    // 遍历一个已打开的文件（不读写旁路文件）
+    bool scan(hid_t file_id);
+    void clear();
+
+    bool empty() const { return objects_.empty(); }
+    const std::vector<Object> &objects() const { return objects_; }
+    // 全部 Signal 数据集在 objects() 中的下标，按遍历顺序
+    const std::vector<size_t> &signalDatasets() const { return signals_; }
+    const Object *find(const std::string &path) const;
+
+    const std::string &sourceFile() const { return source_file_; }
+    bool fromSidecar() const { return from_sidecar_; }
+    long long loadTimeNs() const { return load_time_ns_; }
+
+    static std::string sidecarPath(const std::string &input_file);
+
+private:
+    // 输入文件的大小与修改时间（纳秒），旁路文件以此判断是否过期
+    static bool fileKey(const std::string &path, uint64_t &size, int64_t &mtime_ns);
+    bool readSidecar(const std::string &sidecar, uint64_t size, int64_t mtime_ns);
+    bool writeSidecar(const std::string &sidecar, uint64_t size, int64_t mtime_ns) const;
+    void reindex();
+
+    std::vector<Object> objects_;
+    std::vector<size_t> signals_;
+    std::unordered_map<std::string, size_t> index_;
+    std::string source_file_;
+    bool from_sidecar_ = false;
+    long long load_time_ns_ = 0;
+};
+
+#endif // DATASET_INVENTORY_HPP
@@ -1,201 +1,564 @@
 #include "filter_definitions.hpp"
-#include <iostream>
+#include "utils.hpp"
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
 
 namespace FilterDefinitions
 {
 
-    std::vector<FilterInfo> getAllFilters()
+    namespace
     {
-        std::vector<FilterInfo> filters;
+        // 只把级别作为唯一参数的过滤器（级别为 0 时不传参数）
+        std::vector<unsigned int> levelIfPositive(int level, const ParamValues &)
+        {
+            std::vector<unsigned int> params;
+            if (level > 0)
+            {
+                params.push_back(level);
+            }
+            return params;
+        }
+
+        int clampLevel(int level, int max_level)
+        {
+            return level > max_level ? max_level : level;
+        }
+
+        // 过滤器注册表  https://github.com/HDFGroup/hdf5_plugins/blob/master/docs/RegisteredFilterPlugins.md
+        // cd_values 的构造方式遵循各过滤器插件的参数约定
+        constexpr std::initializer_list<FilterSpec> kFilters = {
+            {H5Z_FILTER_DEFLATE, "GZIP", "DEFLATE", "DEFLATE compression algorithm (gzip)",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9}, {},
+             [](int level, const ParamValues &)
+             { return std::vector<unsigned int>{static_cast<unsigned int>(level)}; },
+             [](hid_t dcpl_id, const std::vector<unsigned int> &cd_values)
+             { return H5Pset_deflate(dcpl_id, cd_values[0]); }},
+
+            // SHUFFLE 没有参数，元素大小由库在创建数据集时填入
+            {H5Z_FILTER_SHUFFLE, "SHUFFLE", nullptr, "Byte shuffling filter (usually combined with other compressors)",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9}, {},
+             [](int, const ParamValues &)
+             { return std::vector<unsigned int>(); },
+             [](hid_t dcpl_id, const std::vector<unsigned int> &)
+             { return H5Pset_shuffle(dcpl_id); }},
+
+            {H5Z_FILTER_FLETCHER32, "FLETCHER32", nullptr, "Fletcher32 checksum",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9}, {}, levelIfPositive, nullptr},
+
+            // SZIP：编码选项和像素每块；级别为 4、8、32 时直接作为像素每块
+            {H5Z_FILTER_SZIP, "SZIP", nullptr, "NASA's lossless compression algorithm",
+             H5Z_FLAG_OPTIONAL, 0, 32, {1, 6, 9},
+             {{"coding", "Entropy coding method", ParamType::Choice, 4, 4, 32, {4, 32}, {{"ec", 4}, {"nn", 32}}},
+              {"pixels_per_block", "Pixels per block (even, at most 32)", ParamType::Integer, 32, 2, 32, {8, 16, 32}, {}}},
+             [](int level, const ParamValues &params)
+             {
+                 unsigned int pixels_per_block = (level == 4 || level == 8 || level == 32)
+                                                     ? static_cast<unsigned int>(level)
+                                                     : static_cast<unsigned int>(params.at("pixels_per_block"));
+                 return std::vector<unsigned int>{static_cast<unsigned int>(params.at("coding")), pixels_per_block};
+             },
+             [](hid_t dcpl_id, const std::vector<unsigned int> &cd_values)
+             { return H5Pset_szip(dcpl_id, cd_values[0], cd_values[1]); }},
+
+            {H5Z_FILTER_NBIT, "NBIT", nullptr, "N-bit compression",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9}, {}, levelIfPositive, nullptr},
+
+            {H5Z_FILTER_SCALEOFFSET, "SCALEOFFSET", nullptr, "Scale-offset compression",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9}, {}, levelIfPositive, nullptr},
+
+            {H5Z_FILTER_BITGROOM, "BITGROOM", nullptr, "BitGrooming for floating-point data",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9}, {}, levelIfPositive, nullptr},
+
+            // BLOSC：cd_values[0..3] 由插件的 set_local 填入（版本、类型大小、块大小），
+            // [4] 压缩级别，[5] 混洗方式，[6] 压缩器
+            {H5Z_FILTER_BLOSC, "BLOSC", nullptr, "Blosc meta-compressor",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9},
+             {{"compressor", "Blosc compressor code", ParamType::Choice, 2, 0, 5, {0, 1, 2, 4, 5},
+               {{"blosclz", 0}, {"lz4", 1}, {"lz4hc", 2}, {"snappy", 3}, {"zlib", 4}, {"zstd", 5}}},
+              {"shuffle", "Shuffle mode", ParamType::Choice, 1, 0, 2, {0, 1, 2},
+               {{"none", 0}, {"byte", 1}, {"bit", 2}}},
+              {"typesize", "Element size for shuffling, 0 lets set_local take it from the datatype", ParamType::Integer, 0, 0, 255, {0}, {}}},
+             [](int level, const ParamValues &params)
+             {
+                 return std::vector<unsigned int>{
+                     0, 0, static_cast<unsigned int>(params.at("typesize")), 0,
+                     static_cast<unsigned int>(clampLevel(level, 9)),
+                     static_cast<unsigned int>(params.at("shuffle")),
+                     static_cast<unsigned int>(params.at("compressor"))};
+             },
+             nullptr},
+
+            // BLOSC2：前 7 个值与 BLOSC 相同，其后是插件的分块描述
+            {H5Z_FILTER_BLOSC2, "BLOSC2", nullptr, "Blosc2 meta-compressor with improved features",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9},
+             {{"compressor", "Blosc2 compressor code", ParamType::Choice, 2, 0, 5, {0, 1, 2, 4, 5},
+               {{"blosclz", 0}, {"lz4", 1}, {"lz4hc", 2}, {"zlib", 4}, {"zstd", 5}}},
+              {"shuffle", "Shuffle mode", ParamType::Choice, 1, 0, 2, {0, 1, 2},
+               {{"none", 0}, {"byte", 1}, {"bit", 2}}},
+              {"typesize", "Element size for shuffling, 0 lets set_local take it from the datatype", ParamType::Integer, 0, 0, 255, {0}, {}}},
+             [](int level, const ParamValues &params)
+             {
+                 return std::vector<unsigned int>{
+                     0, 0, static_cast<unsigned int>(params.at("typesize")), 0,
+                     static_cast<unsigned int>(clampLevel(level, 9)),
+                     static_cast<unsigned int>(params.at("shuffle")),
+                     static_cast<unsigned int>(params.at("compressor")),
+                     2, 4, 8};
+             },
+             nullptr},
+
+            {H5Z_FILTER_BSHUF, "BSHUF", "BITSHUFFLE", "Bit shuffling filter for improved compression",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9}, {}, levelIfPositive, nullptr},
+
+            // BZIP2：级别 1-8 直接使用，其余取 2；自身的级别为块大小 1-9（×100 KB）
+            {H5Z_FILTER_BZIP2, "BZIP2", nullptr, "Bzip2 compression algorithm",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9}, {},
+             [](int level, const ParamValues &)
+             { return std::vector<unsigned int>{static_cast<unsigned int>(level > 0 && level < 9 ? level : 2)}; },
+             nullptr, 1, 9,
+             [](int level, const ParamValues &)
+             { return std::vector<unsigned int>{static_cast<unsigned int>(level)}; }},
 
-        // 标准HDF5过滤器
-        filters.push_back({H5Z_FILTER_DEFLATE, "GZIP", "DEFLATE compression algorithm (gzip)", {1, 2, 3, 4, 5, 6, 7, 8, 9}, 1, 1, true});
-        filters.push_back({H5Z_FILTER_SHUFFLE, "SHUFFLE", "Byte shuffling filter", {}, 0, 0, true});
-        filters.push_back({H5Z_FILTER_FLETCHER32, "FLETCHER32", "Fletcher32 checksum", {}, 0, 0, false});
-        filters.push_back({H5Z_FILTER_SZIP, "SZIP", "NASA's lossless compression", {4, 8, 32}, 2, 2, true});
-        filters.push_back({H5Z_FILTER_NBIT, "NBIT", "N-bit compression", {}, 0, 0, false});
-        filters.push_back({H5Z_FILTER_SCALEOFFSET, "SCALEOFFSET", "Scale-offset compression", {}, 0, 0, false});
+            {H5Z_FILTER_GRANULARBR, "GRANULARBR", nullptr, "Granular Bit Rounding",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9}, {}, levelIfPositive, nullptr},
 
-        // 第三方过滤器（基于example文件夹）
-        filters.push_back({H5Z_FILTER_BITGROOM, "BITGROOM", "BitGrooming for floating-point data", {1, 2, 3}, 1, 1, true});
-        filters.push_back({H5Z_FILTER_BLOSC, "BLOSC", "Blosc meta-compressor", {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, 4, 4, true});
-        filters.push_back({H5Z_FILTER_BLOSC2, "BLOSC2", "Blosc2 meta-compressor", {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, 4, 4, true});
-        filters.push_back({H5Z_FILTER_BSHUF, "BSHUF", "Bitshuffle filter", {0, 1, 2}, 1, 1, true});
-        filters.push_back({H5Z_FILTER_BZIP2, "BZIP2", "Bzip2 compression", {1, 2, 3, 4, 5, 6, 7, 8, 9}, 1, 1, true});
-        filters.push_back({H5Z_FILTER_GRANULARBR, "GRANULARBR", "Granular Bit Rounding", {1, 2, 3}, 1, 1, true});
-        filters.push_back({H5Z_FILTER_LZ4, "LZ4", "LZ4 fast compression", {1, 2, 3, 4, 5, 6, 7, 8, 9}, 1, 1, true});
-        filters.push_back({H5Z_FILTER_LZF, "LZF", "LZF compression", {1, 2, 3}, 1, 1, true});
-        filters.push_back({H5Z_FILTER_ZFP, "ZFP", "ZFP floating-point compression", {1, 2, 3, 4}, 4, 4, true});
-        filters.push_back({H5Z_FILTER_ZSTD, "ZSTD", "Zstandard compression", {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19}, 1, 1, true});
-        filters.push_back({H5Z_FILTER_VBZ, "VBZ", "Nanopore VBZ compression for signal data", {1}, 4, 4, true});
+            // LZ4：唯一的参数是块大小（字节），没有压缩级别；插件不可用时不能静默跳过。
+            // 未指定块大小时由级别推出：级别 0 取 65535，其余取 UINT_MAX / 级别（实际上整个分块为一块）
+            {H5Z_FILTER_LZ4, "LZ4", nullptr, "Fast lossless compression algorithm",
+             H5Z_FLAG_MANDATORY, 0, 9, {1, 6, 9},
+             {{"block_size", "Block size in bytes, 0 derives it from the level", ParamType::Integer, 0, 0, 1 << 30, {0, 65536, 1 << 20}, {}}},
+             [](int level, const ParamValues &params)
+             {
+                 unsigned int block_size = static_cast<unsigned int>(params.at("block_size"));
+                 if (block_size == 0)
+                 {
+                     block_size = level <= 0 ? 65535 : std::numeric_limits<unsigned int>::max() / level;
+                 }
+                 return std::vector<unsigned int>{block_size};
+             },
+             nullptr},
 
-        return filters;
+            {H5Z_FILTER_LZF, "LZF", nullptr, "LZF compression algorithm",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9}, {}, levelIfPositive, nullptr},
+
+            {H5Z_FILTER_ZFP, "ZFP", nullptr, "ZFP floating-point compression",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9}, {}, levelIfPositive, nullptr},
+
+            // ZSTD：级别 1-9 映射到 zstd 的 1-20；自身的级别为 zstd 的 1-22
+            {H5Z_FILTER_ZSTD, "ZSTD", nullptr, "Zstandard compression by Facebook",
+             H5Z_FLAG_OPTIONAL, 0, 9, {1, 6, 9}, {},
+             [](int level, const ParamValues &)
+             { return std::vector<unsigned int>{static_cast<unsigned int>(level <= 0 ? 3 : clampLevel(level * 20 / 9, 20))}; },
+             nullptr, 1, 22,
+             [](int level, const ParamValues &)
+             { return std::vector<unsigned int>{static_cast<unsigned int>(level)}; }},
+
+            // VBZ：版本、整数大小、是否 delta zigzag、zstd 级别
+            // Oxford Nanopore 用它压缩原始信号（有符号整数）：streamvbyte + zstd
+            {H5Z_FILTER_VBZ, "VBZ", nullptr, "Nanopore VBZ compression for signal data",
+             H5Z_FLAG_OPTIONAL, 0, 22, {1, 6, 9},
+             {{"version", "StreamVByte code layout (0: 1-4 byte codes, 1: 0/1/2/4 byte codes)", ParamType::Integer, 1, 0, 1, {0, 1}, {}},
+              {"integer_size", "Integer size in bytes", ParamType::Integer, 2, 1, 8, {2}, {}},
+              {"delta_zigzag", "Delta and zigzag encode before StreamVByte", ParamType::Boolean, 1, 0, 1, {0, 1}, {}}},
+             [](int level, const ParamValues &params)
+             {
+                 return std::vector<unsigned int>{
+                     static_cast<unsigned int>(params.at("version")),
+                     static_cast<unsigned int>(params.at("integer_size")),
+                     static_cast<unsigned int>(params.at("delta_zigzag")),
+                     static_cast<unsigned int>(level > 0 ? level : 3)};
+             },
+             nullptr},
+
+            // VBZ_NATIVE：进程内实现的 VBZ（vbz_filter.cpp），格式与 32020 相同，以测试用 ID 注册以便与插件对比；
+            // 级别 0 表示不做 zstd，扩展参数为 zstd 窗口、分批元素数和指令集
+            {H5Z_FILTER_VBZ_NATIVE, "VBZ_NATIVE", "VBZN", "In-tree SIMD VBZ (delta, zigzag, StreamVByte, zstd)",
+             H5Z_FLAG_MANDATORY, 0, 22, {0, 1, 6, 9},
+             {{"version", "StreamVByte code layout (0: 1-4 byte codes, 1: 0/1/2/4 byte codes)", ParamType::Integer, 1, 0, 1, {0, 1}, {}},
+              {"window_log", "zstd window size as log2, 0 keeps the level default", ParamType::Integer, 0, 0, 27, {0, 20, 24}, {}},
+              {"block_elements", "Elements per SIMD staging block, 0 uses 16384", ParamType::Integer, 0, 0, 1 << 24, {0, 4096, 65536}, {}},
+              {"isa", "Instruction set for the SIMD kernels", ParamType::Choice, 0, 0, 4, {0, 1, 2, 3},
+               {{"auto", 0}, {"scalar", 1}, {"sse41", 2}, {"avx2", 3}, {"neon", 4}}}},
+             [](int level, const ParamValues &params)
+             {
+                 return std::vector<unsigned int>{
+                     static_cast<unsigned int>(params.at("version")),
+                     2,
+                     1,
+                     static_cast<unsigned int>(clampLevel(level, 22)),
+                     static_cast<unsigned int>(params.at("window_log")),
+                     static_cast<unsigned int>(params.at("block_elements")),
+                     static_cast<unsigned int>(params.at("isa"))};
+             },
+             nullptr},
+        };
+
+        std::string toLower(std::string text)
+        {
+            std::transform(text.begin(), text.end(), text.begin(),
+                           [](unsigned char c)
+                           { return static_cast<char>(std::tolower(c)); });
+            return text;
+        }
+    } // namespace
+
+    const std::initializer_list<FilterSpec> &allFilters()
+    {
+        return kFilters;
     }
 
-    FilterInfo getFilterInfo(const std::string &filter_name)
+    const FilterSpec *findFilter(const std::string &filter_name)
     {
-        auto filters = getAllFilters();
-        for (const auto &filter : filters)
+        for (const auto &filter : kFilters)
         {
-            if (filter.name == filter_name)
+            if (filter_name == filter.name || (filter.alias != nullptr && filter_name == filter.alias))
             {
-                return filter;
+                return &filter;
             }
         }
-
-        // 返回默认的未知过滤器
-        return {-1, filter_name, "Unknown filter", {}, 0, 0, false};
+        return nullptr;
     }
 
-    FilterInfo getFilterInfo(int filter_id)
+    const FilterSpec *findFilter(int filter_id)
     {
-        auto filters = getAllFilters();
-        for (const auto &filter : filters)
+        for (const auto &filter : kFilters)
         {
             if (filter.filter_id == filter_id)
             {
-                return filter;
+                return &filter;
             }
         }
+        return nullptr;
+    }
 
-        // 返回默认的未知过滤器
-        return {filter_id, "UNKNOWN", "Unknown filter", {}, 0, 0, false};
+    const ParamSpec *findParam(const FilterSpec &filter, const std::string &param_name)
+    {
+        for (const auto &param : filter.params)
+        {
+            if (param_name == param.name)
+            {
+                return &param;
+            }
+        }
+        return nullptr;
     }
 
-    std::vector<unsigned int> getDefaultFilterParams(int filter_id, int compression_level)
+    bool parseParamValue(const ParamSpec &param, const std::string &text, int &value)
     {
-        std::vector<unsigned int> params;
+        std::string lower = toLower(text);
+        bool parsed = false;
+        if (param.type == ParamType::Choice)
+        {
+            for (const auto &choice : param.choices)
+            {
+                if (lower == choice.label)
+                {
+                    value = choice.value;
+                    parsed = true;
+                }
+            }
+        }
+        else if (param.type == ParamType::Boolean)
+        {
+            if (lower == "true" || lower == "yes" || lower == "on")
+            {
+                value = 1;
+                parsed = true;
+            }
+            else if (lower == "false" || lower == "no" || lower == "off")
+            {
+                value = 0;
+                parsed = true;
+            }
+        }
 
-        // 基于example文件夹中的示例程序设置默认参数
-        switch (filter_id)
+        if (!parsed)
         {
-        case H5Z_FILTER_DEFLATE:
-            params.push_back(compression_level > 0 ? compression_level : 6);
-            break;
-        case H5Z_FILTER_BZIP2:
-            params.push_back(compression_level > 0 ? compression_level : 2);
-            break;
-        case H5Z_FILTER_LZ4:
-            // LZ4参数：块大小（以字节为单位）
-            params.push_back(65536); // 默认64KB块
-            break;
-        case H5Z_FILTER_ZSTD:
-            params.push_back(compression_level > 0 ? compression_level : 3);
-            break;
-        case H5Z_FILTER_BLOSC:
-            // BLOSC参数：压缩级别、压缩器类型、块大小、类型大小
-            params.push_back(compression_level > 0 ? compression_level : 5);
-            params.push_back(1); // blosclz压缩器
-            params.push_back(0); // 自动块大小
-            params.push_back(4); // 类型大小（假设为4字节整数）
-            break;
-        case H5Z_FILTER_BLOSC2:
-            params.push_back(compression_level > 0 ? compression_level : 5);
-            params.push_back(1); // blosclz压缩器
-            params.push_back(0); // 自动块大小
-            params.push_back(4); // 类型大小
-            break;
-        case H5Z_FILTER_SZIP:
-            params.push_back(4);  // 编码选项
-            params.push_back(32); // 像素每块
-            break;
-        case H5Z_FILTER_ZFP:
-            // ZFP参数：精度、准确度、速率、可逆
-            params.push_back(32); // 精度模式
-            params.push_back(0);  // 精度值
-            params.push_back(0);  // 准确度
-            params.push_back(0);  // 速率
-            break;
-        case H5Z_FILTER_VBZ:
-            // VBZ参数：版本、整数大小、使用delta zigzag压缩、ZSTD压缩级别
-            params.push_back(1);                                             // 版本
-            params.push_back(2);                                             // 整数大小（2字节）
-            params.push_back(1);                                             // 使用delta zigzag压缩
-            params.push_back(compression_level > 0 ? compression_level : 3); // ZSTD压缩级别
-            break;
-        default:
-            // 对于其他过滤器，使用默认参数
-            if (compression_level > 0)
+            char *end = nullptr;
+            long number = std::strtol(text.c_str(), &end, 10);
+            if (text.empty() || *end != '\0')
             {
-                params.push_back(compression_level);
+                return false;
             }
-            break;
+            value = static_cast<int>(number);
         }
 
-        return params;
+        if (value < param.min_value || value > param.max_value)
+        {
+            return false;
+        }
+        if (param.type == ParamType::Choice)
+        {
+            return std::any_of(param.choices.begin(), param.choices.end(),
+                               [value](const ParamChoice &choice)
+                               { return choice.value == value; });
+        }
+        return true;
+    }
+
+    std::string formatParamValue(const ParamSpec &param, int value)
+    {
+        for (const auto &choice : param.choices)
+        {
+            if (choice.value == value)
+            {
+                return choice.label;
+            }
+        }
+        return std::to_string(value);
     }
 
-    std::string getFilterParamsDescription(int filter_id, const std::vector<unsigned int> &params)
+    bool resolveParams(const FilterSpec &filter, const std::string &parameters,
+                       ParamValues &values, std::string &error)
     {
-        std::string description;
+        values.clear();
+        for (const auto &param : filter.params)
+        {
+            values[param.name] = param.default_value;
+        }
+        if (parameters.empty())
+        {
+            return true;
+        }
 
-        switch (filter_id)
+        for (const auto &assignment : Utils::split(parameters, ','))
         {
-        case H5Z_FILTER_DEFLATE:
-            if (!params.empty())
+            size_t pos = assignment.find('=');
+            std::string name = assignment.substr(0, pos);
+            size_t dot = name.find('.');
+            if (dot != std::string::npos)
             {
-                description = "Compression level: " + std::to_string(params[0]);
+                // 管线中其他过滤器的参数
+                if (name.substr(0, dot) != filter.name)
+                {
+                    continue;
+                }
+                name = name.substr(dot + 1);
             }
-            break;
-        case H5Z_FILTER_BZIP2:
-            if (!params.empty())
+            const ParamSpec *param = findParam(filter, name);
+            if (param == nullptr)
             {
-                description = "Compression level: " + std::to_string(params[0]);
+                error = "unknown parameter '" + name + "' for " + filter.name;
+                return false;
             }
-            break;
-        case H5Z_FILTER_LZ4:
-            if (!params.empty())
+            int value = 0;
+            if (pos == std::string::npos || !parseParamValue(*param, assignment.substr(pos + 1), value))
             {
-                description = "Block size: " + std::to_string(params[0]) + " bytes";
+                error = "invalid value for parameter '" + name + "' of " + filter.name;
+                return false;
             }
-            break;
-        case H5Z_FILTER_ZSTD:
-            if (!params.empty())
+            values[name] = value;
+        }
+        return true;
+    }
+
+    bool buildCdValues(const FilterSpec &filter, int level, const std::string &parameters,
+                       std::vector<unsigned int> &cd_values, std::string &error)
+    {
+        if (level < filter.min_level || level > filter.max_level)
+        {
+            error = "compression level " + std::to_string(level) + " out of range [" +
+                    std::to_string(filter.min_level) + ", " + std::to_string(filter.max_level) + "] for " + filter.name;
+            return false;
+        }
+        ParamValues values;
+        if (!resolveParams(filter, parameters, values, error))
+        {
+            return false;
+        }
+        cd_values = filter.build(level, values);
+        return true;
+    }
+
+    bool buildNativeCdValues(const FilterSpec &filter, int native_level, const std::string &parameters,
+                             std::vector<unsigned int> &cd_values, std::string &error)
+    {
+        if (filter.native_build == nullptr)
+        {
+            return buildCdValues(filter, native_level, parameters, cd_values, error);
+        }
+        if (native_level < filter.native_min_level || native_level > filter.native_max_level)
+        {
+            error = "native level " + std::to_string(native_level) + " out of range [" +
+                    std::to_string(filter.native_min_level) + ", " + std::to_string(filter.native_max_level) +
+                    "] for " + filter.name;
+            return false;
+        }
+        ParamValues values;
+        if (!resolveParams(filter, parameters, values, error))
+        {
+            return false;
+        }
+        cd_values = filter.native_build(native_level, values);
+        return true;
+    }
+
+    herr_t applyFilter(hid_t dcpl_id, const FilterSpec &filter, const std::vector<unsigned int> &cd_values)
+    {
+        if (filter.apply != nullptr)
+        {
+            return filter.apply(dcpl_id, cd_values);
+        }
+        return H5Pset_filter(dcpl_id, filter.filter_id, filter.flags, cd_values.size(), cd_values.data());
+    }
+
+    bool parsePipeline(const std::string &spec, std::vector<PipelineStage> &stages, std::string &error)
+    {
+        stages.clear();
+        std::string normalized = spec;
+        std::replace(normalized.begin(), normalized.end(), '+', '>');
+        for (const auto &text : Utils::split(normalized, '>'))
+        {
+            PipelineStage stage;
+            std::string name = text;
+            size_t colon = text.find(':');
+            if (colon != std::string::npos)
+            {
+                name = text.substr(0, colon);
+                char *end = nullptr;
+                std::string level_text = text.substr(colon + 1);
+                stage.level = static_cast<int>(std::strtol(level_text.c_str(), &end, 10));
+                if (level_text.empty() || *end != '\0')
+                {
+                    error = "invalid level in pipeline stage '" + text + "'";
+                    return false;
+                }
+                stage.fixed_level = true;
+            }
+            stage.filter = findFilter(name);
+            if (stage.filter == nullptr)
+            {
+                error = "unknown filter '" + name + "'";
+                return false;
+            }
+            stages.push_back(stage);
+        }
+        if (stages.empty())
+        {
+            error = "empty filter pipeline";
+            return false;
+        }
+        return true;
+    }
+
+    std::string pipelineTag(const std::string &spec)
+    {
+        std::string tag;
+        for (char c : spec)
+        {
+            if (c == '>' || c == '+')
+            {
+                tag += '+';
+            }
+            else if (c == ':')
             {
-                description = "Compression level: " + std::to_string(params[0]);
+                tag += "-L";
             }
-            break;
-        case H5Z_FILTER_BLOSC:
-            if (params.size() >= 4)
-            {
-                description = "Level: " + std::to_string(params[0]) +
-                              ", Compressor: " + std::to_string(params[1]) +
-                              ", Block size: " + (params[2] == 0 ? "auto" : std::to_string(params[2])) +
-                              ", Type size: " + std::to_string(params[3]);
-            }
-            break;
-        case H5Z_FILTER_SZIP:
-            if (params.size() >= 2)
-            {
-                description = "Encoding: " + std::to_string(params[0]) +
-                              ", Pixels per block: " + std::to_string(params[1]);
-            }
-            break;
-        case H5Z_FILTER_ZFP:
-            if (params.size() >= 4)
-            {
-                description = "Mode: " + std::to_string(params[0]) +
-                              ", Precision: " + std::to_string(params[1]) +
-                              ", Accuracy: " + std::to_string(params[2]) +
-                              ", Rate: " + std::to_string(params[3]);
-            }
-            break;
-        default:
-            if (!params.empty())
-            {
-                description = "Parameters: ";
-                for (size_t i = 0; i < params.size(); ++i)
+            else
+            {
+                tag += c;
+            }
+        }
+        return tag;
+    }
+
+    std::vector<std::string> expandGrid(const FilterSpec &filter,
+                                        const std::map<std::string, std::vector<int>> &overrides,
+                                        bool full_grid,
+                                        bool qualified)
+    {
+        // 每个需要扫描的参数是网格的一个维度，按表中的参数顺序展开
+        std::vector<std::pair<const ParamSpec *, std::vector<int>>> axes;
+        for (const auto &param : filter.params)
+        {
+            auto it = overrides.find(param.name);
+            if (it != overrides.end() && !it->second.empty())
+            {
+                axes.emplace_back(&param, it->second);
+            }
+            else if (full_grid && param.grid.size() > 1)
+            {
+                axes.emplace_back(&param, std::vector<int>(param.grid.begin(), param.grid.end()));
+            }
+        }
+
+        std::vector<std::string> points = {""};
+        for (const auto &axis : axes)
+        {
+            std::vector<std::string> next;
+            for (const auto &prefix : points)
+            {
+                for (int value : axis.second)
                 {
-                    if (i > 0)
-                        description += ", ";
-                    description += std::to_string(params[i]);
+                    next.push_back((prefix.empty() ? "" : prefix + ",") +
+                                   (qualified ? std::string(filter.name) + "." : "") + axis.first->name + "=" +
+                                   formatParamValue(*axis.first, value));
                 }
             }
-            break;
+            points.swap(next);
         }
+        return points;
+    }
 
-        return description.empty() ? "Default parameters" : description;
+    std::vector<std::string> expandPipelineGrid(const std::vector<PipelineStage> &stages,
+                                                const std::map<std::string, std::map<std::string, std::vector<int>>> &overrides,
+                                                bool full_grid)
+    {
+        std::vector<std::string> points = {""};
+        for (const auto &stage : stages)
+        {
+            auto it = overrides.find(stage.filter->name);
+            std::vector<std::string> stage_points =
+                expandGrid(*stage.filter,
+                           it != overrides.end() ? it->second : std::map<std::string, std::vector<int>>(),
+                           full_grid, stages.size() > 1);
+            std::vector<std::string> next;
+            for (const auto &prefix : points)
+            {
+                for (const auto &point : stage_points)
+                {
+                    next.push_back(prefix.empty() || point.empty() ? prefix + point : prefix + "," + point);
+                }
+            }
+            points.swap(next);
+        }
+        return points;
+    }
+
+    std::string parameterTag(const std::string &parameters)
+    {
+        std::string tag;
+        for (char c : parameters)
+        {
+            if (c == ',')
+            {
+                tag += '_';
+            }
+            else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+            {
+                tag += c;
+            }
+            else
+            {
+                tag += '-';
+            }
+        }
+        return tag;
+    }
+
+    std::string describeCdValues(const std::vector<unsigned int> &cd_values)
+    {
+        std::stringstream ss;
+        ss << "cd_values {";
+        for (size_t i = 0; i < cd_values.size(); ++i)
+        {
+            ss << (i > 0 ? ", " : "") << cd_values[i];
+        }
+        ss << "}";
+        return ss.str();
     }
 
 } // namespace FilterDefinitions
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <initializer_list>
 #include <hdf5.h>
 
 // 过滤器ID定义（基于example文件夹中的示例程序）
@@ -18,6 +19,8 @@
 #define H5Z_FILTER_ZFP 32013
 #define H5Z_FILTER_ZSTD 32015
 #define H5Z_FILTER_VBZ 32020
+// 进程内 VBZ 实现（vbz_filter.cpp）使用的 ID，取自 HDF5 保留给测试的 256-511 区间
+#define H5Z_FILTER_VBZ_NATIVE 400
 
 // 标准HDF5过滤器ID
 #define H5Z_FILTER_DEFLATE 1
@@ -27,57 +30,130 @@
 #define H5Z_FILTER_NBIT 5
 #define H5Z_FILTER_SCALEOFFSET 6
 
+// 过滤器注册表：每个过滤器的 ID、名称、参数定义、级别范围和 cd_values 构造函数集中在
+// filter_definitions.cpp 的一张编译期常量表中，新增编解码器只需增加一个表项
 namespace FilterDefinitions
 {
 
-    // 过滤器信息结构
-    struct FilterInfo
+    enum class ParamType
+    {
+        Integer,
+        Boolean,
+        Choice // 取值为 choices 中的某一项，命令行可用标签或数值
+    };
+
+    struct ParamChoice
+    {
+        const char *label;
+        int value;
+    };
+
+    // 过滤器的一个可调参数
+    struct ParamSpec
+    {
+        const char *name;
+        const char *description;
+        ParamType type;
+        int default_value;
+        int min_value;
+        int max_value;
+        std::initializer_list<int> grid; // --param-grid 时扫描的取值
+        std::initializer_list<ParamChoice> choices;
+    };
+
+    // 参数名 → 取值，未指定的参数已填入默认值
+    using ParamValues = std::map<std::string, int>;
+
+    // 由压缩级别与参数构造 cd_values
+    using CdValuesBuilder = std::vector<unsigned int> (*)(int level, const ParamValues &params);
+
+    // 把过滤器加入数据集创建属性；为空时使用 H5Pset_filter(filter_id, flags, cd_values)
+    using FilterSetter = herr_t (*)(hid_t dcpl_id, const std::vector<unsigned int> &cd_values);
+
+    struct FilterSpec
     {
         int filter_id;
-        std::string name;
-        std::string description;
-        std::vector<int> supported_levels;
-        size_t min_params;
-        size_t max_params;
-        bool requires_chunking;
+        const char *name;
+        const char *alias; // 另一个可接受的名称，没有时为 nullptr
+        const char *description;
+        unsigned int flags; // H5Z_FLAG_MANDATORY 的过滤器在库中不可用时直接失败
+        int min_level;
+        int max_level;
+        std::initializer_list<int> sweep_levels; // 默认扫描的级别
+        std::initializer_list<ParamSpec> params;
+        CdValuesBuilder build;
+        FilterSetter apply;
+        // 编解码器自身的级别（策略文件中固定的级别）：范围与 cd_values 构造。
+        // native_build 为空时扫描级别就是编解码器自身的级别，两种写法相同
+        int native_min_level = 0;
+        int native_max_level = 0;
+        CdValuesBuilder native_build = nullptr;
     };
 
-    // 获取所有可用过滤器的信息
-    std::vector<FilterInfo> getAllFilters();
-
-    // 根据过滤器名称获取过滤器信息
-    FilterInfo getFilterInfo(const std::string &filter_name);
-
-    // 根据过滤器ID获取过滤器信息
-    FilterInfo getFilterInfo(int filter_id);
-
-    // 获取过滤器的默认参数
-    std::vector<unsigned int> getDefaultFilterParams(int filter_id, int compression_level = -1);
-
-    // 获取过滤器的参数描述
-    std::string getFilterParamsDescription(int filter_id, const std::vector<unsigned int> &params);
-
-    // 支持的过滤器名称列表
-    const std::vector<std::string> SUPPORTED_FILTERS = {
-        "GZIP",        // H5Z_FILTER_DEFLATE
-        "SHUFFLE",     // H5Z_FILTER_SHUFFLE
-        "FLETCHER32",  // H5Z_FILTER_FLETCHER32
-        "SZIP",        // H5Z_FILTER_SZIP
-        "NBIT",        // H5Z_FILTER_NBIT
-        "SCALEOFFSET", // H5Z_FILTER_SCALEOFFSET
-        "BITGROOM",    // H5Z_FILTER_BITGROOM
-        "BLOSC",       // H5Z_FILTER_BLOSC
-        "BLOSC2",      // H5Z_FILTER_BLOSC2
-        "BSHUF",       // H5Z_FILTER_BSHUF
-        "BZIP2",       // H5Z_FILTER_BZIP2
-        "GRANULARBR",  // H5Z_FILTER_GRANULARBR
-        "LZ4",         // H5Z_FILTER_LZ4
-        "LZF",         // H5Z_FILTER_LZF
-        "ZFP",         // H5Z_FILTER_ZFP
-        "ZSTD",        // H5Z_FILTER_ZSTD
-        "VBZ"          // H5Z_FILTER_VBZ
+    // 注册表中的全部过滤器，按表中顺序
+    const std::initializer_list<FilterSpec> &allFilters();
+
+    // 按名称（或别名）/ ID 查找，找不到时返回 nullptr
+    const FilterSpec *findFilter(const std::string &filter_name);
+    const FilterSpec *findFilter(int filter_id);
+
+    const ParamSpec *findParam(const FilterSpec &filter, const std::string &param_name);
+
+    // 解析单个参数值（数值或 choices 标签）并检查范围
+    bool parseParamValue(const ParamSpec &param, const std::string &text, int &value);
+    std::string formatParamValue(const ParamSpec &param, int value);
+
+    // 过滤器管线中的一级。规格写作 "SHUFFLE>ZSTD:9"（也可用 '+' 分隔），":级别" 固定该级的级别，
+    // 未固定级别的各级使用扫描中的压缩级别
+    struct PipelineStage
+    {
+        const FilterSpec *filter = nullptr;
+        int level = 0;
+        bool fixed_level = false;
     };
 
+    // 解析管线规格；单个过滤器名称是只有一级的管线
+    bool parsePipeline(const std::string &spec, std::vector<PipelineStage> &stages, std::string &error);
+
+    // 管线规格转换为可用于文件名的标签，例如 "SHUFFLE>ZSTD:9" → "SHUFFLE+ZSTD-L9"
+    std::string pipelineTag(const std::string &spec);
+
+    // 把 "name=value,name=value" 解析为完整的参数表（未出现的参数取默认值）。
+    // 管线中的参数写作 "FILTER.name=value"，前缀不是本过滤器的项被忽略
+    bool resolveParams(const FilterSpec &filter, const std::string &parameters,
+                       ParamValues &values, std::string &error);
+
+    // 检查级别范围并构造 cd_values
+    bool buildCdValues(const FilterSpec &filter, int level, const std::string &parameters,
+                       std::vector<unsigned int> &cd_values, std::string &error);
+
+    // 按编解码器自身的级别构造 cd_values，不经过扫描级别的映射（例如 ZSTD 19 即 zstd 的 19 级，
+    // 而扫描级别 9 映射为 zstd 的 20 级）
+    bool buildNativeCdValues(const FilterSpec &filter, int native_level, const std::string &parameters,
+                             std::vector<unsigned int> &cd_values, std::string &error);
+
+    // 把过滤器加入数据集创建属性
+    herr_t applyFilter(hid_t dcpl_id, const FilterSpec &filter, const std::vector<unsigned int> &cd_values);
+
+    // 参数网格展开：overrides 中给出的参数扫描指定取值，full_grid 时其余参数扫描表中的 grid，
+    // 返回每个网格点的 "name=value,..." 字符串（qualified 时写作 "FILTER.name=value"）；
+    // 没有需要扫描的参数时返回 {""}
+    std::vector<std::string> expandGrid(const FilterSpec &filter,
+                                        const std::map<std::string, std::vector<int>> &overrides,
+                                        bool full_grid,
+                                        bool qualified = false);
+
+    // 管线各级参数网格的笛卡尔积；多于一级时参数名带过滤器前缀
+    std::vector<std::string> expandPipelineGrid(const std::vector<PipelineStage> &stages,
+                                                const std::map<std::string, std::map<std::string, std::vector<int>>> &overrides,
+                                                bool full_grid);
+
+    // 参数字符串转换为可用于文件名的标签，例如 "compressor=lz4,shuffle=bit" → "compressor-lz4_shuffle-bit"
+    std::string parameterTag(const std::string &parameters);
+
+    // cd_values 的可读描述
+    std::string describeCdValues(const std::vector<unsigned int> &cd_values);
+
 } // namespace FilterDefinitions
 
 #endif // FILTER_DEFINITIONS_HPP
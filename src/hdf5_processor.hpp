@@ -4,19 +4,203 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <utility>
 #include <hdf5.h>
 #include <hdf5_hl.h>
+#include "statistics.hpp"
+#include "chunk_tuner.hpp"
+#include "codec_selector.hpp"
+#include "perf_counters.hpp"
+#include "resource_usage.hpp"
+#include "read_table.hpp"
+#include "counting_vfd.hpp"
+#include "mapped_source.hpp"
+#include "dataset_inventory.hpp"
+#include "metadata_replicator.hpp"
+
+// testCompression 各阶段耗时（纳秒，steady_clock）
+struct PhaseTimings
+{
+    long long source_open_ns = 0;    // 打开源文件并创建目标文件
+    long long metadata_copy_ns = 0;  // 复制 Signal 以外的对象与组（MetadataReplicator，不含下面三个数据集阶段）
+    long long source_read_ns = 0;    // 打开并读取源 Signal 数据集（含 VBZ 解码）
+    long long dataset_create_ns = 0; // 设置 dcpl 并 H5Dcreate 目标数据集
+    long long encode_write_ns = 0;   // H5Dwrite 与关闭目标数据集，包含过滤器编码
+    long long flush_close_ns = 0;    // 目标文件刷新与关闭
+
+    long long totalNs() const
+    {
+        return source_open_ns + metadata_copy_ns + source_read_ns +
+               dataset_create_ns + encode_write_ns + flush_close_ns;
+    }
+};
+
+// 流水线模式（--pipeline）下各阶段的忙碌时间，利用率 = 忙碌时间 / (线程数 × 流水线总耗时)
+struct PipelineStats
+{
+    long long wall_ns = 0;         // 从启动读取线程到写入线程结束
+    long long reader_busy_ns = 0;  // 读取源数据集（arena 模式下只做分块划分）
+    long long encoder_busy_ns = 0; // 所有编码线程的编码耗时之和
+    long long writer_busy_ns = 0;  // H5Dwrite_chunk（或回退时的 H5Dwrite）
+    long long reader_blocked_ns = 0; // 读取线程因队列满或在途内存超限而等待
+    int encoder_threads = 0;
+    size_t chunks = 0;
+    size_t peak_inflight_bytes = 0;
+
+    double readerUtilization() const { return wall_ns > 0 ? static_cast<double>(reader_busy_ns) / wall_ns : 0.0; }
+    double encoderUtilization() const
+    {
+        return wall_ns > 0 && encoder_threads > 0 ? static_cast<double>(encoder_busy_ns) / (static_cast<double>(wall_ns) * encoder_threads) : 0.0;
+    }
+    double writerUtilization() const { return wall_ns > 0 ? static_cast<double>(writer_busy_ns) / wall_ns : 0.0; }
+};
+
+// 过滤器管线中一级的编码开销：用进程内编码器对源数据逐级单独编码测得，
+// 没有进程内编码器的级（及其后各级）measured 为 false
+struct StageCost
+{
+    std::string filter_name;
+    bool measured = false;
+    size_t input_bytes = 0;
+    size_t output_bytes = 0;
+    long long encode_ns = 0;
+};
 
 struct CompressionResult
 {
     std::string filter_name;
     std::string parameters;
-    int compression_level;
-    double compression_ratio;
-    long long compression_time_ms;
-    long long decompression_time_ms;
-    size_t compressed_size_bytes;
-    size_t original_size_bytes;
+    int compression_level = 0;
+    double compression_ratio = 1.0;
+    long long compression_time_ms = 0;
+    long long decompression_time_ms = 0;
+    size_t compressed_size_bytes = 0;
+    size_t original_size_bytes = 0;
+
+    // 解压校验：重新打开输出文件，逐个读取 Signal 数据集并与源数据逐字节比较
+    double decompression_mbps = 0.0;  // 解码吞吐量（按解码后的字节数计算）
+    size_t verified_datasets = 0;     // 参与校验的数据集数量
+    size_t verification_failures = 0; // 与源数据不一致（或读取失败）的数据集数量
+    long long decompression_time_ns = 0;
+    size_t signal_bytes = 0; // 解码校验的 Signal 原始字节数
+
+    // 编码吞吐量（Signal 原始字节数 / 压缩耗时，MB/s）与运行期间进程常驻内存的峰值增量（字节，0 表示未测量）
+    double compression_mbps = 0.0;
+    size_t peak_memory_bytes = 0;
+
+    // --perf-counters：压缩（打开源文件到关闭目标文件）与解压校验两个阶段的计数器，未开启时 source 为空
+    CounterSample encode_counters;
+    CounterSample decode_counters;
+
+    // 运行期间的 getrusage / /proc/self/io 差值（压缩、解压校验与切片读取全过程）
+    ResourceUsage resources;
+
+    // --io-trace：计数 VFD 记录的 HDF5 I/O。源文件与目标文件为压缩阶段（打开源文件到关闭目标文件），
+    // decode_io 为解压校验时对输出文件的读取；core VFD（in_memory）的目标文件不经过计数驱动
+    IoStats source_io;
+    IoStats destination_io;
+    IoStats decode_io;
+
+    // 逐数据集明细（列式）：原始/压缩后大小与可单独归属的编码、解码耗时
+    ReadTable reads;
+
+    // 压缩过程的分阶段耗时，compression_time_ms 为各阶段之和
+    PhaseTimings phases;
+
+    // 目标文件是否只存在于内存中（core VFD，不写盘）
+    bool in_memory = false;
+
+    // 分块直写：编码线程数与直写的分块数，0 表示全部走过滤器管线
+    int encode_threads = 0;
+    size_t direct_chunks = 0;
+
+    // 流水线模式的各阶段统计，未使用流水线时 wall_ns 为 0
+    PipelineStats pipeline;
+
+    // 多级过滤器管线（如 SHUFFLE>ZSTD）每一级的开销，单个过滤器时为空
+    std::vector<StageCost> stage_costs;
+
+    // Signal 分块大小（元素数）：0 为整个数据集一个分块，ChunkTuner::kAuto 为按数据集自动调优
+    size_t chunk_elements = 0;
+    // 自动调优选中的分块大小及选中它的数据集数（分块大小, 数据集数）
+    std::vector<std::pair<size_t, size_t>> tuned_chunks;
+    long long chunk_tune_ns = 0; // 自动调优耗时，不计入压缩耗时
+    // 输出文件上随机切片读取的平均延迟（微秒，关闭分块缓存），未测量时为 0
+    double slice_read_us = 0.0;
+
+    // 可压缩性估计给出的压缩比（熵估计，不含剪枝放大系数），0 表示未估计
+    double estimated_ratio = 0.0;
+
+    // --filters auto：各候选管线被选中的数据集数（候选, 数据集数），"none" 表示没有候选能压缩该数据集
+    std::vector<std::pair<std::string, size_t>> codec_mix;
+    std::string codec_global_best; // 所有数据集统一使用一个候选时的最优候选，没有时为空
+    double codec_gain = 0.0;       // 样本上 统一最优候选的压缩后字节数 / 按数据集选择的压缩后字节数
+    size_t codec_fallbacks = 0;    // 没有候选满足吞吐量下限、改用解码最快候选的数据集数
+    long long codec_select_ns = 0; // 取样与候选测量耗时，不计入压缩耗时
+
+    // 解压校验使用的分块并行解码线程数，0 表示 H5Dread
+    int decode_threads = 0;
+    // 解码吞吐量随线程数的变化（线程数, MB/s），线程数 0 为 H5Dread 基准；未开启 --decode-scaling 时为空
+    std::vector<std::pair<int, double>> decode_scaling;
+
+    // 重复测量（--repeat）的统计摘要，单位毫秒；单次运行时 samples 为 1
+    TimingStats compression_stats;
+    TimingStats decompression_stats;
+
+    // 整个文件：输入文件与输出文件的字节数（in_memory 时为文件映像大小），file_ratio = 输入 / 输出
+    size_t input_file_bytes = 0;
+    size_t output_file_bytes = 0;
+    double file_ratio = 0.0;
+    // 按压缩策略类别统计的数据集存储开销（CompressionPolicy::classes() 的顺序），元数据复制失败时为空
+    std::vector<StorageClass> storage_classes;
+
+    // 非空表示该配置未能完成（打开/创建/遍历失败、工作进程崩溃或超时等）
+    std::string error;
+};
+
+class SignalArena;
+
+// 处理器运行选项
+struct ProcessorOptions
+{
+    // 使用 core VFD（backing store 关闭）在内存中创建目标文件，排除磁盘写入对计时的影响
+    bool in_memory = false;
+    // in_memory 模式下将最终的文件映像（H5Fget_file_image）写到输出路径，默认不写
+    bool dump_image = false;
+    // core VFD 每次扩展内存的步长
+    size_t core_increment_bytes = 64 * 1024 * 1024;
+    // 大于 0 时 Signal 分块由该数量的线程在进程内编码，再用 H5Dwrite_chunk 直接写入；
+    // 0 表示走 HDF5 过滤器管线（H5Dwrite）
+    int encode_threads = 0;
+    // 大于 0 时解压校验（以及源数据内存区的加载）由该数量的线程并行解码 H5Dread_chunk 读出的原始分块
+    int decode_threads = 0;
+    // 解压校验后再以 1..N 个解码线程重复解码，记录吞吐量曲线
+    bool decode_scaling = false;
+    // Signal 数据集改为 读取 → 编码线程池（encode_threads 个，至少 1 个）→ 写入 三阶段流水线
+    bool pipeline = false;
+    size_t pipeline_read_queue_depth = 8;
+    size_t pipeline_write_queue_depth = 8;
+    size_t pipeline_inflight_bytes = 256 * 1024 * 1024;
+    // Signal 数据集的分块大小（元素数），0 表示整个数据集一个分块，ChunkTuner::kAuto 表示按数据集自动调优；
+    // 分块字节数始终受 4 GiB 上限约束
+    size_t chunk_elements = 0;
+    // 自动调优的候选与权重，以及输出文件随机切片读取测量的次数与大小
+    ChunkTuner::Options chunk_tuning;
+    // --filters auto 的候选管线、吞吐量下限与样本大小
+    CodecSelector::Options codec_selection;
+    // 在压缩与解压校验阶段采集 perf_event_open 计数器（不可用时退回软件时钟）
+    bool perf_counters = false;
+    // 源文件、目标文件与解压校验读取经计数 VFD（包装 sec2）打开，记录每次 HDF5 I/O
+    bool io_trace = false;
+    // 非空时目标文件的写入与解压校验的读取按该存储模型限速（需要 io_trace），源文件不限速
+    StorageProfile throttle;
+    // 不使用内存区时映射源文件，连续、未压缩的 Signal 数据集直接从映射读取（零拷贝）
+    bool mmap_source = true;
+    // 输出文件从预先构建的元数据骨架（Signal 以外的全部对象）开始，只创建 Signal 数据集；为 false 时每个配置各自复制
+    bool metadata_skeleton = true;
+    // Signal 以外数据集的压缩策略（按路径模式复制或重新写出），默认全部原样复制
+    CompressionPolicy policy;
 };
 
 class HDF5Processor
@@ -33,6 +217,20 @@ public:
     HDF5Processor(HDF5Processor &&) noexcept;
     HDF5Processor &operator=(HDF5Processor &&) noexcept;
 
+    void setOptions(const ProcessorOptions &options) { options_ = options; }
+    const ProcessorOptions &getOptions() const { return options_; }
+
+    // 设置预先解码的源数据内存区（不接管所有权），为 nullptr 时每次从源文件读取
+    void setSourceArena(const SignalArena *arena) { arena_ = arena; }
+    // 设置输入文件的对象清单（不接管所有权），为 nullptr 或属于其他文件时每次调用遍历源文件
+    void setInventory(const DatasetInventory *inventory) { inventory_ = inventory; }
+
+    // 为输入文件构建一次元数据骨架（需要 metadata_skeleton），之后该文件的每个配置都从骨架开始
+    bool prepareMetadata(const std::string &input_file);
+    size_t skeletonBytes() const { return skeleton_.size(); }
+    long long skeletonBuildNs() const { return skeleton_build_ns_; }
+    const MetadataReplicator::Stats &skeletonStats() const { return skeleton_stats_; }
+
     // 压缩测试
     CompressionResult testCompression(
         const std::string &input_file,
@@ -44,6 +242,8 @@ public:
     // 工具函数
     static std::string getFilterDescription(const std::string &filter_name);
     static bool isFilterAvailable(const std::string &filter_name);
+    // 是否为需要重新压缩的 read_xxxx/Raw/Signal 数据集路径
+    static bool isSignalPath(const std::string &path);
 
 private:
     // HDF5对象管理
@@ -56,9 +256,66 @@ private:
         int rank;
     };
 
+    // 返回的 datatype、dataspace 由调用方关闭
     std::vector<DatasetInfo> findSignalDatasets(hid_t file_id);
+    // 属于 file_id 的对象清单：已设置的清单或遍历到 scanned 中的结果，遍历失败返回 nullptr
+    const DatasetInventory *inventoryFor(hid_t file_id, DatasetInventory &scanned) const;
+    // 以元数据骨架为内容创建输出文件（fapl_id 为 core VFD 时只在内存中），骨架不可用时返回 -1
+    hid_t openFromSkeleton(const std::string &input_file, const std::string &output_filename, hid_t fapl_id) const;
     size_t getDatasetSize(const DatasetInfo &info);
 
+    // 源数据集可在映射中直接访问且元素个数一致时返回其数据，否则返回 nullptr
+    const int16_t *mappedSignal(hid_t src_dset_id, size_t elements) const;
+
+    // 解压测试：读取输出文件中的全部 Signal 数据集并与源文件逐字节比较，结果写入result
+    // file_image 非空时从内存映像打开输出文件（in_memory 模式），否则按文件名打开
+    void verifyDecompression(hid_t src_file_id,
+                             const std::string &output_filename,
+                             const std::vector<unsigned char> *file_image,
+                             const std::vector<std::string> &signal_paths,
+                             CompressionResult &result);
+
+    // 解码一个数据集后的回调：路径、解码数据、元素个数、是否成功、该数据集的解码耗时（纳秒，分块并行解码时为 -1）
+    using DecodedCallback = std::function<void(const std::string &, const int16_t *, size_t, bool, long long)>;
+
+    // 解码 file_id 中的全部 Signal 数据集，threads 为 0 时逐个 H5Dread，否则使用分块并行解码引擎。
+    // 返回解码耗时（纳秒，不含回调），decoded_bytes 累加成功解码的字节数
+    long long decodeSignals(hid_t file_id,
+                            const std::vector<std::string> &signal_paths,
+                            int threads,
+                            size_t &decoded_bytes,
+                            const DecodedCallback &on_decoded);
+
+    // 对输出文件中数据集实际生效的过滤器管线逐级单独编码源数据，记录每一级的输入/输出字节数与耗时
+    void measureStageCosts(hid_t src_file_id,
+                           const std::string &output_filename,
+                           const std::vector<unsigned char> *file_image,
+                           const std::vector<std::string> &signal_paths,
+                           CompressionResult &result);
+
+    // 在输出文件的 Signal 数据集上做随机切片读取（关闭分块缓存），记录平均延迟
+    void measureSliceReads(const std::string &output_filename,
+                           const std::vector<unsigned char> *file_image,
+                           const std::vector<std::string> &signal_paths,
+                           CompressionResult &result);
+
+    // 以 H5Dread 以及 1、2、4…N 个解码线程分别完整解码输出文件，记录吞吐量曲线
+    void measureDecodeScaling(const std::string &output_filename,
+                              const std::vector<unsigned char> *file_image,
+                              const std::vector<std::string> &signal_paths,
+                              CompressionResult &result);
+
+    ProcessorOptions options_;
+    const SignalArena *arena_ = nullptr;
+    const DatasetInventory *inventory_ = nullptr;
+    std::unique_ptr<MappedSource> mapped_source_; // 同一输入文件的各配置之间复用
+    std::vector<unsigned char> skeleton_;         // 元数据骨架的文件映像
+    std::vector<MetadataReplicator::Extent> skeleton_raw_; // 骨架中的原始数据区段（只在 --io-trace 时收集）
+    std::string skeleton_source_;
+    MetadataReplicator::Stats skeleton_stats_;
+    long long skeleton_build_ns_ = 0;
+    std::unique_ptr<PerfCounters> counters_;
+
     // 时间测量
     static long long getCurrentTimeMs();
 };
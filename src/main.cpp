@@ -3,10 +3,14 @@
 #include <vector>
 #include <map>
 #include <cstdlib>
+#include <algorithm>
 #include "hdf5_processor.hpp"
 #include "compression_tester.hpp"
 #include "utils.hpp"
 #include "filter_definitions.hpp"
+#include "vbz_filter.hpp"
+#include "pareto_frontier.hpp"
+#include "storage_profile.hpp"
 
 #define FILTER_VBZ_ID 32020
 #define FILTER_VBZ_VERSION_OPTION 0
@@ -21,20 +25,103 @@ void printHelp()
     std::cout << "  hdf5_compression_bench [command] [options]\n\n";
     std::cout << "Commands:\n";
     std::cout << "  test            Run compression tests\n";
+    std::cout << "  filters         List registered filters and their parameters\n";
     std::cout << "  help            Show this help message\n\n";
     std::cout << "Options:\n";
     std::cout << "  --input FILE    Input file path\n";
     std::cout << "  --output FILE   Output file path\n";
     std::cout << "  --dir DIR       Output directory\n";
-    std::cout << "  --filters LIST  Comma-separated list of filters to test\n";
+    std::cout << "  --filters LIST  Comma-separated list of filters or pipelines to test, e.g. \"SHUFFLE>ZSTD:9,GZIP\"\n";
     std::cout << "  --levels LIST   Comma-separated list of compression levels\n";
     std::cout << "  --format FORMAT Output format (markdown, csv, json)\n";
     std::cout << "  --verbose       Enable verbose output\n";
+    std::cout << "  --in-memory     Create output files in memory (HDF5 core VFD), no disk writes\n";
+    std::cout << "  --dump-image    With --in-memory, write the final file images to the output directory\n";
+    std::cout << "  --repeat N      Measured runs per configuration (default 1)\n";
+    std::cout << "  --warmup K      Discarded warmup runs per configuration (default 0)\n";
+    std::cout << "  --no-arena      Re-read and decode the source file for every configuration\n";
+    std::cout << "  --no-mmap       Copy contiguous unfiltered source datasets instead of reading them from a mapping\n";
+    std::cout << "  --no-inventory-cache  Traverse the input file instead of reading or writing <input>.inventory\n";
+    std::cout << "  --no-skeleton   Copy the non-signal metadata into every output file instead of starting from a prebuilt image\n";
+    std::cout << "  --policy FILE   Policy for non-signal datasets, one \"PATTERN -> copy|PIPELINE [chunk=SIZE]\" rule per line,\n";
+    std::cout << "                  e.g. \"*/Fastq -> ZSTD:19\" (zstd level 19: policy levels are the codec's own levels,\n";
+    std::cout << "                  not sweep levels); the first matching rule wins (default: copy everything)\n";
+    std::cout << "  --jobs N        Run configurations in N parallel worker processes (default 1)\n";
+    std::cout << "  --job-timeout S Kill a worker after S seconds (default 0, no limit)\n";
+    std::cout << "  --encode-threads N  Encode signal chunks in N threads and write them with H5Dwrite_chunk\n";
+    std::cout << "  --decode-threads N  Decode signal chunks read with H5Dread_chunk in N threads (ingest and verification)\n";
+    std::cout << "  --decode-scaling    Record decode throughput for H5Dread and 1, 2, 4 ... N decoder threads\n";
+    std::cout << "  --pipeline          Write signals through a read -> encode -> write pipeline\n";
+    std::cout << "  --read-queue N      Pipeline read -> encode queue depth in chunks (default 8)\n";
+    std::cout << "  --write-queue N     Pipeline encode -> write queue depth in chunks (default 8)\n";
+    std::cout << "  --inflight-mb M     Pipeline limit on read but not yet written data (default 256)\n";
+    std::cout << "  --param F.NAME=V1,V2  Sweep parameter NAME of filter F over the given values (repeatable)\n";
+    std::cout << "  --param-grid        Sweep every filter parameter over its registered grid\n";
+    std::cout << "  --chunk-sizes LIST  Signal chunk sizes in elements to sweep, e.g. \"4K,64K,1M,full,auto\" (default full)\n";
+    std::cout << "  --tune-weights R,E,L  Auto-tune score weights for ratio, encode MB/s and slice read latency (default 1,1,1)\n";
+    std::cout << "  --slice-reads N     Random slice reads measured on each output file (default 32, 0 disables)\n";
+    std::cout << "  --slice-elements N  Elements per random slice read (default 4096)\n";
+    std::cout << "  --auto-candidates LIST  Candidate pipelines for --filters auto, e.g. \"SHUFFLE>GZIP:6,SZIP,VBZ_NATIVE:0\"\n";
+    std::cout << "  --auto-min-decode M     With --filters auto, only pick codecs decoding the sample at >= M MB/s\n";
+    std::cout << "  --auto-min-encode M     With --filters auto, only pick codecs encoding the sample at >= M MB/s\n";
+    std::cout << "  --auto-sample-kb N      Sample size taken from the start, middle and end of each read (default 16)\n";
+    std::cout << "  --no-prune              Run every configuration, even those the compressibility estimate rules out\n";
+    std::cout << "  --prune-margin X        Slack applied to the entropy ratio estimate before pruning (default 1.10)\n";
+    std::cout << "  --estimate-reads N      Signal datasets sampled for the compressibility estimate (default 16)\n";
+    std::cout << "  --estimate-elements N   Samples taken from the start of each of those datasets (default 65536)\n";
+    std::cout << "  --require EXPR          Constraint for the recommendation, e.g. decode_mbps>=500 (repeatable or comma-separated;\n";
+    std::cout << "                          metrics: ratio, encode_mbps, decode_mbps, peak_mem_mb)\n";
+    std::cout << "  --perf-counters         Record cycles, instructions, IPC, LLC and branch misses and context switches\n";
+    std::cout << "                          per MB with perf_event_open (falls back to software clocks)\n";
+    std::cout << "  --io-trace              Open the source, destination and verification files through a counting VFD\n";
+    std::cout << "                          (wraps sec2) and report HDF5 I/O calls, sizes, latency and write amplification\n";
+    std::cout << "  --throttle TIER         Emulate a storage tier on the destination: nvme, sata_ssd, hdd, nfs or\n";
+    std::cout << "                          READ_MBPS:WRITE_MBPS:LATENCY_US (implies --io-trace)\n";
+}
+
+void printFilters()
+{
+    VbzFilter::registerFilters();
+    std::cout << "Registered filters:\n";
+    for (const auto &filter : FilterDefinitions::allFilters())
+    {
+        std::cout << "  " << filter.name << " (id " << filter.filter_id << ")";
+        if (filter.alias != nullptr)
+        {
+            std::cout << ", alias " << filter.alias;
+        }
+        std::cout << ": " << filter.description << ", levels " << filter.min_level << "-" << filter.max_level;
+        if (filter.native_build != nullptr)
+        {
+            std::cout << " (policy levels " << filter.native_min_level << "-" << filter.native_max_level << ")";
+        }
+        std::cout << (H5Zfilter_avail(filter.filter_id) > 0 ? "" : " [not available]") << "\n";
+        if (filter.filter_id == H5Z_FILTER_VBZ_NATIVE)
+        {
+            std::cout << "      SIMD kernels: " << VbzFilter::isaName(VbzFilter::resolveIsa(VbzFilter::Isa::Auto))
+#ifdef HAVE_ZSTD
+                      << ", zstd levels 0-22\n";
+#else
+                      << ", built without zstd (level 0 only)\n";
+#endif
+        }
+        for (const auto &param : filter.params)
+        {
+            std::cout << "      " << param.name << " = " << FilterDefinitions::formatParamValue(param, param.default_value)
+                      << "  " << param.description << " (grid:";
+            for (int value : param.grid)
+            {
+                std::cout << " " << FilterDefinitions::formatParamValue(param, value);
+            }
+            std::cout << ")\n";
+        }
+    }
 }
 
 int runTests(const std::vector<std::string> &args)
 {
     CompressionTester::TestConfig config;
+    std::string report_format = "markdown";
     config.verbose = false;
     config.test_all_levels = true;
     config.include_shuffle = true;
@@ -59,10 +146,218 @@ int runTests(const std::vector<std::string> &args)
         {
             config.verbose = true;
         }
+        else if (args[i] == "--in-memory")
+        {
+            config.in_memory = true;
+        }
+        else if (args[i] == "--dump-image")
+        {
+            config.dump_image = true;
+        }
+        else if (args[i] == "--repeat" && i + 1 < args.size())
+        {
+            config.repeat = std::max(1, std::atoi(args[++i].c_str()));
+        }
+        else if (args[i] == "--warmup" && i + 1 < args.size())
+        {
+            config.warmup = std::max(0, std::atoi(args[++i].c_str()));
+        }
+        else if (args[i] == "--no-arena")
+        {
+            config.use_arena = false;
+        }
+        else if (args[i] == "--no-mmap")
+        {
+            config.mmap_source = false;
+        }
+        else if (args[i] == "--no-inventory-cache")
+        {
+            config.inventory_cache = false;
+        }
+        else if (args[i] == "--no-skeleton")
+        {
+            config.metadata_skeleton = false;
+        }
+        else if (args[i] == "--policy" && i + 1 < args.size())
+        {
+            std::string error;
+            if (!config.policy.load(args[++i], error))
+            {
+                std::cerr << "Invalid --policy: " << error << std::endl;
+                return 1;
+            }
+        }
+        else if (args[i] == "--jobs" && i + 1 < args.size())
+        {
+            config.jobs = std::max(1, std::atoi(args[++i].c_str()));
+        }
+        else if (args[i] == "--job-timeout" && i + 1 < args.size())
+        {
+            config.job_timeout = std::max(0, std::atoi(args[++i].c_str()));
+        }
+        else if (args[i] == "--encode-threads" && i + 1 < args.size())
+        {
+            config.encode_threads = std::max(0, std::atoi(args[++i].c_str()));
+        }
+        else if (args[i] == "--decode-threads" && i + 1 < args.size())
+        {
+            config.decode_threads = std::max(0, std::atoi(args[++i].c_str()));
+        }
+        else if (args[i] == "--decode-scaling")
+        {
+            config.decode_scaling = true;
+        }
+        else if (args[i] == "--pipeline")
+        {
+            config.pipeline = true;
+        }
+        else if (args[i] == "--read-queue" && i + 1 < args.size())
+        {
+            config.read_queue_depth = static_cast<size_t>(std::max(1, std::atoi(args[++i].c_str())));
+        }
+        else if (args[i] == "--write-queue" && i + 1 < args.size())
+        {
+            config.write_queue_depth = static_cast<size_t>(std::max(1, std::atoi(args[++i].c_str())));
+        }
+        else if (args[i] == "--inflight-mb" && i + 1 < args.size())
+        {
+            config.inflight_mb = static_cast<size_t>(std::max(1, std::atoi(args[++i].c_str())));
+        }
+        else if (args[i] == "--param" && i + 1 < args.size())
+        {
+            // FILTER.NAME=V1,V2,...
+            std::string spec = args[++i];
+            size_t dot = spec.find('.');
+            size_t eq = spec.find('=');
+            const FilterDefinitions::FilterSpec *filter =
+                dot != std::string::npos ? FilterDefinitions::findFilter(spec.substr(0, dot)) : nullptr;
+            const FilterDefinitions::ParamSpec *param =
+                filter != nullptr && eq != std::string::npos && eq > dot
+                    ? FilterDefinitions::findParam(*filter, spec.substr(dot + 1, eq - dot - 1))
+                    : nullptr;
+            if (param == nullptr)
+            {
+                std::cerr << "Unknown filter parameter: " << spec << " (see the filters command)" << std::endl;
+                return 1;
+            }
+            std::vector<int> &values = config.param_overrides[filter->name][param->name];
+            values.clear();
+            for (const auto &text : Utils::split(spec.substr(eq + 1), ','))
+            {
+                int value = 0;
+                if (!FilterDefinitions::parseParamValue(*param, text, value))
+                {
+                    std::cerr << "Invalid value '" << text << "' for " << filter->name << "." << param->name << std::endl;
+                    return 1;
+                }
+                values.push_back(value);
+            }
+        }
+        else if (args[i] == "--param-grid")
+        {
+            config.param_grid = true;
+        }
+        else if (args[i] == "--chunk-sizes" && i + 1 < args.size())
+        {
+            config.chunk_sizes.clear();
+            for (const auto &text : Utils::split(args[++i], ','))
+            {
+                size_t elements = 0;
+                if (!ChunkTuner::parseChunkSize(text, elements))
+                {
+                    std::cerr << "Invalid chunk size: " << text << " (use N, NK, NM, full or auto)" << std::endl;
+                    return 1;
+                }
+                config.chunk_sizes.push_back(elements);
+            }
+        }
+        else if (args[i] == "--tune-weights" && i + 1 < args.size())
+        {
+            std::vector<std::string> weights = Utils::split(args[++i], ',');
+            if (weights.size() != 3)
+            {
+                std::cerr << "--tune-weights expects three comma-separated weights: ratio,encode,read" << std::endl;
+                return 1;
+            }
+            config.tune_weights.ratio = std::max(0.0, std::atof(weights[0].c_str()));
+            config.tune_weights.encode = std::max(0.0, std::atof(weights[1].c_str()));
+            config.tune_weights.read = std::max(0.0, std::atof(weights[2].c_str()));
+        }
+        else if (args[i] == "--slice-reads" && i + 1 < args.size())
+        {
+            config.slice_reads = std::max(0, std::atoi(args[++i].c_str()));
+        }
+        else if (args[i] == "--slice-elements" && i + 1 < args.size())
+        {
+            config.slice_elements = static_cast<size_t>(std::max(1, std::atoi(args[++i].c_str())));
+        }
+        else if (args[i] == "--auto-candidates" && i + 1 < args.size())
+        {
+            config.auto_candidates = Utils::split(args[++i], ',');
+        }
+        else if (args[i] == "--auto-min-decode" && i + 1 < args.size())
+        {
+            config.auto_min_decode_mbps = std::max(0.0, std::atof(args[++i].c_str()));
+        }
+        else if (args[i] == "--auto-min-encode" && i + 1 < args.size())
+        {
+            config.auto_min_encode_mbps = std::max(0.0, std::atof(args[++i].c_str()));
+        }
+        else if (args[i] == "--auto-sample-kb" && i + 1 < args.size())
+        {
+            config.auto_sample_kb = static_cast<size_t>(std::max(1, std::atoi(args[++i].c_str())));
+        }
+        else if (args[i] == "--no-prune")
+        {
+            config.prune = false;
+        }
+        else if (args[i] == "--prune-margin" && i + 1 < args.size())
+        {
+            config.estimate.margin = std::max(1.0, std::atof(args[++i].c_str()));
+        }
+        else if (args[i] == "--estimate-reads" && i + 1 < args.size())
+        {
+            config.estimate.reads = std::max(1, std::atoi(args[++i].c_str()));
+        }
+        else if (args[i] == "--estimate-elements" && i + 1 < args.size())
+        {
+            config.estimate.read_elements = static_cast<size_t>(std::max(16, std::atoi(args[++i].c_str())));
+        }
+        else if (args[i] == "--perf-counters")
+        {
+            config.perf_counters = true;
+        }
+        else if (args[i] == "--io-trace")
+        {
+            config.io_trace = true;
+        }
+        else if (args[i] == "--throttle" && i + 1 < args.size())
+        {
+            std::string error;
+            if (!StorageProfile::parse(args[++i], config.throttle, error))
+            {
+                std::cerr << "Invalid --throttle: " << error << std::endl;
+                return 1;
+            }
+        }
+        else if (args[i] == "--require" && i + 1 < args.size())
+        {
+            for (const auto &text : Utils::split(args[++i], ','))
+            {
+                ParetoFrontier::Constraint constraint;
+                std::string error;
+                if (!ParetoFrontier::parseConstraint(text, constraint, error))
+                {
+                    std::cerr << "Invalid --require: " << error << std::endl;
+                    return 1;
+                }
+                config.requirements.push_back(constraint);
+            }
+        }
         else if (args[i] == "--format" && i + 1 < args.size())
         {
             // 格式参数，在generateReport中使用
-            i++; // 跳过格式值
+            report_format = args[++i];
         }
     }
 
@@ -96,8 +391,17 @@ int runTests(const std::vector<std::string> &args)
     auto results = tester.runTestSuite(config);
 
     // 生成报告
-    std::string report_file = config.output_dir + "/test_report.md";
-    if (tester.generateReport(results, report_file, "markdown"))
+    std::string report_extension = ".md";
+    if (report_format == "csv")
+    {
+        report_extension = ".csv";
+    }
+    else if (report_format == "json")
+    {
+        report_extension = ".json";
+    }
+    std::string report_file = config.output_dir + "/test_report" + report_extension;
+    if (tester.generateReport(results, report_file, report_format))
     {
         std::cout << "Test report generated: " << report_file << "\n";
     }
@@ -126,6 +430,11 @@ int main(int argc, char *argv[])
     {
         return runTests(args);
     }
+    else if (command == "filters")
+    {
+        printFilters();
+        return 0;
+    }
     else
     {
         std::cout << "Unknown command: " << command << "\n";
@@ -0,0 +1,106 @@
+#include "mapped_source.hpp"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+MappedSource::~MappedSource()
+{
+    close();
+}
+
+bool MappedSource::open(const std::string &path)
+{
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "Failed to open " << path << " for mapping: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void *base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // 映射建立后描述符可以关闭
+    ::close(fd);
+    if (base == MAP_FAILED)
+    {
+        std::cerr << "Failed to map " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    // 提示失败不影响正确性
+    madvise(base, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+    madvise(base, static_cast<size_t>(st.st_size), MADV_WILLNEED);
+
+    base_ = static_cast<const unsigned char *>(base);
+    size_ = static_cast<size_t>(st.st_size);
+    path_ = path;
+    return true;
+}
+
+void MappedSource::close()
+{
+    if (base_ != nullptr)
+    {
+        munmap(const_cast<unsigned char *>(base_), size_);
+    }
+    base_ = nullptr;
+    size_ = 0;
+    path_.clear();
+}
+
+std::span<const int16_t> MappedSource::signal(hid_t dset_id) const
+{
+    if (base_ == nullptr || dset_id < 0)
+    {
+        return {};
+    }
+
+    // 连续存储、无过滤器、无外部文件
+    hid_t dcpl_id = H5Dget_create_plist(dset_id);
+    bool plain = dcpl_id >= 0 && H5Pget_layout(dcpl_id) == H5D_CONTIGUOUS && H5Pget_nfilters(dcpl_id) == 0 &&
+                 H5Pget_external_count(dcpl_id) == 0;
+    if (dcpl_id >= 0)
+    {
+        H5Pclose(dcpl_id);
+    }
+    if (!plain)
+    {
+        return {};
+    }
+
+    // 文件中的字节即是 native int16（字节序、精度、符号都一致）
+    hid_t type_id = H5Dget_type(dset_id);
+    bool native = type_id >= 0 && H5Tequal(type_id, H5T_NATIVE_INT16) > 0;
+    if (type_id >= 0)
+    {
+        H5Tclose(type_id);
+    }
+    if (!native)
+    {
+        return {};
+    }
+
+    hid_t space_id = H5Dget_space(dset_id);
+    hssize_t elements = H5Sget_simple_extent_npoints(space_id);
+    H5Sclose(space_id);
+    // H5Dget_offset 已计入用户块；存储未分配时为 HADDR_UNDEF
+    haddr_t offset = H5Dget_offset(dset_id);
+    if (elements <= 0 || offset == HADDR_UNDEF || offset % alignof(int16_t) != 0)
+    {
+        return {};
+    }
+    size_t bytes = static_cast<size_t>(elements) * sizeof(int16_t);
+    if (offset > size_ || bytes > size_ - offset || H5Dget_storage_size(dset_id) != bytes)
+    {
+        return {};
+    }
+    return {reinterpret_cast<const int16_t *>(base_ + offset), static_cast<size_t>(elements)};
+}
@@ -0,0 +1,38 @@
+#ifndef MAPPED_SOURCE_HPP
+#define MAPPED_SOURCE_HPP
+
+#include <string>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <hdf5.h>
+
+// 只读映射整个源文件：连续存储、无过滤器、类型与 native int16 一致的数据集可以直接在映射上访问，
+// 不经过 H5Dread 和中间缓冲区（零拷贝）。其他数据集仍需解码
+class MappedSource
+{
+public:
+    MappedSource() = default;
+    ~MappedSource();
+
+    MappedSource(const MappedSource &) = delete;
+    MappedSource &operator=(const MappedSource &) = delete;
+
+    // 映射文件并提示内核顺序访问、提前预读（MADV_SEQUENTIAL / MADV_WILLNEED）
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return base_ != nullptr; }
+    const std::string &path() const { return path_; }
+    size_t size() const { return size_; }
+
+    // dset_id 必须属于同一个文件。数据集可以零拷贝访问时返回其在映射中的数据，否则返回空 span
+    std::span<const int16_t> signal(hid_t dset_id) const;
+
+private:
+    const unsigned char *base_ = nullptr;
+    size_t size_ = 0;
+    std::string path_;
+};
+
+#endif // MAPPED_SOURCE_HPP
@@ -0,0 +1,574 @@
+#include "metadata_replicator.hpp"
+#include "hdf5_processor.hpp"
+#include "chunk_tuner.hpp"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+namespace
+{
+    std::string parentPath(const std::string &path)
+    {
+        size_t slash = path.rfind('/');
+        return slash == std::string::npos ? std::string() : path.substr(0, slash);
+    }
+
+    // 只在 H5Padd_merge_committed_dtype_path 给出的路径中查找可合并的命名数据类型，不遍历整个目标文件
+    H5O_mcdt_search_ret_t stopSearch(void *)
+    {
+        return H5O_MCDT_SEARCH_STOP;
+    }
+
+    struct AttributeCopy
+    {
+        hid_t dst_obj;
+        size_t copied;
+        size_t failures;
+    };
+
+    // H5Ovisit 回调：数据集的原始数据区段，紧凑存储（在对象头中）与未分配的存储不计
+    herr_t collectExtents(hid_t obj_id, const char *name, const H5O_info_t *info, void *operator_data)
+    {
+        if (info->type != H5O_TYPE_DATASET)
+        {
+            return 0;
+        }
+        auto *extents = static_cast<std::vector<MetadataReplicator::Extent> *>(operator_data);
+        hid_t dset_id = H5Dopen(obj_id, name, H5P_DEFAULT);
+        if (dset_id < 0)
+        {
+            return 0;
+        }
+        hid_t dcpl_id = H5Dget_create_plist(dset_id);
+        H5D_layout_t layout = H5Pget_layout(dcpl_id);
+        H5Pclose(dcpl_id);
+        if (layout == H5D_CONTIGUOUS)
+        {
+            haddr_t offset = H5Dget_offset(dset_id);
+            hsize_t size = H5Dget_storage_size(dset_id);
+            if (offset != HADDR_UNDEF && size > 0)
+            {
+                extents->push_back({offset, size});
+            }
+        }
+        else if (layout == H5D_CHUNKED)
+        {
+            hid_t space_id = H5Dget_space(dset_id);
+            hsize_t num_chunks = 0;
+            if (H5Dget_num_chunks(dset_id, space_id, &num_chunks) >= 0)
+            {
+                for (hsize_t index = 0; index < num_chunks; ++index)
+                {
+                    unsigned filter_mask = 0;
+                    haddr_t address = HADDR_UNDEF;
+                    hsize_t size = 0;
+                    if (H5Dget_chunk_info(dset_id, space_id, index, NULL, &filter_mask, &address, &size) >= 0 &&
+                        address != HADDR_UNDEF && size > 0)
+                    {
+                        extents->push_back({address, size});
+                    }
+                }
+            }
+            H5Sclose(space_id);
+        }
+        H5Dclose(dset_id);
+        return 0;
+    }
+
+    herr_t copyAttribute(hid_t loc_id, const char *name, const H5A_info_t *, void *operator_data)
+    {
+        AttributeCopy *copy = static_cast<AttributeCopy *>(operator_data);
+        hid_t src_attr_id = H5Aopen(loc_id, name, H5P_DEFAULT);
+        if (src_attr_id < 0)
+        {
+            copy->failures++;
+            return 0;
+        }
+        hid_t type_id = H5Aget_type(src_attr_id);
+        hid_t space_id = H5Aget_space(src_attr_id);
+        hid_t acpl_id = H5Aget_create_plist(src_attr_id);
+
+        // 引用指向源文件中的地址，不能按字节复制
+        bool ok = type_id >= 0 && space_id >= 0 && H5Tdetect_class(type_id, H5T_REFERENCE) <= 0;
+        if (ok && H5Tcommitted(type_id) > 0)
+        {
+            // 源文件中的命名数据类型不能直接用于目标文件，复制为临时类型
+            hid_t transient_id = H5Tcopy(type_id);
+            H5Tclose(type_id);
+            type_id = transient_id;
+        }
+        if (ok)
+        {
+            // 以文件类型读写，不做类型转换；变长数据由库分配，写出后回收
+            hssize_t elements = H5Sget_simple_extent_npoints(space_id);
+            std::vector<unsigned char> buffer(static_cast<size_t>(std::max<hssize_t>(elements, 1)) * H5Tget_size(type_id));
+            hid_t dst_attr_id = -1;
+            ok = H5Aread(src_attr_id, type_id, buffer.data()) >= 0;
+            if (ok)
+            {
+                dst_attr_id = H5Acreate2(copy->dst_obj, name, type_id, space_id, acpl_id, H5P_DEFAULT);
+                ok = dst_attr_id >= 0 && H5Awrite(dst_attr_id, type_id, buffer.data()) >= 0;
+                if (H5Tdetect_class(type_id, H5T_VLEN) > 0 || H5Tis_variable_str(type_id) > 0)
+                {
+                    H5Dvlen_reclaim(type_id, space_id, H5P_DEFAULT, buffer.data());
+                }
+            }
+            if (dst_attr_id >= 0)
+            {
+                H5Aclose(dst_attr_id);
+            }
+        }
+        if (acpl_id >= 0)
+        {
+            H5Pclose(acpl_id);
+        }
+        if (space_id >= 0)
+        {
+            H5Sclose(space_id);
+        }
+        if (type_id >= 0)
+        {
+            H5Tclose(type_id);
+        }
+        H5Aclose(src_attr_id);
+
+        if (ok)
+        {
+            copy->copied++;
+        }
+        else
+        {
+            std::cerr << "Failed to copy attribute: " << name << std::endl;
+            copy->failures++;
+        }
+        return 0;
+    }
+} // namespace
+
+MetadataReplicator::MetadataReplicator(hid_t src_file_id, hid_t dst_file_id, const CompressionPolicy *policy)
+    : src_file_id_(src_file_id), dst_file_id_(dst_file_id), policy_(policy)
+{
+    ocpypl_id_ = H5Pcreate(H5P_OBJECT_COPY);
+    if (ocpypl_id_ >= 0)
+    {
+        H5Pset_copy_object(ocpypl_id_, H5O_COPY_MERGE_COMMITTED_DTYPE_FLAG);
+        H5Pset_mcdt_search_cb(ocpypl_id_, stopSearch, NULL);
+    }
+}
+
+MetadataReplicator::~MetadataReplicator()
+{
+    if (ocpypl_id_ >= 0)
+    {
+        H5Pclose(ocpypl_id_);
+    }
+}
+
+size_t MetadataReplicator::copyAttributes(hid_t src_obj, hid_t dst_obj, size_t &failures)
+{
+    AttributeCopy copy = {dst_obj, 0, 0};
+    hsize_t index = 0;
+    if (H5Aiterate2(src_obj, H5_INDEX_NAME, H5_ITER_NATIVE, &index, copyAttribute, &copy) < 0)
+    {
+        copy.failures++;
+    }
+    failures += copy.failures;
+    return copy.copied;
+}
+
+bool MetadataReplicator::replicate(const DatasetInventory &inventory)
+{
+    if (ocpypl_id_ < 0)
+    {
+        std::cerr << "Failed to create object copy property list" << std::endl;
+        return false;
+    }
+
+    // 每个数据集按策略分类一次；规则的过滤器不可用时该类数据集按原样复制
+    const std::vector<DatasetInventory::Object> &objects = inventory.objects();
+    std::vector<int> classes(objects.size(), -1);
+    std::vector<char> recompress;
+    if (policy_ != nullptr)
+    {
+        stats_.classes = policy_->classes();
+        recompress.assign(stats_.classes.size(), 0);
+        for (size_t c = 0; c < stats_.classes.size(); ++c)
+        {
+            const CompressionPolicy::Rule *rule = policy_->ruleOf(static_cast<int>(c));
+            if (rule == nullptr || rule->action != CompressionPolicy::Action::Recompress)
+            {
+                continue;
+            }
+            recompress[c] = 1;
+            for (const auto &stage : rule->stages)
+            {
+                unsigned int filter_config = 0;
+                if (H5Zfilter_avail(stage.filter->filter_id) <= 0 ||
+                    H5Zget_filter_info(stage.filter->filter_id, &filter_config) < 0 ||
+                    !(filter_config & H5Z_FILTER_CONFIG_ENCODE_ENABLED))
+                {
+                    std::cerr << "Policy rule " << rule->label() << ": " << stage.filter->name
+                              << " encoder not available, matching datasets are copied" << std::endl;
+                    recompress[c] = 0;
+                    break;
+                }
+            }
+        }
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            classes[i] = policy_->classOf(objects[i]);
+        }
+    }
+    auto recompressed = [&](size_t i)
+    { return classes[i] > CompressionPolicy::kSignalClass && recompress[classes[i]] != 0; };
+
+    // 逐个创建的组：根组（空路径）以及每个 Signal 数据集和重新写出的数据集的全部上级组
+    spine_.clear();
+    copied_.clear();
+    spine_.insert("");
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        bool signal = objects[i].type == H5O_TYPE_DATASET && HDF5Processor::isSignalPath(objects[i].path);
+        if (!signal && !recompressed(i))
+        {
+            continue;
+        }
+        for (std::string group = parentPath(objects[i].path); !group.empty(); group = parentPath(group))
+        {
+            if (!spine_.insert(group).second)
+            {
+                break;
+            }
+        }
+    }
+
+    // 命名数据类型按源文件中的路径合并（路径在目标文件中还不存在时库会跳过）
+    H5Pfree_merge_committed_dtype_paths(ocpypl_id_);
+    for (const auto &object : inventory.objects())
+    {
+        if (object.type == H5O_TYPE_NAMED_DATATYPE)
+        {
+            H5Padd_merge_committed_dtype_path(ocpypl_id_, ("/" + object.path).c_str());
+        }
+    }
+
+    // 根组的属性
+    hid_t src_root_id = H5Gopen(src_file_id_, "/", H5P_DEFAULT);
+    hid_t dst_root_id = H5Gopen(dst_file_id_, "/", H5P_DEFAULT);
+    if (src_root_id >= 0 && dst_root_id >= 0)
+    {
+        stats_.attributes_copied += copyAttributes(src_root_id, dst_root_id, stats_.failures);
+    }
+    if (src_root_id >= 0)
+    {
+        H5Gclose(src_root_id);
+    }
+    if (dst_root_id >= 0)
+    {
+        H5Gclose(dst_root_id);
+    }
+
+    // 清单按 H5Lvisit 顺序排列，上级组总在其成员之前；上级组不在 spine_ 中的对象已随所在子树复制
+    std::vector<char> rewritten(objects.size(), 0);
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        const DatasetInventory::Object &object = objects[i];
+        if (spine_.count(parentPath(object.path)) == 0)
+        {
+            continue;
+        }
+        if (spine_.count(object.path) > 0)
+        {
+            createGroup(object.path);
+        }
+        else if (recompressed(i))
+        {
+            rewritten[i] = recompressDataset(object.path, *policy_->ruleOf(classes[i]), stats_.classes[classes[i]]);
+            if (!rewritten[i])
+            {
+                stats_.recompress_fallbacks++;
+                copyChild(object.path);
+            }
+        }
+        else if (object.type != H5O_TYPE_DATASET || !HDF5Processor::isSignalPath(object.path))
+        {
+            copyChild(object.path);
+        }
+    }
+
+    // 原样复制的数据集（包括随子树复制的）在目标文件中的存储与源文件相同，取自清单
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        if (classes[i] > CompressionPolicy::kSignalClass && !rewritten[i])
+        {
+            StorageClass &usage = stats_.classes[classes[i]];
+            usage.datasets++;
+            usage.raw_bytes += CompressionPolicy::rawBytes(objects[i]);
+            usage.stored_bytes += objects[i].storage_size;
+        }
+    }
+    return stats_.failures == 0;
+}
+
+bool MetadataReplicator::createGroup(const std::string &path)
+{
+    hid_t src_group_id = H5Gopen(src_file_id_, path.c_str(), H5P_DEFAULT);
+    if (src_group_id < 0)
+    {
+        std::cerr << "Failed to open source group: " << path << std::endl;
+        stats_.failures++;
+        return false;
+    }
+    // 沿用源组的创建属性（链接创建顺序、紧凑/稠密存储阈值等）
+    hid_t gcpl_id = H5Gget_create_plist(src_group_id);
+    hid_t dst_group_id = H5Gcreate2(dst_file_id_, path.c_str(), H5P_DEFAULT,
+                                    gcpl_id >= 0 ? gcpl_id : H5P_DEFAULT, H5P_DEFAULT);
+    if (gcpl_id >= 0)
+    {
+        H5Pclose(gcpl_id);
+    }
+    if (dst_group_id < 0)
+    {
+        std::cerr << "Failed to create group: " << path << std::endl;
+        H5Gclose(src_group_id);
+        stats_.failures++;
+        return false;
+    }
+    stats_.groups_created++;
+    stats_.attributes_copied += copyAttributes(src_group_id, dst_group_id, stats_.failures);
+    // 该组的其他硬链接（H5Lvisit 不会再进入）链接到这里，而不是连同 Signal 深层复制一份
+    H5L_info_t link_info;
+    if (H5Lget_info(src_file_id_, path.c_str(), &link_info, H5P_DEFAULT) >= 0 && link_info.type == H5L_TYPE_HARD)
+    {
+        copied_.emplace(link_info.u.address, path);
+    }
+    H5Gclose(dst_group_id);
+    H5Gclose(src_group_id);
+    return true;
+}
+
+bool MetadataReplicator::copyChild(const std::string &path)
+{
+    H5L_info_t link_info;
+    if (H5Lget_info(src_file_id_, path.c_str(), &link_info, H5P_DEFAULT) < 0)
+    {
+        std::cerr << "Failed to get link info for: " << path << std::endl;
+        stats_.failures++;
+        return false;
+    }
+
+    herr_t status = -1;
+    if (link_info.type == H5L_TYPE_HARD)
+    {
+        // 同一对象的第二个硬链接指向已复制的对象，不再复制一份
+        auto copied = copied_.find(link_info.u.address);
+        if (copied != copied_.end())
+        {
+            status = H5Lcreate_hard(dst_file_id_, copied->second.c_str(), dst_file_id_, path.c_str(),
+                                    H5P_DEFAULT, H5P_DEFAULT);
+            stats_.links_created++;
+        }
+        else
+        {
+            status = H5Ocopy(src_file_id_, path.c_str(), dst_file_id_, path.c_str(), ocpypl_id_, H5P_DEFAULT);
+            copied_.emplace(link_info.u.address, path);
+            stats_.subtrees_copied++;
+        }
+    }
+    else
+    {
+        // 软链接与外部链接按原样重建，不展开
+        std::vector<char> value(link_info.u.val_size + 1, '\0');
+        if (H5Lget_val(src_file_id_, path.c_str(), value.data(), value.size(), H5P_DEFAULT) >= 0)
+        {
+            if (link_info.type == H5L_TYPE_SOFT)
+            {
+                status = H5Lcreate_soft(value.data(), dst_file_id_, path.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+            }
+            else if (link_info.type == H5L_TYPE_EXTERNAL)
+            {
+                const char *file_name = nullptr;
+                const char *object_name = nullptr;
+                unsigned flags = 0;
+                if (H5Lunpack_elink_val(value.data(), link_info.u.val_size, &flags, &file_name, &object_name) >= 0)
+                {
+                    status = H5Lcreate_external(file_name, object_name, dst_file_id_, path.c_str(),
+                                                H5P_DEFAULT, H5P_DEFAULT);
+                }
+            }
+        }
+        stats_.links_created++;
+    }
+
+    if (status < 0)
+    {
+        std::cerr << "Failed to copy object: " << path << std::endl;
+        stats_.failures++;
+        return false;
+    }
+    return true;
+}
+
+bool MetadataReplicator::recompressDataset(const std::string &path, const CompressionPolicy::Rule &rule,
+                                           StorageClass &usage)
+{
+    // 同一数据集的其他硬链接指向已写出的数据集；软链接与外部链接按原样重建
+    H5L_info_t link_info;
+    if (H5Lget_info(src_file_id_, path.c_str(), &link_info, H5P_DEFAULT) < 0 || link_info.type != H5L_TYPE_HARD)
+    {
+        return false;
+    }
+    auto copied = copied_.find(link_info.u.address);
+    if (copied != copied_.end())
+    {
+        return false;
+    }
+
+    hid_t src_dset_id = H5Dopen(src_file_id_, path.c_str(), H5P_DEFAULT);
+    if (src_dset_id < 0)
+    {
+        return false;
+    }
+    hid_t type_id = H5Dget_type(src_dset_id);
+    if (type_id >= 0 && H5Tcommitted(type_id) > 0)
+    {
+        // 源文件中的命名数据类型不能直接用于目标文件，复制为临时类型
+        hid_t transient_id = H5Tcopy(type_id);
+        H5Tclose(type_id);
+        type_id = transient_id;
+    }
+    hid_t space_id = H5Dget_space(src_dset_id);
+    hid_t dcpl_id = H5Dget_create_plist(src_dset_id);
+    int rank = space_id >= 0 ? H5Sget_simple_extent_ndims(space_id) : -1;
+    hssize_t elements = space_id >= 0 ? H5Sget_simple_extent_npoints(space_id) : 0;
+
+    // 分块布局要求至少一维且非空；外部存储不能改为分块，引用指向源文件中的地址
+    bool ok = type_id >= 0 && dcpl_id >= 0 && rank >= 1 && elements > 0 &&
+              H5Pget_external_count(dcpl_id) == 0 && H5Tdetect_class(type_id, H5T_REFERENCE) <= 0;
+    hid_t dst_dset_id = -1;
+    hsize_t storage_size = 0;
+    size_t element_size = ok ? H5Tget_size(type_id) : 0;
+    if (ok)
+    {
+        // 沿用源数据集的创建属性（填充值等），只替换分块与过滤器
+        std::vector<hsize_t> dims(static_cast<size_t>(rank));
+        std::vector<hsize_t> chunk_dims(static_cast<size_t>(rank));
+        H5Sget_simple_extent_dims(space_id, dims.data(), NULL);
+        ChunkTuner::chunkDims(rank, dims.data(), element_size, rule.chunk_elements, chunk_dims.data());
+        ok = H5Premove_filter(dcpl_id, H5Z_FILTER_ALL) >= 0 && H5Pset_chunk(dcpl_id, rank, chunk_dims.data()) >= 0;
+        for (const auto &stage : rule.stages)
+        {
+            ok = ok && FilterDefinitions::applyFilter(dcpl_id, *stage.filter, stage.cd_values) >= 0;
+        }
+    }
+    if (ok)
+    {
+        // 以文件类型读写，不做类型转换；变长数据由库分配，写出后回收
+        std::vector<unsigned char> buffer(static_cast<size_t>(elements) * element_size);
+        ok = H5Dread(src_dset_id, type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer.data()) >= 0;
+        if (ok)
+        {
+            dst_dset_id = H5Dcreate2(dst_file_id_, path.c_str(), type_id, space_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT);
+            ok = dst_dset_id >= 0 && H5Dwrite(dst_dset_id, type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer.data()) >= 0;
+            if (H5Tdetect_class(type_id, H5T_VLEN) > 0 || H5Tis_variable_str(type_id) > 0)
+            {
+                H5Dvlen_reclaim(type_id, space_id, H5P_DEFAULT, buffer.data());
+            }
+        }
+    }
+    if (ok)
+    {
+        stats_.attributes_copied += copyAttributes(src_dset_id, dst_dset_id, stats_.failures);
+        ok = H5Dflush(dst_dset_id) >= 0;
+        storage_size = H5Dget_storage_size(dst_dset_id);
+    }
+    if (dst_dset_id >= 0)
+    {
+        H5Dclose(dst_dset_id);
+        if (!ok)
+        {
+            H5Ldelete(dst_file_id_, path.c_str(), H5P_DEFAULT);
+        }
+    }
+    if (dcpl_id >= 0)
+    {
+        H5Pclose(dcpl_id);
+    }
+    if (space_id >= 0)
+    {
+        H5Sclose(space_id);
+    }
+    if (type_id >= 0)
+    {
+        H5Tclose(type_id);
+    }
+    H5Dclose(src_dset_id);
+    if (!ok)
+    {
+        return false;
+    }
+
+    copied_.emplace(link_info.u.address, path);
+    stats_.datasets_recompressed++;
+    usage.datasets++;
+    usage.raw_bytes += static_cast<size_t>(elements) * element_size;
+    usage.stored_bytes += storage_size;
+    return true;
+}
+
+bool MetadataReplicator::buildImage(hid_t src_file_id, const DatasetInventory &inventory,
+                                    const CompressionPolicy *policy, std::vector<unsigned char> &image, Stats &stats,
+                                    std::vector<Extent> *raw_extents)
+{
+    image.clear();
+    hid_t fapl_id = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_core(fapl_id, 1024 * 1024, false);
+    hid_t file_id = H5Fcreate("metadata_skeleton.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+    H5Pclose(fapl_id);
+    if (file_id < 0)
+    {
+        std::cerr << "Failed to create in-memory metadata skeleton" << std::endl;
+        return false;
+    }
+
+    bool ok = false;
+    {
+        MetadataReplicator replicator(src_file_id, file_id, policy);
+        ok = replicator.replicate(inventory);
+        stats = replicator.stats();
+    }
+    if (ok && H5Fflush(file_id, H5F_SCOPE_LOCAL) >= 0)
+    {
+        ssize_t image_size = H5Fget_file_image(file_id, NULL, 0);
+        if (image_size > 0)
+        {
+            image.resize(static_cast<size_t>(image_size));
+            if (H5Fget_file_image(file_id, image.data(), image.size()) < 0)
+            {
+                image.clear();
+            }
+        }
+    }
+    if (!image.empty() && raw_extents != nullptr)
+    {
+        raw_extents->clear();
+        H5Ovisit2(file_id, H5_INDEX_NAME, H5_ITER_NATIVE, collectExtents, raw_extents, H5O_INFO_BASIC);
+        std::sort(raw_extents->begin(), raw_extents->end(),
+                  [](const Extent &a, const Extent &b) { return a.addr < b.addr; });
+        std::vector<Extent> merged;
+        for (const auto &extent : *raw_extents)
+        {
+            if (!merged.empty() && merged.back().addr + merged.back().size >= extent.addr)
+            {
+                merged.back().size = std::max(merged.back().size, extent.addr + extent.size - merged.back().addr);
+            }
+            else
+            {
+                merged.push_back(extent);
+            }
+        }
+        raw_extents->swap(merged);
+    }
+    H5Fclose(file_id);
+    return !image.empty();
+}
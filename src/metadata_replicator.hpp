@@ -0,0 +1,73 @@
+#ifndef METADATA_REPLICATOR_HPP
+#define METADATA_REPLICATOR_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <hdf5.h>
+#include "dataset_inventory.hpp"
+#include "compression_policy.hpp"
+
+// 元数据复制：把源文件中除 Signal 数据集以外的全部对象（组、数据集、命名数据类型、属性与链接）复制到目标文件。
+// 通向 Signal 数据集的组（以及根组）只创建组本身并复制属性，Signal 数据集由调用方创建；
+// 这些组下的其他每个子树只用一次深层 H5Ocopy 复制，命名数据类型在各次复制之间合并。
+// 给出压缩策略时，策略要求重新写出的数据集也由这里按规则的管线与分块创建，其上级组同样逐个创建。
+// buildImage 把结果做成内存中的文件映像（骨架），每个输出文件从骨架开始，不必每次都复制
+class MetadataReplicator
+{
+public:
+    struct Stats
+    {
+        size_t groups_created = 0;    // 通向 Signal 的组（H5Gcreate）
+        size_t attributes_copied = 0; // 这些组上逐个复制的属性
+        size_t subtrees_copied = 0;   // 深层 H5Ocopy 调用次数
+        size_t links_created = 0;     // 软链接、外部链接，以及指向已复制对象的硬链接
+        size_t datasets_recompressed = 0; // 按策略重新写出的数据集
+        size_t recompress_fallbacks = 0;  // 策略要求重新写出、但只能原样复制的数据集（标量、空数据集等）
+        size_t failures = 0;
+        // 按策略类别统计的 Signal 以外数据集在目标文件中的存储开销（Signal 类别由调用方填入），没有策略时为空
+        std::vector<StorageClass> classes;
+    };
+
+    // 文件中的一段原始数据：连续存储的数据集，或一个已分配的分块
+    struct Extent
+    {
+        haddr_t addr;
+        hsize_t size;
+    };
+
+    MetadataReplicator(hid_t src_file_id, hid_t dst_file_id, const CompressionPolicy *policy = nullptr);
+    ~MetadataReplicator();
+
+    MetadataReplicator(const MetadataReplicator &) = delete;
+    MetadataReplicator &operator=(const MetadataReplicator &) = delete;
+
+    // 按清单顺序（父对象在前）复制，全部成功返回 true
+    bool replicate(const DatasetInventory &inventory);
+    const Stats &stats() const { return stats_; }
+
+    // 把 src_obj 的全部属性复制到 dst_obj，返回复制的个数，失败的属性计入 failures
+    static size_t copyAttributes(hid_t src_obj, hid_t dst_obj, size_t &failures);
+    // 在 core VFD（不落盘）上复制一份骨架并取出文件映像，有对象复制失败时返回 false；
+    // raw_extents 非空时同时给出映像中原始数据的区段（按地址排序，相邻区段合并）
+    static bool buildImage(hid_t src_file_id, const DatasetInventory &inventory, const CompressionPolicy *policy,
+                           std::vector<unsigned char> &image, Stats &stats,
+                           std::vector<Extent> *raw_extents = nullptr);
+
+private:
+    bool createGroup(const std::string &path);
+    bool copyChild(const std::string &path);
+    // 以规则的管线与分块重新创建数据集；不能重新写出（标量、空数据集、外部存储、引用类型等）时返回 false，由调用方复制
+    bool recompressDataset(const std::string &path, const CompressionPolicy::Rule &rule, StorageClass &usage);
+
+    hid_t src_file_id_;
+    hid_t dst_file_id_;
+    hid_t ocpypl_id_ = -1;
+    const CompressionPolicy *policy_;
+    std::set<std::string> spine_;                  // 通向 Signal 数据集（及重新写出的数据集）的组
+    std::map<haddr_t, std::string> copied_;        // 已复制的源对象地址 → 目标路径（保留硬链接共享）
+    Stats stats_;
+};
+
+#endif // METADATA_REPLICATOR_HPP
@@ -0,0 +1,794 @@
+#include "parallel_executor.hpp"
+#include "filter_definitions.hpp"
+#include "utils.hpp"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+using namespace std::chrono;
+
+ParallelExecutor::ParallelExecutor(int jobs, int timeout_seconds, const std::string &log_dir)
+    : jobs_(jobs < 1 ? 1 : jobs), timeout_seconds_(timeout_seconds < 0 ? 0 : timeout_seconds), log_dir_(log_dir)
+{
+}
+
+// ---------------------------------------------------------------------------
+// 结果序列化：每行 key=value，值中的换行和反斜杠做转义
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    std::string escapeValue(const std::string &value)
+    {
+        std::string escaped;
+        for (char c : value)
+        {
+            if (c == '\\')
+            {
+                escaped += "\\\\";
+            }
+            else if (c == '\n')
+            {
+                escaped += "\\n";
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    std::string unescapeValue(const std::string &value)
+    {
+        std::string plain;
+        for (size_t i = 0; i < value.size(); ++i)
+        {
+            if (value[i] == '\\' && i + 1 < value.size())
+            {
+                plain += value[i + 1] == 'n' ? '\n' : value[i + 1];
+                ++i;
+            }
+            else
+            {
+                plain += value[i];
+            }
+        }
+        return plain;
+    }
+
+    class FieldWriter
+    {
+    public:
+        template <typename T>
+        void put(const std::string &key, const T &value)
+        {
+            ss_ << key << "=" << std::setprecision(17) << value << "\n";
+        }
+        void put(const std::string &key, const std::string &value)
+        {
+            ss_ << key << "=" << escapeValue(value) << "\n";
+        }
+        void putStats(const std::string &prefix, const TimingStats &t)
+        {
+            put(prefix + ".samples", t.samples);
+            put(prefix + ".min", t.min);
+            put(prefix + ".median", t.median);
+            put(prefix + ".mean", t.mean);
+            put(prefix + ".p95", t.p95);
+            put(prefix + ".stddev", t.stddev);
+            put(prefix + ".ci_low", t.ci_low);
+            put(prefix + ".ci_high", t.ci_high);
+        }
+        void putCounters(const std::string &prefix, const CounterSample &c)
+        {
+            put(prefix + ".source", c.source);
+            put(prefix + ".cycles", c.cycles);
+            put(prefix + ".instructions", c.instructions);
+            put(prefix + ".llc_misses", c.llc_misses);
+            put(prefix + ".branch_misses", c.branch_misses);
+            put(prefix + ".context_switches", c.context_switches);
+            put(prefix + ".task_clock_ns", c.task_clock_ns);
+            put(prefix + ".bytes", c.bytes);
+        }
+        void putIo(const std::string &prefix, const IoStats &io)
+        {
+            static const char *names[2][2] = {{"meta_read", "meta_write"}, {"raw_read", "raw_write"}};
+            for (int a = 0; a < 2; ++a)
+            {
+                for (int d = 0; d < 2; ++d)
+                {
+                    const IoOpStats &op = io.ops[a][d];
+                    std::string key = prefix + "." + names[a][d];
+                    put(key + ".calls", op.calls);
+                    put(key + ".bytes", op.bytes);
+                    put(key + ".ns", op.ns);
+                    put(key + ".max_ns", op.max_ns);
+                    put(key + ".unaligned", op.unaligned);
+                    put(key + ".sequential", op.sequential);
+                    std::vector<long long> hist(op.size_hist, op.size_hist + IoOpStats::kSizeBuckets);
+                    putColumn(key + ".size_hist", hist);
+                }
+            }
+        }
+        // 列式数组：数值以逗号分隔，路径以换行分隔（由 escapeValue 转义）
+        template <typename T>
+        void putColumn(const std::string &key, const std::vector<T> &values, char separator = ',')
+        {
+            std::stringstream column;
+            column << std::setprecision(17);
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                column << (i > 0 ? std::string(1, separator) : std::string()) << values[i];
+            }
+            put(key, column.str());
+        }
+        void putReads(const std::string &prefix, const ReadTable &reads)
+        {
+            putColumn(prefix + ".paths", reads.paths, '\n');
+            putColumn(prefix + ".elements", reads.elements);
+            putColumn(prefix + ".original_bytes", reads.original_bytes);
+            putColumn(prefix + ".compressed_bytes", reads.compressed_bytes);
+            putColumn(prefix + ".encode_ns", reads.encode_ns);
+            putColumn(prefix + ".decode_ns", reads.decode_ns);
+        }
+        std::string str() const { return ss_.str(); }
+
+    private:
+        std::stringstream ss_;
+    };
+
+    class FieldReader
+    {
+    public:
+        explicit FieldReader(const std::string &text)
+        {
+            std::stringstream ss(text);
+            std::string line;
+            while (std::getline(ss, line))
+            {
+                size_t pos = line.find('=');
+                if (pos != std::string::npos)
+                {
+                    fields_[line.substr(0, pos)] = unescapeValue(line.substr(pos + 1));
+                }
+            }
+        }
+        bool has(const std::string &key) const { return fields_.count(key) > 0; }
+        template <typename T>
+        void get(const std::string &key, T &value) const
+        {
+            auto it = fields_.find(key);
+            if (it != fields_.end())
+            {
+                std::stringstream ss(it->second);
+                ss >> value;
+            }
+        }
+        void get(const std::string &key, std::string &value) const
+        {
+            auto it = fields_.find(key);
+            if (it != fields_.end())
+            {
+                value = it->second;
+            }
+        }
+        void getStats(const std::string &prefix, TimingStats &t) const
+        {
+            get(prefix + ".samples", t.samples);
+            get(prefix + ".min", t.min);
+            get(prefix + ".median", t.median);
+            get(prefix + ".mean", t.mean);
+            get(prefix + ".p95", t.p95);
+            get(prefix + ".stddev", t.stddev);
+            get(prefix + ".ci_low", t.ci_low);
+            get(prefix + ".ci_high", t.ci_high);
+        }
+        void getCounters(const std::string &prefix, CounterSample &c) const
+        {
+            get(prefix + ".source", c.source);
+            get(prefix + ".cycles", c.cycles);
+            get(prefix + ".instructions", c.instructions);
+            get(prefix + ".llc_misses", c.llc_misses);
+            get(prefix + ".branch_misses", c.branch_misses);
+            get(prefix + ".context_switches", c.context_switches);
+            get(prefix + ".task_clock_ns", c.task_clock_ns);
+            get(prefix + ".bytes", c.bytes);
+        }
+        void getIo(const std::string &prefix, IoStats &io) const
+        {
+            static const char *names[2][2] = {{"meta_read", "meta_write"}, {"raw_read", "raw_write"}};
+            for (int a = 0; a < 2; ++a)
+            {
+                for (int d = 0; d < 2; ++d)
+                {
+                    IoOpStats &op = io.ops[a][d];
+                    std::string key = prefix + "." + names[a][d];
+                    get(key + ".calls", op.calls);
+                    get(key + ".bytes", op.bytes);
+                    get(key + ".ns", op.ns);
+                    get(key + ".max_ns", op.max_ns);
+                    get(key + ".unaligned", op.unaligned);
+                    get(key + ".sequential", op.sequential);
+                    std::vector<long long> hist;
+                    getColumn(key + ".size_hist", hist);
+                    for (size_t b = 0; b < hist.size() && b < static_cast<size_t>(IoOpStats::kSizeBuckets); ++b)
+                    {
+                        op.size_hist[b] = hist[b];
+                    }
+                }
+            }
+        }
+        template <typename T>
+        void getColumn(const std::string &key, std::vector<T> &values, char separator = ',') const
+        {
+            values.clear();
+            std::string column;
+            get(key, column);
+            if (column.empty())
+            {
+                return;
+            }
+            for (const auto &item : Utils::split(column, separator))
+            {
+                T value = T();
+                std::stringstream ss(item);
+                ss >> value;
+                values.push_back(value);
+            }
+        }
+        void getColumn(const std::string &key, std::vector<std::string> &values, char separator) const
+        {
+            values.clear();
+            std::string column;
+            get(key, column);
+            if (!column.empty())
+            {
+                values = Utils::split(column, separator);
+            }
+        }
+        void getReads(const std::string &prefix, ReadTable &reads) const
+        {
+            reads.clear();
+            getColumn(prefix + ".paths", reads.paths, '\n');
+            getColumn(prefix + ".elements", reads.elements);
+            getColumn(prefix + ".original_bytes", reads.original_bytes);
+            getColumn(prefix + ".compressed_bytes", reads.compressed_bytes);
+            getColumn(prefix + ".encode_ns", reads.encode_ns);
+            getColumn(prefix + ".decode_ns", reads.decode_ns);
+            // 列长度不一致说明数据损坏，丢弃整个表
+            size_t rows = reads.paths.size();
+            if (reads.elements.size() != rows || reads.original_bytes.size() != rows ||
+                reads.compressed_bytes.size() != rows || reads.encode_ns.size() != rows ||
+                reads.decode_ns.size() != rows)
+            {
+                reads.clear();
+                return;
+            }
+            reads.reindex();
+        }
+
+    private:
+        std::map<std::string, std::string> fields_;
+    };
+} // namespace
+
+std::string ParallelExecutor::serializeResult(const CompressionResult &result)
+{
+    FieldWriter w;
+    w.put("filter_name", result.filter_name);
+    w.put("parameters", result.parameters);
+    w.put("compression_level", result.compression_level);
+    w.put("compression_ratio", result.compression_ratio);
+    w.put("compression_time_ms", result.compression_time_ms);
+    w.put("decompression_time_ms", result.decompression_time_ms);
+    w.put("compressed_size_bytes", result.compressed_size_bytes);
+    w.put("original_size_bytes", result.original_size_bytes);
+    w.put("decompression_mbps", result.decompression_mbps);
+    w.put("verified_datasets", result.verified_datasets);
+    w.put("verification_failures", result.verification_failures);
+    w.put("decompression_time_ns", result.decompression_time_ns);
+    w.put("signal_bytes", result.signal_bytes);
+    w.put("compression_mbps", result.compression_mbps);
+    w.put("peak_memory_bytes", result.peak_memory_bytes);
+    w.putCounters("encode_counters", result.encode_counters);
+    w.putCounters("decode_counters", result.decode_counters);
+    w.put("resources.user_seconds", result.resources.user_seconds);
+    w.put("resources.system_seconds", result.resources.system_seconds);
+    w.put("resources.max_rss_bytes", result.resources.max_rss_bytes);
+    w.put("resources.minor_faults", result.resources.minor_faults);
+    w.put("resources.major_faults", result.resources.major_faults);
+    w.put("resources.voluntary_switches", result.resources.voluntary_switches);
+    w.put("resources.involuntary_switches", result.resources.involuntary_switches);
+    w.put("resources.io_rchar", result.resources.io_rchar);
+    w.put("resources.io_wchar", result.resources.io_wchar);
+    w.put("resources.io_read_bytes", result.resources.io_read_bytes);
+    w.put("resources.io_write_bytes", result.resources.io_write_bytes);
+    w.putIo("io.source", result.source_io);
+    w.putIo("io.destination", result.destination_io);
+    w.putIo("io.decode", result.decode_io);
+    w.putReads("reads", result.reads);
+    w.put("phases.source_open_ns", result.phases.source_open_ns);
+    w.put("phases.metadata_copy_ns", result.phases.metadata_copy_ns);
+    w.put("phases.source_read_ns", result.phases.source_read_ns);
+    w.put("phases.dataset_create_ns", result.phases.dataset_create_ns);
+    w.put("phases.encode_write_ns", result.phases.encode_write_ns);
+    w.put("phases.flush_close_ns", result.phases.flush_close_ns);
+    w.put("in_memory", result.in_memory ? 1 : 0);
+    w.put("encode_threads", result.encode_threads);
+    w.put("direct_chunks", result.direct_chunks);
+    w.put("decode_threads", result.decode_threads);
+    w.put("chunk_elements", result.chunk_elements);
+    std::stringstream tuned;
+    for (const auto &entry : result.tuned_chunks)
+    {
+        tuned << entry.first << ":" << entry.second << ";";
+    }
+    w.put("tuned_chunks", tuned.str());
+    w.put("chunk_tune_ns", result.chunk_tune_ns);
+    w.put("slice_read_us", result.slice_read_us);
+    std::stringstream mix;
+    for (const auto &entry : result.codec_mix)
+    {
+        mix << entry.first << ":" << entry.second << ";";
+    }
+    w.put("codec_mix", mix.str());
+    w.put("codec_global_best", result.codec_global_best);
+    w.put("codec_gain", result.codec_gain);
+    w.put("codec_fallbacks", result.codec_fallbacks);
+    w.put("codec_select_ns", result.codec_select_ns);
+    w.put("pipeline.wall_ns", result.pipeline.wall_ns);
+    w.put("pipeline.reader_busy_ns", result.pipeline.reader_busy_ns);
+    w.put("pipeline.encoder_busy_ns", result.pipeline.encoder_busy_ns);
+    w.put("pipeline.writer_busy_ns", result.pipeline.writer_busy_ns);
+    w.put("pipeline.reader_blocked_ns", result.pipeline.reader_blocked_ns);
+    w.put("pipeline.encoder_threads", result.pipeline.encoder_threads);
+    w.put("pipeline.chunks", result.pipeline.chunks);
+    w.put("pipeline.peak_inflight_bytes", result.pipeline.peak_inflight_bytes);
+    std::stringstream scaling;
+    scaling << std::setprecision(17);
+    for (const auto &point : result.decode_scaling)
+    {
+        scaling << point.first << ":" << point.second << ";";
+    }
+    w.put("decode_scaling", scaling.str());
+    w.put("stage_count", result.stage_costs.size());
+    for (size_t i = 0; i < result.stage_costs.size(); ++i)
+    {
+        const StageCost &cost = result.stage_costs[i];
+        std::string prefix = "stage." + std::to_string(i) + ".";
+        w.put(prefix + "filter", cost.filter_name);
+        w.put(prefix + "measured", cost.measured ? 1 : 0);
+        w.put(prefix + "input_bytes", cost.input_bytes);
+        w.put(prefix + "output_bytes", cost.output_bytes);
+        w.put(prefix + "encode_ns", cost.encode_ns);
+    }
+    w.put("input_file_bytes", result.input_file_bytes);
+    w.put("output_file_bytes", result.output_file_bytes);
+    w.put("file_ratio", result.file_ratio);
+    w.put("class_count", result.storage_classes.size());
+    for (size_t i = 0; i < result.storage_classes.size(); ++i)
+    {
+        const StorageClass &entry = result.storage_classes[i];
+        std::string prefix = "class." + std::to_string(i) + ".";
+        w.put(prefix + "name", entry.name);
+        w.put(prefix + "datasets", entry.datasets);
+        w.put(prefix + "raw_bytes", entry.raw_bytes);
+        w.put(prefix + "stored_bytes", entry.stored_bytes);
+    }
+    w.putStats("compression_stats", result.compression_stats);
+    w.putStats("decompression_stats", result.decompression_stats);
+    w.put("error", result.error);
+    w.put("end", 1);
+    return w.str();
+}
+
+bool ParallelExecutor::deserializeResult(const std::string &text, CompressionResult &result)
+{
+    FieldReader r(text);
+    // 末尾的 end 标记用来确认工作进程完整写出了结果
+    if (!r.has("end"))
+    {
+        return false;
+    }
+    int in_memory = 0;
+    r.get("filter_name", result.filter_name);
+    r.get("parameters", result.parameters);
+    r.get("compression_level", result.compression_level);
+    r.get("compression_ratio", result.compression_ratio);
+    r.get("compression_time_ms", result.compression_time_ms);
+    r.get("decompression_time_ms", result.decompression_time_ms);
+    r.get("compressed_size_bytes", result.compressed_size_bytes);
+    r.get("original_size_bytes", result.original_size_bytes);
+    r.get("decompression_mbps", result.decompression_mbps);
+    r.get("verified_datasets", result.verified_datasets);
+    r.get("verification_failures", result.verification_failures);
+    r.get("decompression_time_ns", result.decompression_time_ns);
+    r.get("signal_bytes", result.signal_bytes);
+    r.get("compression_mbps", result.compression_mbps);
+    r.get("peak_memory_bytes", result.peak_memory_bytes);
+    r.getCounters("encode_counters", result.encode_counters);
+    r.getCounters("decode_counters", result.decode_counters);
+    r.get("resources.user_seconds", result.resources.user_seconds);
+    r.get("resources.system_seconds", result.resources.system_seconds);
+    r.get("resources.max_rss_bytes", result.resources.max_rss_bytes);
+    r.get("resources.minor_faults", result.resources.minor_faults);
+    r.get("resources.major_faults", result.resources.major_faults);
+    r.get("resources.voluntary_switches", result.resources.voluntary_switches);
+    r.get("resources.involuntary_switches", result.resources.involuntary_switches);
+    r.get("resources.io_rchar", result.resources.io_rchar);
+    r.get("resources.io_wchar", result.resources.io_wchar);
+    r.get("resources.io_read_bytes", result.resources.io_read_bytes);
+    r.get("resources.io_write_bytes", result.resources.io_write_bytes);
+    r.getIo("io.source", result.source_io);
+    r.getIo("io.destination", result.destination_io);
+    r.getIo("io.decode", result.decode_io);
+    r.getReads("reads", result.reads);
+    r.get("phases.source_open_ns", result.phases.source_open_ns);
+    r.get("phases.metadata_copy_ns", result.phases.metadata_copy_ns);
+    r.get("phases.source_read_ns", result.phases.source_read_ns);
+    r.get("phases.dataset_create_ns", result.phases.dataset_create_ns);
+    r.get("phases.encode_write_ns", result.phases.encode_write_ns);
+    r.get("phases.flush_close_ns", result.phases.flush_close_ns);
+    r.get("in_memory", in_memory);
+    result.in_memory = in_memory != 0;
+    r.get("encode_threads", result.encode_threads);
+    r.get("direct_chunks", result.direct_chunks);
+    r.get("decode_threads", result.decode_threads);
+    r.get("chunk_elements", result.chunk_elements);
+    std::string tuned;
+    r.get("tuned_chunks", tuned);
+    result.tuned_chunks.clear();
+    for (const auto &entry : Utils::split(tuned, ';'))
+    {
+        size_t colon = entry.find(':');
+        if (colon != std::string::npos)
+        {
+            result.tuned_chunks.emplace_back(std::strtoull(entry.substr(0, colon).c_str(), NULL, 10),
+                                             std::strtoull(entry.substr(colon + 1).c_str(), NULL, 10));
+        }
+    }
+    r.get("chunk_tune_ns", result.chunk_tune_ns);
+    r.get("slice_read_us", result.slice_read_us);
+    std::string mix;
+    r.get("codec_mix", mix);
+    result.codec_mix.clear();
+    for (const auto &entry : Utils::split(mix, ';'))
+    {
+        // 候选名本身可能含有级别的冒号，数据集数取最后一个冒号之后
+        size_t colon = entry.rfind(':');
+        if (colon != std::string::npos)
+        {
+            result.codec_mix.emplace_back(entry.substr(0, colon),
+                                          std::strtoull(entry.substr(colon + 1).c_str(), NULL, 10));
+        }
+    }
+    r.get("codec_global_best", result.codec_global_best);
+    r.get("codec_gain", result.codec_gain);
+    r.get("codec_fallbacks", result.codec_fallbacks);
+    r.get("codec_select_ns", result.codec_select_ns);
+    r.get("pipeline.wall_ns", result.pipeline.wall_ns);
+    r.get("pipeline.reader_busy_ns", result.pipeline.reader_busy_ns);
+    r.get("pipeline.encoder_busy_ns", result.pipeline.encoder_busy_ns);
+    r.get("pipeline.writer_busy_ns", result.pipeline.writer_busy_ns);
+    r.get("pipeline.reader_blocked_ns", result.pipeline.reader_blocked_ns);
+    r.get("pipeline.encoder_threads", result.pipeline.encoder_threads);
+    r.get("pipeline.chunks", result.pipeline.chunks);
+    r.get("pipeline.peak_inflight_bytes", result.pipeline.peak_inflight_bytes);
+    std::string scaling;
+    r.get("decode_scaling", scaling);
+    result.decode_scaling.clear();
+    for (const auto &point : Utils::split(scaling, ';'))
+    {
+        size_t colon = point.find(':');
+        if (colon != std::string::npos)
+        {
+            result.decode_scaling.emplace_back(std::atoi(point.substr(0, colon).c_str()),
+                                               std::atof(point.substr(colon + 1).c_str()));
+        }
+    }
+    size_t stage_count = 0;
+    r.get("stage_count", stage_count);
+    result.stage_costs.assign(stage_count, StageCost());
+    for (size_t i = 0; i < stage_count; ++i)
+    {
+        StageCost &cost = result.stage_costs[i];
+        std::string prefix = "stage." + std::to_string(i) + ".";
+        int measured = 0;
+        r.get(prefix + "filter", cost.filter_name);
+        r.get(prefix + "measured", measured);
+        cost.measured = measured != 0;
+        r.get(prefix + "input_bytes", cost.input_bytes);
+        r.get(prefix + "output_bytes", cost.output_bytes);
+        r.get(prefix + "encode_ns", cost.encode_ns);
+    }
+    r.get("input_file_bytes", result.input_file_bytes);
+    r.get("output_file_bytes", result.output_file_bytes);
+    r.get("file_ratio", result.file_ratio);
+    size_t class_count = 0;
+    r.get("class_count", class_count);
+    result.storage_classes.assign(class_count, StorageClass());
+    for (size_t i = 0; i < class_count; ++i)
+    {
+        StorageClass &entry = result.storage_classes[i];
+        std::string prefix = "class." + std::to_string(i) + ".";
+        r.get(prefix + "name", entry.name);
+        r.get(prefix + "datasets", entry.datasets);
+        r.get(prefix + "raw_bytes", entry.raw_bytes);
+        r.get(prefix + "stored_bytes", entry.stored_bytes);
+    }
+    r.getStats("compression_stats", result.compression_stats);
+    r.getStats("decompression_stats", result.decompression_stats);
+    r.get("error", result.error);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 进程池
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    struct RunningWorker
+    {
+        pid_t pid = -1;
+        int fd = -1;
+        size_t task_index = 0;
+        steady_clock::time_point start;
+        std::string output;
+        bool killed_by_timeout = false;
+    };
+
+    // 写满整个缓冲区，处理被信号打断的情况
+    bool writeAll(int fd, const std::string &data)
+    {
+        size_t written = 0;
+        while (written < data.size())
+        {
+            ssize_t n = write(fd, data.data() + written, data.size() - written);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            written += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    std::string taskLabel(const ParallelExecutor::Task &task)
+    {
+        std::string label = task.filter_name;
+        if (!task.parameters.empty())
+        {
+            label += " [" + task.parameters + "]";
+        }
+        if (task.chunk_elements != 0)
+        {
+            label += " chunk " + ChunkTuner::formatChunkSize(task.chunk_elements);
+        }
+        return label + " level " + std::to_string(task.compression_level);
+    }
+
+    CompressionResult failedResult(const ParallelExecutor::Task &task, const std::string &error)
+    {
+        CompressionResult result;
+        result.filter_name = task.filter_name;
+        result.parameters = task.parameters;
+        result.chunk_elements = task.chunk_elements;
+        result.compression_level = task.compression_level;
+        result.error = error;
+        return result;
+    }
+} // namespace
+
+std::vector<CompressionResult> ParallelExecutor::run(const std::vector<Task> &tasks, const TaskFunction &function)
+{
+    std::vector<CompressionResult> results(tasks.size());
+    std::vector<RunningWorker> running;
+    size_t next_task = 0;
+    size_t finished = 0;
+
+    std::cout << "Running " << tasks.size() << " configurations with " << jobs_ << " worker processes" << std::endl;
+
+    while (finished < tasks.size())
+    {
+        // 启动新的工作进程直到达到并发上限
+        while (next_task < tasks.size() && static_cast<int>(running.size()) < jobs_)
+        {
+            const Task &task = tasks[next_task];
+            int pipe_fds[2];
+            if (pipe(pipe_fds) < 0)
+            {
+                std::cerr << "Failed to create pipe for worker: " << std::strerror(errno) << std::endl;
+                results[next_task] = failedResult(task, "pipe failed");
+                ++next_task;
+                ++finished;
+                continue;
+            }
+
+            // fork 前刷新缓冲，避免子进程重复输出父进程缓冲区中的内容
+            std::cout.flush();
+            std::cerr.flush();
+
+            pid_t pid = fork();
+            if (pid < 0)
+            {
+                std::cerr << "Failed to fork worker: " << std::strerror(errno) << std::endl;
+                close(pipe_fds[0]);
+                close(pipe_fds[1]);
+                results[next_task] = failedResult(task, "fork failed");
+                ++next_task;
+                ++finished;
+                continue;
+            }
+
+            if (pid == 0)
+            {
+                // 工作进程：运行任务，把序列化结果写入管道后直接 _exit，
+                // 不执行父进程注册的析构和 atexit（其中包括 H5close）
+                close(pipe_fds[0]);
+                if (!log_dir_.empty())
+                {
+                    std::string log_file = log_dir_ + "/worker_" + FilterDefinitions::pipelineTag(task.filter_name);
+                    if (!task.parameters.empty())
+                    {
+                        log_file += "_" + FilterDefinitions::parameterTag(task.parameters);
+                    }
+                    if (task.chunk_elements != 0)
+                    {
+                        log_file += "_C" + ChunkTuner::formatChunkSize(task.chunk_elements);
+                    }
+                    log_file += "_L" + std::to_string(task.compression_level) + ".log";
+                    int log_fd = open(log_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                    if (log_fd >= 0)
+                    {
+                        dup2(log_fd, STDOUT_FILENO);
+                        dup2(log_fd, STDERR_FILENO);
+                        close(log_fd);
+                    }
+                }
+
+                CompressionResult result = function(task);
+                std::cout.flush();
+                std::cerr.flush();
+                bool ok = writeAll(pipe_fds[1], serializeResult(result));
+                close(pipe_fds[1]);
+                _exit(ok ? 0 : 1);
+            }
+
+            close(pipe_fds[1]);
+            fcntl(pipe_fds[0], F_SETFL, fcntl(pipe_fds[0], F_GETFL) | O_NONBLOCK);
+
+            RunningWorker worker;
+            worker.pid = pid;
+            worker.fd = pipe_fds[0];
+            worker.task_index = next_task;
+            worker.start = steady_clock::now();
+            running.push_back(worker);
+            ++next_task;
+        }
+
+        if (running.empty())
+        {
+            continue;
+        }
+
+        // 等待任意工作进程输出数据或结束
+        std::vector<pollfd> fds;
+        for (const auto &worker : running)
+        {
+            fds.push_back({worker.fd, POLLIN, 0});
+        }
+        int ready = poll(fds.data(), fds.size(), 200);
+        if (ready < 0 && errno != EINTR)
+        {
+            std::cerr << "poll failed: " << std::strerror(errno) << std::endl;
+        }
+
+        for (size_t i = 0; i < running.size();)
+        {
+            RunningWorker &worker = running[i];
+            const Task &task = tasks[worker.task_index];
+            bool eof = false;
+
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                char buffer[4096];
+                while (true)
+                {
+                    ssize_t n = read(worker.fd, buffer, sizeof(buffer));
+                    if (n > 0)
+                    {
+                        worker.output.append(buffer, static_cast<size_t>(n));
+                    }
+                    else if (n == 0)
+                    {
+                        eof = true;
+                        break;
+                    }
+                    else
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                        break; // EAGAIN：暂时没有更多数据
+                    }
+                }
+            }
+
+            // 超时：强制结束工作进程，等它的管道关闭后统一回收
+            if (!eof && !worker.killed_by_timeout && timeout_seconds_ > 0 &&
+                steady_clock::now() - worker.start > seconds(timeout_seconds_))
+            {
+                std::cerr << "Worker for " << taskLabel(task)
+                          << " timed out after " << timeout_seconds_ << " s, killing it" << std::endl;
+                kill(worker.pid, SIGKILL);
+                worker.killed_by_timeout = true;
+            }
+
+            if (!eof)
+            {
+                ++i;
+                continue;
+            }
+
+            // 管道关闭：回收进程并解析结果
+            close(worker.fd);
+            int wait_status = 0;
+            while (waitpid(worker.pid, &wait_status, 0) < 0 && errno == EINTR)
+            {
+            }
+
+            CompressionResult result;
+            if (worker.killed_by_timeout)
+            {
+                result = failedResult(task, "timeout after " + std::to_string(timeout_seconds_) + " s");
+            }
+            else if (WIFSIGNALED(wait_status))
+            {
+                int sig = WTERMSIG(wait_status);
+                result = failedResult(task, "worker crashed (signal " + std::to_string(sig) + ": " + strsignal(sig) + ")");
+            }
+            else if (!deserializeResult(worker.output, result))
+            {
+                int code = WIFEXITED(wait_status) ? WEXITSTATUS(wait_status) : -1;
+                result = failedResult(task, "worker exited with code " + std::to_string(code) + " without a result");
+            }
+
+            if (!result.error.empty())
+            {
+                std::cerr << "  " << taskLabel(task)
+                          << " failed: " << result.error << std::endl;
+            }
+            else
+            {
+                std::cout << "  " << taskLabel(task)
+                          << " done: ratio " << Utils::formatRatio(result.compression_ratio)
+                          << ", " << result.compression_time_ms << " ms" << std::endl;
+            }
+
+            results[worker.task_index] = result;
+            ++finished;
+            running.erase(running.begin() + i);
+            fds.erase(fds.begin() + i);
+        }
+    }
+
+    return results;
+}
@@ -0,0 +1,42 @@
+#ifndef PARALLEL_EXECUTOR_HPP
+#define PARALLEL_EXECUTOR_HPP
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "hdf5_processor.hpp"
+
+// 多进程并行执行器：每个配置 fork 一个工作进程运行，进程之间不共享 HDF5 库状态
+// （本项目使用的 HDF5 不是线程安全版本，只能用进程并行），结果通过管道回传给父进程
+class ParallelExecutor
+{
+public:
+    struct Task
+    {
+        std::string filter_name;
+        std::string parameters; // 过滤器参数网格中的一个点，空表示默认参数
+        size_t chunk_elements = 0; // Signal 分块大小，0 为整个数据集，ChunkTuner::kAuto 为自动调优
+        int compression_level = 0;
+    };
+
+    // 在工作进程中执行一个任务
+    using TaskFunction = std::function<CompressionResult(const Task &)>;
+
+    // jobs：同时运行的工作进程数；timeout_seconds：单个任务的超时时间，0 表示不限制
+    // log_dir：非空时工作进程的标准输出/错误重定向到该目录下的日志文件
+    ParallelExecutor(int jobs, int timeout_seconds, const std::string &log_dir = "");
+
+    // 执行全部任务，返回结果与 tasks 一一对应；崩溃或超时的任务返回带 error 的结果
+    std::vector<CompressionResult> run(const std::vector<Task> &tasks, const TaskFunction &function);
+
+    // CompressionResult 的文本序列化（key=value 每行一项），用于进程间传递
+    static std::string serializeResult(const CompressionResult &result);
+    static bool deserializeResult(const std::string &text, CompressionResult &result);
+
+private:
+    int jobs_;
+    int timeout_seconds_;
+    std::string log_dir_;
+};
+
+#endif // PARALLEL_EXECUTOR_HPP
@@ -0,0 +1,435 @@
+#include "pareto_frontier.hpp"
+#include "chunk_tuner.hpp"
+#include "utils.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+    const ParetoFrontier::Metric kMetrics[] = {ParetoFrontier::Metric::Ratio, ParetoFrontier::Metric::EncodeMbps,
+                                               ParetoFrontier::Metric::DecodeMbps, ParetoFrontier::Metric::PeakMemMb};
+
+    bool higherIsBetter(ParetoFrontier::Metric metric)
+    {
+        return metric != ParetoFrontier::Metric::PeakMemMb;
+    }
+
+    // 峰值内存按页统计，几十 KB 的差异只是噪声：支配比较时按 1 MiB 向上取整
+    double comparableValue(const CompressionResult &result, ParetoFrontier::Metric metric)
+    {
+        double value = ParetoFrontier::metricValue(result, metric);
+        return metric == ParetoFrontier::Metric::PeakMemMb ? std::ceil(value) : value;
+    }
+
+    // 参与分析：完成且校验通过的压缩配置
+    bool eligible(const CompressionResult &result)
+    {
+        return result.error.empty() && result.verification_failures == 0 && result.filter_name != "None" &&
+               result.compression_mbps > 0.0;
+    }
+
+    // a 在所有目标上不差于 b
+    bool covers(const CompressionResult &a, const CompressionResult &b)
+    {
+        for (auto metric : kMetrics)
+        {
+            double va = comparableValue(a, metric);
+            double vb = comparableValue(b, metric);
+            if (higherIsBetter(metric) ? va < vb : va > vb)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // a 在所有目标上不差于 b，且至少一个目标严格更好
+    bool dominates(const CompressionResult &a, const CompressionResult &b)
+    {
+        bool strictly_better = false;
+        for (auto metric : kMetrics)
+        {
+            double va = comparableValue(a, metric);
+            double vb = comparableValue(b, metric);
+            if (!higherIsBetter(metric))
+            {
+                std::swap(va, vb);
+            }
+            if (va < vb)
+            {
+                return false;
+            }
+            strictly_better = strictly_better || va > vb;
+        }
+        return strictly_better;
+    }
+
+    bool satisfies(const CompressionResult &result, const ParetoFrontier::Constraint &constraint)
+    {
+        double value = ParetoFrontier::metricValue(result, constraint.metric);
+        if (constraint.op == ">=")
+        {
+            return value >= constraint.value;
+        }
+        if (constraint.op == "<=")
+        {
+            return value <= constraint.value;
+        }
+        if (constraint.op == ">")
+        {
+            return value > constraint.value;
+        }
+        return value < constraint.value;
+    }
+
+    std::string xmlEscape(const std::string &text)
+    {
+        std::string escaped;
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '<':
+                escaped += "&lt;";
+                break;
+            case '>':
+                escaped += "&gt;";
+                break;
+            case '&':
+                escaped += "&amp;";
+                break;
+            case '"':
+                escaped += "&quot;";
+                break;
+            default:
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    std::string pointLabel(const CompressionResult &result)
+    {
+        std::string label = result.filter_name;
+        if (!result.parameters.empty())
+        {
+            label += "[" + result.parameters + "]";
+        }
+        label += " L" + std::to_string(result.compression_level);
+        if (result.chunk_elements != 0)
+        {
+            label += ' ';
+            label += ChunkTuner::formatChunkSize(result.chunk_elements);
+        }
+        return label;
+    }
+} // namespace
+
+const char *ParetoFrontier::metricName(Metric metric)
+{
+    switch (metric)
+    {
+    case Metric::Ratio:
+        return "ratio";
+    case Metric::EncodeMbps:
+        return "encode_mbps";
+    case Metric::DecodeMbps:
+        return "decode_mbps";
+    case Metric::PeakMemMb:
+        return "peak_mem_mb";
+    }
+    return "";
+}
+
+double ParetoFrontier::metricValue(const CompressionResult &result, Metric metric)
+{
+    switch (metric)
+    {
+    case Metric::Ratio:
+        return result.compression_ratio;
+    case Metric::EncodeMbps:
+        return result.compression_mbps;
+    case Metric::DecodeMbps:
+        return result.decompression_mbps;
+    case Metric::PeakMemMb:
+        return result.peak_memory_bytes / (1024.0 * 1024.0);
+    }
+    return 0.0;
+}
+
+bool ParetoFrontier::parseConstraint(const std::string &text, Constraint &constraint, std::string &error)
+{
+    static const char *ops[] = {">=", "<=", ">", "<"};
+    for (const char *op : ops)
+    {
+        size_t pos = text.find(op);
+        if (pos == std::string::npos)
+        {
+            continue;
+        }
+        std::string name = Utils::toLower(Utils::trim(text.substr(0, pos)));
+        std::string value = Utils::trim(text.substr(pos + std::string(op).size()));
+        bool known = false;
+        for (auto metric : kMetrics)
+        {
+            if (name == metricName(metric))
+            {
+                constraint.metric = metric;
+                known = true;
+            }
+        }
+        if (!known)
+        {
+            error = "unknown metric '" + name + "' in requirement '" + text +
+                    "' (expected ratio, encode_mbps, decode_mbps or peak_mem_mb)";
+            return false;
+        }
+        char *end = nullptr;
+        constraint.value = std::strtod(value.c_str(), &end);
+        if (value.empty() || end == nullptr || *end != '\0')
+        {
+            error = "invalid value '" + value + "' in requirement '" + text + "'";
+            return false;
+        }
+        constraint.op = op;
+        constraint.text = name + op + value;
+        return true;
+    }
+    error = "requirement '" + text + "' has no comparison (expected e.g. decode_mbps>=500)";
+    return false;
+}
+
+ParetoFrontier::ParetoFrontier(const std::vector<CompressionResult> &results, const std::vector<Constraint> &constraints)
+    : constraints_(constraints)
+{
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const CompressionResult &result = results[i];
+        if (eligible(result))
+        {
+            Point point;
+            point.index = i;
+            point.feasible = std::all_of(constraints_.begin(), constraints_.end(),
+                                         [&](const Constraint &c)
+                                         { return satisfies(result, c); });
+            points_.push_back(point);
+        }
+    }
+
+    for (auto &point : points_)
+    {
+        point.on_frontier = true;
+        for (const auto &other : points_)
+        {
+            if (&other != &point && dominates(results[other.index], results[point.index]))
+            {
+                point.on_frontier = false;
+                break;
+            }
+        }
+    }
+    // 被支配的配置记录一个支配它的前沿配置（支配关系可传递，前沿上总能找到一个）
+    for (auto &point : points_)
+    {
+        for (const auto &other : points_)
+        {
+            if (!point.on_frontier && other.on_frontier && dominates(results[other.index], results[point.index]))
+            {
+                point.dominated_by = static_cast<int>(other.index);
+                break;
+            }
+        }
+    }
+
+    for (const auto &point : points_)
+    {
+        if (!point.feasible)
+        {
+            continue;
+        }
+        const CompressionResult &candidate = results[point.index];
+        if (recommended_ < 0 || candidate.compression_ratio > results[recommended_].compression_ratio ||
+            (candidate.compression_ratio == results[recommended_].compression_ratio &&
+             candidate.decompression_mbps > results[recommended_].decompression_mbps))
+        {
+            recommended_ = static_cast<int>(point.index);
+        }
+    }
+}
+
+int ParetoFrontier::coveringPoint(const std::vector<CompressionResult> &measured, const CompressionResult &candidate,
+                                  double ratio_bound)
+{
+    CompressionResult bound;
+    bound.compression_ratio = ratio_bound;
+    bool has_lower_level = false;
+    bool has_any_level = false;
+    for (const auto &other : measured)
+    {
+        if (!eligible(other) || other.filter_name != candidate.filter_name ||
+            other.parameters != candidate.parameters || other.chunk_elements != candidate.chunk_elements)
+        {
+            continue;
+        }
+        // 更高的级别通常编码更慢，但解码速度与内存不随级别单调变化
+        if (other.compression_level <= candidate.compression_level)
+        {
+            bound.compression_mbps = std::max(bound.compression_mbps, other.compression_mbps);
+            has_lower_level = true;
+        }
+        bound.decompression_mbps = std::max(bound.decompression_mbps, other.decompression_mbps);
+        bound.peak_memory_bytes = has_any_level ? std::min(bound.peak_memory_bytes, other.peak_memory_bytes)
+                                                : other.peak_memory_bytes;
+        has_any_level = true;
+    }
+    if (!has_lower_level)
+    {
+        return -1;
+    }
+    for (size_t i = 0; i < measured.size(); ++i)
+    {
+        if (eligible(measured[i]) && covers(measured[i], bound))
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+const ParetoFrontier::Point *ParetoFrontier::find(size_t index) const
+{
+    for (const auto &point : points_)
+    {
+        if (point.index == index)
+        {
+            return &point;
+        }
+    }
+    return nullptr;
+}
+
+bool ParetoFrontier::writeSvg(const std::string &path, const std::vector<CompressionResult> &results) const
+{
+    const int panel_width = 460;
+    const int panel_height = 360;
+    const int margin_left = 60;
+    const int margin_top = 40;
+    const int plot_width = panel_width - margin_left - 20;
+    const int plot_height = panel_height - margin_top - 50;
+
+    double max_ratio = 1.0;
+    for (const auto &point : points_)
+    {
+        max_ratio = std::max(max_ratio, results[point.index].compression_ratio);
+    }
+    double y_max = std::ceil(max_ratio * 1.1 * 4.0) / 4.0;
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    ss << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << panel_width * 2 << "\" height=\""
+       << panel_height + 30 << "\" font-family=\"sans-serif\" font-size=\"11\">\n";
+    ss << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+
+    const std::pair<Metric, const char *> panels[] = {{Metric::EncodeMbps, "Encode throughput (MB/s, log)"},
+                                                      {Metric::DecodeMbps, "Decode throughput (MB/s, log)"}};
+    for (int p = 0; p < 2; ++p)
+    {
+        Metric metric = panels[p].first;
+        double x_min = 0.0;
+        double x_max = 0.0;
+        for (const auto &point : points_)
+        {
+            double value = std::max(metricValue(results[point.index], metric), 1e-3);
+            x_min = x_min == 0.0 ? value : std::min(x_min, value);
+            x_max = std::max(x_max, value);
+        }
+        double log_min = std::floor(std::log10(x_min > 0.0 ? x_min : 1.0));
+        double log_max = std::max(log_min + 1.0, std::ceil(std::log10(x_max > 0.0 ? x_max : 10.0)));
+
+        int ox = p * panel_width + margin_left;
+        int oy = margin_top + plot_height;
+        auto sx = [&](double value)
+        { return ox + (std::log10(std::max(value, 1e-3)) - log_min) / (log_max - log_min) * plot_width; };
+        auto sy = [&](double ratio)
+        { return oy - std::max(0.0, ratio) / y_max * plot_height; };
+
+        ss << "<g>\n";
+        ss << "<text x=\"" << ox + plot_width / 2 << "\" y=\"20\" text-anchor=\"middle\" font-size=\"13\">"
+           << "Compression ratio vs " << (metric == Metric::EncodeMbps ? "encode" : "decode") << " throughput</text>\n";
+        ss << "<rect x=\"" << ox << "\" y=\"" << margin_top << "\" width=\"" << plot_width << "\" height=\""
+           << plot_height << "\" fill=\"none\" stroke=\"#333\"/>\n";
+        for (double decade = log_min; decade <= log_max; decade += 1.0)
+        {
+            double x = sx(std::pow(10.0, decade));
+            ss << "<line x1=\"" << x << "\" y1=\"" << margin_top << "\" x2=\"" << x << "\" y2=\"" << oy
+               << "\" stroke=\"#ddd\"/>\n";
+            ss << "<text x=\"" << x << "\" y=\"" << oy + 15 << "\" text-anchor=\"middle\">"
+               << std::setprecision(decade < 0 ? static_cast<int>(-decade) : 0) << std::pow(10.0, decade)
+               << std::setprecision(1) << "</text>\n";
+        }
+        for (int t = 0; t <= 4; ++t)
+        {
+            double ratio = y_max * t / 4.0;
+            ss << "<line x1=\"" << ox << "\" y1=\"" << sy(ratio) << "\" x2=\"" << ox + plot_width << "\" y2=\""
+               << sy(ratio) << "\" stroke=\"#eee\"/>\n";
+            ss << "<text x=\"" << ox - 6 << "\" y=\"" << sy(ratio) + 4 << "\" text-anchor=\"end\">"
+               << std::setprecision(2) << ratio << std::setprecision(1) << "</text>\n";
+        }
+        ss << "<text x=\"" << ox + plot_width / 2 << "\" y=\"" << oy + 35 << "\" text-anchor=\"middle\">"
+           << panels[p].second << "</text>\n";
+        ss << "<text x=\"" << ox - 42 << "\" y=\"" << margin_top + plot_height / 2 << "\" text-anchor=\"middle\" "
+           << "transform=\"rotate(-90 " << ox - 42 << " " << margin_top + plot_height / 2 << ")\">Compression ratio</text>\n";
+
+        // 被支配的配置为空心灰点，前沿为实心蓝点，不满足约束的配置半透明，推荐配置加红圈
+        for (const auto &point : points_)
+        {
+            const CompressionResult &result = results[point.index];
+            double x = sx(metricValue(result, metric));
+            double y = sy(result.compression_ratio);
+            ss << "<circle cx=\"" << x << "\" cy=\"" << y << "\" r=\"4\" "
+               << (point.on_frontier ? "fill=\"#1f77b4\" stroke=\"#1f77b4\"" : "fill=\"none\" stroke=\"#999\"")
+               << (point.feasible ? "" : " opacity=\"0.35\"") << "><title>" << xmlEscape(pointLabel(result))
+               << ": ratio " << std::setprecision(2) << result.compression_ratio << ", encode "
+               << result.compression_mbps << " MB/s, decode " << result.decompression_mbps << " MB/s, peak "
+               << metricValue(result, Metric::PeakMemMb) << " MB" << std::setprecision(1) << "</title></circle>\n";
+            if (static_cast<int>(point.index) == recommended_)
+            {
+                ss << "<circle cx=\"" << x << "\" cy=\"" << y << "\" r=\"8\" fill=\"none\" stroke=\"#d62728\" "
+                   << "stroke-width=\"2\"/>\n";
+            }
+            if (point.on_frontier)
+            {
+                ss << "<text x=\"" << x + 6 << "\" y=\"" << y - 6 << "\" fill=\"#1f77b4\">"
+                   << xmlEscape(pointLabel(result)) << "</text>\n";
+            }
+        }
+        ss << "</g>\n";
+    }
+
+    ss << "<text x=\"" << margin_left << "\" y=\"" << panel_height + 20 << "\">"
+       << "Filled: Pareto frontier (ratio, encode MB/s, decode MB/s, peak memory); hollow: dominated";
+    if (!constraints_.empty())
+    {
+        ss << "; faded: fails";
+        for (const auto &constraint : constraints_)
+        {
+            ss << " " << xmlEscape(constraint.text);
+        }
+    }
+    ss << "; red ring: recommended</text>\n";
+    ss << "</svg>\n";
+
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        std::cerr << "Failed to write Pareto plot: " << path << std::endl;
+        return false;
+    }
+    file << ss.str();
+    return file.good();
+}
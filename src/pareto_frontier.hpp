@@ -0,0 +1,68 @@
+#ifndef PARETO_FRONTIER_HPP
+#define PARETO_FRONTIER_HPP
+
+#include <string>
+#include <vector>
+#include "hdf5_processor.hpp"
+
+// 在 压缩比、编码吞吐量、解码吞吐量、峰值内存 四个目标上求 Pareto 前沿：
+// 标记被支配的配置，并在 --require 约束下给出推荐配置
+class ParetoFrontier
+{
+public:
+    enum class Metric
+    {
+        Ratio,      // 压缩比，越大越好
+        EncodeMbps, // 编码吞吐量（MB/s），越大越好
+        DecodeMbps, // 解码吞吐量（MB/s），越大越好
+        PeakMemMb   // 峰值内存增量（MB），越小越好
+    };
+
+    // --require 约束，例如 "decode_mbps>=500"
+    struct Constraint
+    {
+        Metric metric = Metric::Ratio;
+        std::string op; // ">=", "<=", ">", "<"
+        double value = 0.0;
+        std::string text;
+    };
+
+    struct Point
+    {
+        size_t index = 0;        // 在结果列表中的下标
+        bool on_frontier = false;
+        int dominated_by = -1;   // 支配它的一个前沿配置的下标，前沿上为 -1
+        bool feasible = true;    // 是否满足全部约束
+    };
+
+    // 解析 "metric op value"；metric 为 ratio、encode_mbps、decode_mbps、peak_mem_mb
+    static bool parseConstraint(const std::string &text, Constraint &constraint, std::string &error);
+    static const char *metricName(Metric metric);
+    static double metricValue(const CompressionResult &result, Metric metric);
+
+    // 扫描剪枝：未测配置 candidate 的乐观位置在全部目标上都不优于 measured 中某个已测配置时，返回该配置的下标，
+    // 否则返回 -1。乐观位置的压缩比取 ratio_bound，编码吞吐量取同一配置（过滤器、参数、分块大小）不高于该级别的
+    // 已测级别中最高者，解码吞吐量与峰值内存取同一配置全部已测级别中最好者；同一配置没有不高于该级别的已测级别时不剪除
+    static int coveringPoint(const std::vector<CompressionResult> &measured, const CompressionResult &candidate,
+                             double ratio_bound);
+
+    // 只有完成且校验通过的压缩配置参与分析（未压缩基准没有编码耗时，不参与）
+    ParetoFrontier(const std::vector<CompressionResult> &results, const std::vector<Constraint> &constraints);
+
+    const std::vector<Point> &points() const { return points_; }
+    const std::vector<Constraint> &constraints() const { return constraints_; }
+    // results 中下标对应的分析结果，不参与分析时返回 nullptr
+    const Point *find(size_t index) const;
+    // 满足约束的配置中压缩比最高者（相同时取解码更快者），没有时返回 -1
+    int recommended() const { return recommended_; }
+
+    // 压缩比 × 编码吞吐量、压缩比 × 解码吞吐量 两幅散点图（吞吐量为对数坐标）
+    bool writeSvg(const std::string &path, const std::vector<CompressionResult> &results) const;
+
+private:
+    std::vector<Constraint> constraints_;
+    std::vector<Point> points_;
+    int recommended_ = -1;
+};
+
+#endif // PARETO_FRONTIER_HPP
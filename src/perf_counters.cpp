@@ -0,0 +1,172 @@
+#include "perf_counters.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/resource.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+namespace
+{
+#ifdef __linux__
+    // 只计当前进程（pid 0）及其之后创建的线程，任意 CPU
+    int openEvent(uint32_t type, uint64_t config, bool exclude_kernel)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.inherit = 1;
+        attr.exclude_kernel = exclude_kernel ? 1 : 0;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    void rusageValues(long long &cpu_ns, long long &context_switches)
+    {
+        rusage usage;
+        std::memset(&usage, 0, sizeof(usage));
+        getrusage(RUSAGE_SELF, &usage);
+        cpu_ns = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000LL +
+                 (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000LL;
+        context_switches = usage.ru_nvcsw + usage.ru_nivcsw;
+    }
+} // namespace
+
+PerfCounters::~PerfCounters()
+{
+    close();
+}
+
+void PerfCounters::close()
+{
+    for (int &fd : fds_)
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    opened_ = false;
+}
+
+void PerfCounters::open()
+{
+    // fork 继承的描述符计的是父进程，在工作进程中需要重新打开
+    close();
+    owner_ = getpid();
+    opened_ = true;
+    source_ = "rusage";
+    note_.clear();
+
+#ifdef __linux__
+    // 硬件计数只计用户态（perf_event_paranoid 为 2 时也允许）
+    fds_[kCycles] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, true);
+    if (fds_[kCycles] >= 0)
+    {
+        fds_[kInstructions] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, true);
+        fds_[kLlcMisses] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, true);
+        fds_[kBranchMisses] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, true);
+    }
+    else
+    {
+        note_ = std::string("hardware counters unavailable (perf_event_open: ") + std::strerror(errno) + ")";
+    }
+
+    // 上下文切换发生在内核态，不允许计内核事件时退回 getrusage
+    fds_[kContextSwitches] = openEvent(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, false);
+    fds_[kTaskClock] = openEvent(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, true);
+    if (fds_[kCycles] >= 0 && fds_[kTaskClock] >= 0)
+    {
+        source_ = "hardware";
+    }
+    else if (fds_[kTaskClock] >= 0)
+    {
+        source_ = "software";
+    }
+    else
+    {
+        note_ = std::string("perf_event_open unavailable (") + std::strerror(errno) + "), using getrusage";
+        close();
+        opened_ = true;
+    }
+#else
+    note_ = "perf_event_open is Linux-only, using getrusage";
+#endif
+}
+
+bool PerfCounters::read(long long *values) const
+{
+    long long cpu_ns = 0;
+    long long context_switches = 0;
+    rusageValues(cpu_ns, context_switches);
+    for (int e = 0; e < kEventCount; ++e)
+    {
+        values[e] = -1;
+        if (fds_[e] < 0)
+        {
+            continue;
+        }
+        // 值、启用时间、运行时间；计数器被复用（multiplexing）时按 启用/运行 比例放大
+        uint64_t data[3] = {0, 0, 0};
+        if (::read(fds_[e], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+        {
+            continue;
+        }
+        double value = static_cast<double>(data[0]);
+        if (data[2] > 0 && data[2] < data[1])
+        {
+            value *= static_cast<double>(data[1]) / data[2];
+        }
+        values[e] = static_cast<long long>(value);
+    }
+    if (values[kTaskClock] < 0)
+    {
+        values[kTaskClock] = cpu_ns;
+    }
+    if (values[kContextSwitches] < 0)
+    {
+        values[kContextSwitches] = context_switches;
+    }
+    return true;
+}
+
+void PerfCounters::start()
+{
+    if (!opened_ || owner_ != getpid())
+    {
+        open();
+    }
+    read(start_values_);
+}
+
+CounterSample PerfCounters::stop(size_t bytes)
+{
+    CounterSample sample;
+    if (!opened_)
+    {
+        return sample;
+    }
+    long long values[kEventCount];
+    read(values);
+    auto delta = [&](Event e)
+    { return values[e] >= 0 && start_values_[e] >= 0 ? std::max(0LL, values[e] - start_values_[e]) : -1LL; };
+
+    sample.source = source_;
+    sample.cycles = delta(kCycles);
+    sample.instructions = delta(kInstructions);
+    sample.llc_misses = delta(kLlcMisses);
+    sample.branch_misses = delta(kBranchMisses);
+    sample.context_switches = std::max(0LL, delta(kContextSwitches));
+    sample.task_clock_ns = std::max(0LL, delta(kTaskClock));
+    sample.bytes = bytes;
+    return sample;
+}
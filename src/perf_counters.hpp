@@ -0,0 +1,78 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <string>
+#include <cstddef>
+#include <sys/types.h>
+
+// 一个阶段（编码或解码）的计数结果；不可用的硬件计数为 -1
+struct CounterSample
+{
+    std::string source; // "hardware"、"software"（内核软件事件）、"rusage"，为空表示未采集
+    long long cycles = -1;
+    long long instructions = -1;
+    long long llc_misses = -1;
+    long long branch_misses = -1;
+    long long context_switches = 0;
+    long long task_clock_ns = 0; // 进程内所有线程的 CPU 时间
+    size_t bytes = 0;            // 该阶段处理的 Signal 原始字节数
+
+    bool collected() const { return !source.empty(); }
+    double ipc() const { return cycles > 0 && instructions >= 0 ? static_cast<double>(instructions) / cycles : 0.0; }
+    // 每 MB 处理数据的计数，计数不可用时为 -1
+    double perMb(long long count) const
+    {
+        return count >= 0 && bytes > 0 ? count / (bytes / (1024.0 * 1024.0)) : -1.0;
+    }
+    // 每千条指令的末级缓存未命中数（MPKI），不可用时为 -1
+    double llcMpki() const
+    {
+        return llc_misses >= 0 && instructions > 0 ? llc_misses * 1000.0 / instructions : -1.0;
+    }
+};
+
+// perf_event_open 计数器：依次尝试硬件计数（周期、指令、末级缓存未命中、分支预测失败）与
+// 软件事件（上下文切换、任务时钟）；内核拒绝时退回 getrusage。
+// 计数器随打开它的线程之后创建的线程继承（编码/解码线程池结束时计入），
+// fork 出的工作进程中第一次 start() 会重新打开
+class PerfCounters
+{
+public:
+    PerfCounters() = default;
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    void start();
+    CounterSample stop(size_t bytes);
+
+    // "hardware"、"software" 或 "rusage"；note 为退化原因（例如 perf_event_open 的错误）
+    const std::string &source() const { return source_; }
+    const std::string &note() const { return note_; }
+
+private:
+    enum Event
+    {
+        kCycles,
+        kInstructions,
+        kLlcMisses,
+        kBranchMisses,
+        kContextSwitches,
+        kTaskClock,
+        kEventCount
+    };
+
+    void open();
+    void close();
+    bool read(long long *values) const;
+
+    int fds_[kEventCount] = {-1, -1, -1, -1, -1, -1};
+    long long start_values_[kEventCount] = {0};
+    pid_t owner_ = 0;
+    bool opened_ = false;
+    std::string source_;
+    std::string note_;
+};
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,119 @@
+#include "read_table.hpp"
+#include <map>
+
+namespace
+{
+    double mbps(uint64_t bytes, int64_t ns)
+    {
+        return ns > 0 ? bytes / (1024.0 * 1024.0) / (ns / 1.0e9) : -1.0;
+    }
+
+    std::string sizeLabel(uint64_t elements)
+    {
+        if (elements >= (1ULL << 20) && elements % (1ULL << 20) == 0)
+        {
+            return std::to_string(elements >> 20) + "M";
+        }
+        if (elements >= (1ULL << 10) && elements % (1ULL << 10) == 0)
+        {
+            return std::to_string(elements >> 10) + "K";
+        }
+        return std::to_string(elements);
+    }
+} // namespace
+
+void ReadTable::clear()
+{
+    paths.clear();
+    elements.clear();
+    original_bytes.clear();
+    compressed_bytes.clear();
+    encode_ns.clear();
+    decode_ns.clear();
+    index_.clear();
+}
+
+size_t ReadTable::add(const std::string &path, uint64_t element_count, uint64_t bytes)
+{
+    index_[path] = paths.size();
+    paths.push_back(path);
+    elements.push_back(element_count);
+    original_bytes.push_back(bytes);
+    compressed_bytes.push_back(0);
+    encode_ns.push_back(-1);
+    decode_ns.push_back(-1);
+    return paths.size() - 1;
+}
+
+long ReadTable::find(const std::string &path) const
+{
+    auto it = index_.find(path);
+    return it != index_.end() ? static_cast<long>(it->second) : -1;
+}
+
+void ReadTable::reindex()
+{
+    index_.clear();
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        index_[paths[i]] = i;
+    }
+}
+
+double ReadTable::ratio(size_t row) const
+{
+    return compressed_bytes[row] > 0 ? static_cast<double>(original_bytes[row]) / compressed_bytes[row] : -1.0;
+}
+
+double ReadTable::encodeMbps(size_t row) const
+{
+    return mbps(original_bytes[row], encode_ns[row]);
+}
+
+double ReadTable::decodeMbps(size_t row) const
+{
+    return mbps(original_bytes[row], decode_ns[row]);
+}
+
+std::vector<ReadTable::LengthBucket> ReadTable::lengthBuckets() const
+{
+    std::map<int, LengthBucket> buckets;
+    for (size_t i = 0; i < size(); ++i)
+    {
+        if (compressed_bytes[i] == 0)
+        {
+            continue;
+        }
+        int k = 0;
+        while (k < 63 && (elements[i] >> (k + 1)) != 0)
+        {
+            ++k;
+        }
+        LengthBucket &bucket = buckets[k];
+        bucket.log2_elements = k;
+        bucket.reads++;
+        bucket.original_bytes += original_bytes[i];
+        bucket.compressed_bytes += compressed_bytes[i];
+        if (encode_ns[i] > 0)
+        {
+            bucket.encode_ns += encode_ns[i];
+            bucket.encode_bytes += original_bytes[i];
+        }
+        if (decode_ns[i] > 0)
+        {
+            bucket.decode_ns += decode_ns[i];
+            bucket.decode_bytes += original_bytes[i];
+        }
+    }
+    std::vector<LengthBucket> result;
+    for (const auto &entry : buckets)
+    {
+        result.push_back(entry.second);
+    }
+    return result;
+}
+
+std::string ReadTable::bucketLabel(int log2_elements)
+{
+    return sizeLabel(1ULL << log2_elements) + "-" + sizeLabel(1ULL << (log2_elements + 1));
+}
@@ -0,0 +1,62 @@
+#ifndef READ_TABLE_HPP
+#define READ_TABLE_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+// 每个 Signal 数据集（read）一行的列式明细表：原始大小、压缩后大小、编码与解码耗时。
+// 编码/解码耗时无法归属到单个数据集时（分块直写、流水线、分块并行解码）为 -1
+class ReadTable
+{
+public:
+    std::vector<std::string> paths;
+    std::vector<uint64_t> elements;         // 采样点数（读长）
+    std::vector<uint64_t> original_bytes;
+    std::vector<uint64_t> compressed_bytes; // H5Dget_storage_size
+    std::vector<int64_t> encode_ns;         // H5Dwrite + H5Dflush
+    std::vector<int64_t> decode_ns;         // H5Dopen + H5Dread + H5Dclose
+
+    // 按 floor(log2(读长)) 分组的汇总
+    struct LengthBucket
+    {
+        int log2_elements = 0; // 读长范围 [2^k, 2^(k+1))
+        size_t reads = 0;
+        uint64_t original_bytes = 0;
+        uint64_t compressed_bytes = 0;
+        int64_t encode_ns = 0; // 只累计有单独耗时的数据集
+        uint64_t encode_bytes = 0;
+        int64_t decode_ns = 0;
+        uint64_t decode_bytes = 0;
+
+        double ratio() const { return compressed_bytes > 0 ? static_cast<double>(original_bytes) / compressed_bytes : 0.0; }
+        double encodeMbps() const { return encode_ns > 0 ? encode_bytes / (1024.0 * 1024.0) / (encode_ns / 1.0e9) : 0.0; }
+        double decodeMbps() const { return decode_ns > 0 ? decode_bytes / (1024.0 * 1024.0) / (decode_ns / 1.0e9) : 0.0; }
+    };
+
+    size_t size() const { return paths.size(); }
+    bool empty() const { return paths.empty(); }
+    void clear();
+
+    // 追加一行（压缩后大小为 0、耗时为 -1），返回行号
+    size_t add(const std::string &path, uint64_t element_count, uint64_t bytes);
+    // 按路径查找行号，没有时返回 -1
+    long find(const std::string &path) const;
+    // 反序列化后按 paths 重建路径索引
+    void reindex();
+
+    // 单个数据集的压缩比与吞吐量（MB/s），不可用时为 -1
+    double ratio(size_t row) const;
+    double encodeMbps(size_t row) const;
+    double decodeMbps(size_t row) const;
+
+    std::vector<LengthBucket> lengthBuckets() const;
+    // 读长分组的标签，例如 "4K-8K"
+    static std::string bucketLabel(int log2_elements);
+
+private:
+    std::unordered_map<std::string, size_t> index_;
+};
+
+#endif // READ_TABLE_HPP
@@ -0,0 +1,94 @@
+#include "resource_usage.hpp"
+#include "utils.hpp"
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    // 读取 /proc/self/io 中的 "key: value" 项，不可用时保持 -1
+    void readProcIo(ResourceUsage &usage)
+    {
+        std::ifstream io("/proc/self/io");
+        std::string line;
+        while (std::getline(io, line))
+        {
+            size_t colon = line.find(':');
+            if (colon == std::string::npos)
+            {
+                continue;
+            }
+            std::string key = line.substr(0, colon);
+            long long value = std::strtoll(line.c_str() + colon + 1, nullptr, 10);
+            if (key == "rchar")
+            {
+                usage.io_rchar = value;
+            }
+            else if (key == "wchar")
+            {
+                usage.io_wchar = value;
+            }
+            else if (key == "read_bytes")
+            {
+                usage.io_read_bytes = value;
+            }
+            else if (key == "write_bytes")
+            {
+                usage.io_write_bytes = value;
+            }
+        }
+    }
+
+    long long ioDelta(long long end, long long start)
+    {
+        return end >= 0 && start >= 0 ? end - start : -1;
+    }
+} // namespace
+
+ResourceUsage ResourceUsage::capture()
+{
+    ResourceUsage usage;
+#ifndef _WIN32
+    rusage ru;
+    std::memset(&ru, 0, sizeof(ru));
+    if (getrusage(RUSAGE_SELF, &ru) == 0)
+    {
+        usage.user_seconds = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1.0e6;
+        usage.system_seconds = ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1.0e6;
+        usage.max_rss_bytes = static_cast<size_t>(ru.ru_maxrss) * 1024;
+        usage.minor_faults = ru.ru_minflt;
+        usage.major_faults = ru.ru_majflt;
+        usage.voluntary_switches = ru.ru_nvcsw;
+        usage.involuntary_switches = ru.ru_nivcsw;
+    }
+    // ru_maxrss 是进程生命周期的峰值；VmHWM 可被重置（见 Utils::resetPeakResidentMemory），优先使用
+    size_t peak = Utils::getPeakResidentMemory();
+    if (peak > 0)
+    {
+        usage.max_rss_bytes = peak;
+    }
+    readProcIo(usage);
+#endif
+    return usage;
+}
+
+ResourceUsage ResourceUsage::since(const ResourceUsage &start) const
+{
+    ResourceUsage delta;
+    delta.user_seconds = user_seconds - start.user_seconds;
+    delta.system_seconds = system_seconds - start.system_seconds;
+    delta.max_rss_bytes = max_rss_bytes;
+    delta.minor_faults = minor_faults - start.minor_faults;
+    delta.major_faults = major_faults - start.major_faults;
+    delta.voluntary_switches = voluntary_switches - start.voluntary_switches;
+    delta.involuntary_switches = involuntary_switches - start.involuntary_switches;
+    delta.io_rchar = ioDelta(io_rchar, start.io_rchar);
+    delta.io_wchar = ioDelta(io_wchar, start.io_wchar);
+    delta.io_read_bytes = ioDelta(io_read_bytes, start.io_read_bytes);
+    delta.io_write_bytes = ioDelta(io_write_bytes, start.io_write_bytes);
+    return delta;
+}
@@ -0,0 +1,37 @@
+#ifndef RESOURCE_USAGE_HPP
+#define RESOURCE_USAGE_HPP
+
+#include <cstddef>
+
+// 一个配置运行期间的进程资源消耗：getrusage（RUSAGE_SELF，含所有线程）与 /proc/self/io 的差值。
+// --jobs 的工作进程各自测量自己
+struct ResourceUsage
+{
+    double user_seconds = 0.0;
+    double system_seconds = 0.0;
+    size_t max_rss_bytes = 0;          // 运行期间的峰值常驻内存（绝对值，不是差值）
+    long long minor_faults = 0;
+    long long major_faults = 0;
+    long long voluntary_switches = 0;
+    long long involuntary_switches = 0;
+    // /proc/self/io：rchar/wchar 为 read/write 系统调用的字节数（含页缓存命中），
+    // read_bytes/write_bytes 为实际提交给存储层的字节数；不可用时为 -1
+    long long io_rchar = -1;
+    long long io_wchar = -1;
+    long long io_read_bytes = -1;
+    long long io_write_bytes = -1;
+
+    double cpuSeconds() const { return user_seconds + system_seconds; }
+    // 每 GB 处理数据的 CPU 秒数
+    double cpuSecondsPerGb(size_t bytes) const
+    {
+        return bytes > 0 ? cpuSeconds() / (bytes / (1024.0 * 1024.0 * 1024.0)) : 0.0;
+    }
+
+    // 当前累计值
+    static ResourceUsage capture();
+    // this 为结束时的累计值，返回 start 以来的差值（max_rss_bytes 取结束时的值）
+    ResourceUsage since(const ResourceUsage &start) const;
+};
+
+#endif // RESOURCE_USAGE_HPP
@@ -0,0 +1,209 @@
+#include "signal_arena.hpp"
+#include "hdf5_processor.hpp"
+#include "chunk_read_engine.hpp"
+#include "utils.hpp"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+using namespace std::chrono;
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool SignalArena::load(const std::string &input_file, int decode_threads, bool map_source,
+                       const DatasetInventory *inventory)
+{
+    clear();
+    auto load_start = steady_clock::now();
+    if (map_source)
+    {
+        mapped_.open(input_file);
+    }
+
+    hid_t file_id = H5Fopen(input_file.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file_id < 0)
+    {
+        std::cerr << "Failed to open input file for ingest: " << input_file << std::endl;
+        return false;
+    }
+
+    // 第一遍：按对象清单收集Signal数据集的路径、形状和类型，计算每个数据集在内存区中的偏移；
+    // 没有给出属于该文件的清单时先遍历一次
+    DatasetInventory scanned;
+    if (inventory == nullptr || inventory->sourceFile() != input_file)
+    {
+        inventory = scanned.scan(file_id) ? &scanned : nullptr;
+    }
+
+    auto scan_dataset = [&](const std::string &path)
+    {
+        hid_t dset_id = H5Dopen(file_id, path.c_str(), H5P_DEFAULT);
+        if (dset_id < 0)
+        {
+            std::cerr << "Failed to open signal dataset during ingest: " << path << std::endl;
+            return;
+        }
+
+        Entry entry;
+        entry.path = path;
+        hid_t space_id = H5Dget_space(dset_id);
+        entry.rank = H5Sget_simple_extent_ndims(space_id);
+        if (entry.rank < 1 || entry.rank > 3)
+        {
+            std::cerr << "Unsupported signal rank " << entry.rank << ": " << path << std::endl;
+            H5Sclose(space_id);
+            H5Dclose(dset_id);
+            return;
+        }
+        H5Sget_simple_extent_dims(space_id, entry.dims, NULL);
+        entry.length = static_cast<size_t>(H5Sget_simple_extent_npoints(space_id));
+        H5Sclose(space_id);
+
+        hid_t type_id = H5Dget_type(dset_id);
+        size_t type_image_size = 0;
+        H5Tencode(type_id, NULL, &type_image_size);
+        entry.type_image.resize(type_image_size);
+        H5Tencode(type_id, entry.type_image.data(), &type_image_size);
+        H5Tclose(type_id);
+
+        // 连续、未压缩的数据集直接使用映射，不占内存区空间
+        std::span<const int16_t> mapped = mapped_.signal(dset_id);
+        H5Dclose(dset_id);
+        if (mapped.size() == entry.length)
+        {
+            entry.mapped = mapped.data();
+            mapped_bytes_ += mapped.size_bytes();
+        }
+        else
+        {
+            entry.offset = total_bytes_;
+            total_bytes_ = alignUp(entry.offset + entry.length * sizeof(int16_t), kAlignment);
+        }
+        entries_.push_back(std::move(entry));
+    };
+
+    if (inventory != nullptr)
+    {
+        for (size_t index : inventory->signalDatasets())
+        {
+            scan_dataset(inventory->objects()[index].path);
+        }
+    }
+    if (entries_.empty())
+    {
+        std::cerr << "No signal datasets ingested from: " << input_file << std::endl;
+        H5Fclose(file_id);
+        clear();
+        return false;
+    }
+
+    // 一次性分配整块对齐内存
+    buffer_.reset(static_cast<unsigned char *>(std::aligned_alloc(kAlignment, std::max(total_bytes_, kAlignment))));
+    if (!buffer_)
+    {
+        std::cerr << "Failed to allocate " << Utils::formatSize(total_bytes_) << " for the signal arena" << std::endl;
+        H5Fclose(file_id);
+        clear();
+        return false;
+    }
+
+    // 第二遍：把每个数据集解码到各自的偏移处
+    std::unique_ptr<ChunkReadEngine> engine;
+    if (decode_threads > 0)
+    {
+        engine.reset(new ChunkReadEngine(decode_threads));
+    }
+    for (size_t i = 0; i < entries_.size(); ++i)
+    {
+        Entry &entry = entries_[i];
+        if (entry.mapped != nullptr)
+        {
+            index_[entry.path] = i;
+            mapped_entries_++;
+            continue;
+        }
+        int16_t *target = reinterpret_cast<int16_t *>(buffer_.get() + entry.offset);
+        hid_t dset_id = H5Dopen(file_id, entry.path.c_str(), H5P_DEFAULT);
+        bool submitted = dset_id >= 0 && engine && engine->submit(dset_id, entry.path, target, entry.length);
+        if (dset_id < 0 ||
+            (!submitted && H5Dread(dset_id, H5T_NATIVE_INT16, H5S_ALL, H5S_ALL, H5P_DEFAULT, target) < 0))
+        {
+            std::cerr << "Failed to decode signal dataset during ingest: " << entry.path << std::endl;
+            if (dset_id >= 0)
+            {
+                H5Dclose(dset_id);
+            }
+            if (engine)
+            {
+                engine->finish(); // 等待在途分块写完再释放内存区
+            }
+            H5Fclose(file_id);
+            clear();
+            return false;
+        }
+        H5Dclose(dset_id);
+        index_[entry.path] = i;
+    }
+    if (engine && !engine->finish())
+    {
+        std::cerr << "Failed to decode " << engine->failedPaths().size()
+                  << " signal datasets during ingest, first: " << engine->failedPaths().front() << std::endl;
+        H5Fclose(file_id);
+        clear();
+        return false;
+    }
+
+    H5Fclose(file_id);
+    source_file_ = input_file;
+    load_time_ns_ = duration_cast<nanoseconds>(steady_clock::now() - load_start).count();
+
+    std::cout << "Ingested " << entries_.size() << " signal datasets ("
+              << Utils::formatSize(total_bytes_) << ") in "
+              << Utils::formatDuration(load_time_ns_ / 1000000);
+    if (engine)
+    {
+        std::cout << " (" << engine->chunksRead() << " chunks decoded by " << engine->threads() << " threads)";
+    }
+    if (mapped_entries_ > 0)
+    {
+        std::cout << ", " << mapped_entries_ << " datasets (" << Utils::formatSize(mapped_bytes_)
+                  << ") mapped from the source file without copying";
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+void SignalArena::clear()
+{
+    buffer_.reset();
+    mapped_.close();
+    entries_.clear();
+    index_.clear();
+    source_file_.clear();
+    total_bytes_ = 0;
+    mapped_bytes_ = 0;
+    mapped_entries_ = 0;
+    load_time_ns_ = 0;
+}
+
+const SignalArena::Entry *SignalArena::find(const std::string &path) const
+{
+    auto it = index_.find(path);
+    if (it == index_.end())
+    {
+        return nullptr;
+    }
+    return &entries_[it->second];
+}
+
+const int16_t *SignalArena::data(const Entry &entry) const
+{
+    if (entry.mapped != nullptr)
+    {
+        return entry.mapped;
+    }
+    return reinterpret_cast<const int16_t *>(buffer_.get() + entry.offset);
+}
@@ -0,0 +1,75 @@
+#ifndef SIGNAL_ARENA_HPP
+#define SIGNAL_ARENA_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstdlib>
+#include <hdf5.h>
+#include "mapped_source.hpp"
+#include "dataset_inventory.hpp"
+
+// 源数据内存区：一次性解码输入文件中的全部 Signal 数据集，存放在一块 64 字节对齐的连续内存中，
+// 之后所有压缩配置都直接从这里取数据，源文件的 VBZ 解码只付出一次。
+// 连续存储、未压缩的数据集不复制，直接指向映射的源文件（只保证 2 字节对齐）
+class SignalArena
+{
+public:
+    static constexpr size_t kAlignment = 64;
+
+    struct Entry
+    {
+        std::string path;
+        size_t offset = 0; // 在内存区中的字节偏移（kAlignment 对齐），mapped 非空时不使用
+        size_t length = 0; // 元素个数（int16）
+        int rank = 0;
+        hsize_t dims[3] = {0, 0, 0};
+        std::vector<unsigned char> type_image; // 源数据集文件类型（H5Tencode），用于创建目标数据集
+        const int16_t *mapped = nullptr;        // 非空时数据位于映射的源文件中（零拷贝）
+    };
+
+    SignalArena() = default;
+    ~SignalArena() = default;
+
+    SignalArena(const SignalArena &) = delete;
+    SignalArena &operator=(const SignalArena &) = delete;
+
+    // 遍历输入文件并解码全部 Signal 数据集，失败时返回 false 且内存区为空
+    // decode_threads 大于 0 时由分块并行解码引擎解码，进程内不支持的数据集回退到 H5Dread；
+    // map_source 为 true 时连续、未压缩的数据集直接映射，不复制；inventory 为该文件的对象清单，为空时遍历文件
+    bool load(const std::string &input_file, int decode_threads = 0, bool map_source = true,
+              const DatasetInventory *inventory = nullptr);
+    void clear();
+
+    bool empty() const { return entries_.empty(); }
+    const std::vector<Entry> &entries() const { return entries_; }
+    const Entry *find(const std::string &path) const;
+    const int16_t *data(const Entry &entry) const;
+
+    const std::string &sourceFile() const { return source_file_; }
+    // 解码到内存区的字节数与零拷贝映射的字节数
+    size_t totalBytes() const { return total_bytes_; }
+    size_t mappedBytes() const { return mapped_bytes_; }
+    size_t mappedEntries() const { return mapped_entries_; }
+    long long loadTimeNs() const { return load_time_ns_; }
+
+private:
+    struct FreeDeleter
+    {
+        void operator()(void *p) const { std::free(p); }
+    };
+
+    std::unique_ptr<unsigned char, FreeDeleter> buffer_;
+    MappedSource mapped_;
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, size_t> index_;
+    std::string source_file_;
+    size_t total_bytes_ = 0;
+    size_t mapped_bytes_ = 0;
+    size_t mapped_entries_ = 0;
+    long long load_time_ns_ = 0;
+};
+
+#endif // SIGNAL_ARENA_HPP
@@ -0,0 +1,264 @@
+#include "signal_pipeline.hpp"
+#include "bounded_queue.hpp"
+#include "chunk_write_engine.hpp"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <cstdlib>
+
+using namespace std::chrono;
+
+namespace
+{
+    // 流水线中流动的一个分块（或回退时的整个数据集）
+    struct Item
+    {
+        size_t dataset = 0;
+        // 为空表示该数据集没有进程内编码器，写入线程用 H5Dwrite 整体写入（由库编码）
+        std::shared_ptr<const ChunkWriteEngine::ChunkLayout> layout;
+        std::shared_ptr<const unsigned char> source; // 整个数据集的原生数据，最后一个引用释放时归还在途内存额度
+        hsize_t offset[3] = {0, 0, 0};
+        std::vector<unsigned char> encoded;
+        bool ok = true;
+    };
+
+    // 队列满/空时先自旋让出，再短暂休眠，返回等待的纳秒数
+    template <typename Predicate>
+    long long waitUntil(Predicate ready)
+    {
+        auto start = steady_clock::now();
+        int spins = 0;
+        while (!ready())
+        {
+            if (++spins < 64)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                std::this_thread::sleep_for(microseconds(50));
+            }
+        }
+        return duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    }
+
+    long long elapsedNs(steady_clock::time_point start)
+    {
+        return duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    }
+} // namespace
+
+SignalPipeline::SignalPipeline(const Options &options) : options_(options)
+{
+    options_.encoder_threads = std::max(1, options_.encoder_threads);
+    options_.read_queue_depth = std::max<size_t>(1, options_.read_queue_depth);
+    options_.write_queue_depth = std::max<size_t>(1, options_.write_queue_depth);
+}
+
+void SignalPipeline::markFailed(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(failed_mutex_);
+    if (std::find(failed_paths_.begin(), failed_paths_.end(), path) == failed_paths_.end())
+    {
+        failed_paths_.push_back(path);
+    }
+}
+
+bool SignalPipeline::run(hid_t src_file_id, const std::vector<Dataset> &datasets, PipelineStats &stats)
+{
+    failed_paths_.clear();
+    direct_chunks_ = 0;
+
+    BoundedQueue<Item *> encode_queue(options_.read_queue_depth);
+    BoundedQueue<Item *> write_queue(options_.write_queue_depth);
+    std::atomic<bool> reader_done(false);
+    std::atomic<int> encoders_running(options_.encoder_threads);
+    std::atomic<size_t> inflight_bytes(0);
+    std::atomic<size_t> peak_inflight(0);
+    std::atomic<long long> encoder_busy(0);
+    std::atomic<size_t> chunks(0);
+    long long reader_busy = 0;
+    long long reader_blocked = 0;
+    long long writer_busy = 0;
+    size_t direct_chunks = 0;
+
+    auto add_inflight = [&](size_t bytes)
+    {
+        size_t now = inflight_bytes.fetch_add(bytes) + bytes;
+        size_t peak = peak_inflight.load();
+        while (now > peak && !peak_inflight.compare_exchange_weak(peak, now))
+        {
+        }
+    };
+
+    auto start = steady_clock::now();
+
+    // 读取阶段：取得源数据（内存区或 H5Dread），查询目标数据集的分块布局，按分块拆成任务
+    std::thread reader([&]
+                       {
+        for (size_t index = 0; index < datasets.size(); ++index)
+        {
+            const Dataset &dataset = datasets[index];
+            size_t bytes = dataset.elements * sizeof(int16_t);
+
+            // 在途内存超限时等待写入线程归还额度；单个数据集超过上限时仍允许它单独通过
+            if (dataset.arena_data == nullptr)
+            {
+                reader_blocked += waitUntil([&]
+                                            { return inflight_bytes.load() == 0 ||
+                                                     inflight_bytes.load() + bytes <= options_.max_inflight_bytes; });
+            }
+
+            auto busy_start = steady_clock::now();
+            std::shared_ptr<const unsigned char> source;
+            auto layout = std::make_shared<ChunkWriteEngine::ChunkLayout>();
+            bool direct = false;
+            bool read_ok = true;
+            {
+                std::lock_guard<std::mutex> lock(hdf5_mutex_);
+                direct = ChunkWriteEngine::describe(dataset.dst_dset_id, *layout);
+                if (dataset.arena_data != nullptr)
+                {
+                    // 内存区由调用者持有，这里只借用，不计入在途额度
+                    source = std::shared_ptr<const unsigned char>(
+                        reinterpret_cast<const unsigned char *>(dataset.arena_data), [](const unsigned char *) {});
+                }
+                else
+                {
+                    unsigned char *buffer = static_cast<unsigned char *>(std::malloc(std::max<size_t>(bytes, 1)));
+                    add_inflight(bytes);
+                    source = std::shared_ptr<const unsigned char>(buffer, [&inflight_bytes, bytes](const unsigned char *p)
+                                                                  {
+                        std::free(const_cast<unsigned char *>(p));
+                        inflight_bytes.fetch_sub(bytes); });
+                    hid_t src_dset_id = H5Dopen(src_file_id, dataset.path.c_str(), H5P_DEFAULT);
+                    read_ok = src_dset_id >= 0 &&
+                              H5Dread(src_dset_id, H5T_NATIVE_INT16, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer) >= 0;
+                    if (src_dset_id >= 0)
+                    {
+                        H5Dclose(src_dset_id);
+                    }
+                }
+            }
+            reader_busy += elapsedNs(busy_start);
+
+            if (!read_ok)
+            {
+                std::cerr << "Failed to read source dataset in pipeline: " << dataset.path << std::endl;
+                markFailed(dataset.path);
+                continue;
+            }
+
+            size_t item_count = direct ? layout->chunkCount() : 1;
+            for (size_t chunk = 0; chunk < item_count; ++chunk)
+            {
+                Item *item = new Item();
+                item->dataset = index;
+                item->source = source;
+                if (direct)
+                {
+                    item->layout = layout;
+                    layout->chunkOffset(chunk, item->offset);
+                }
+                reader_blocked += waitUntil([&]
+                                            { return encode_queue.tryPush(item); });
+            }
+        }
+        reader_done.store(true, std::memory_order_release); });
+
+    // 编码阶段：不调用 HDF5，只做进程内编码
+    std::vector<std::thread> encoders;
+    for (int t = 0; t < options_.encoder_threads; ++t)
+    {
+        encoders.emplace_back([&]
+                              {
+            while (true)
+            {
+                Item *item = nullptr;
+                waitUntil([&]
+                          { return encode_queue.tryPop(item) || reader_done.load(std::memory_order_acquire); });
+                // 读取线程结束后再确认一次队列为空，才能退出
+                if (item == nullptr && !encode_queue.tryPop(item))
+                {
+                    break;
+                }
+
+                if (item->layout)
+                {
+                    auto busy_start = steady_clock::now();
+                    item->ok = ChunkWriteEngine::encodeChunk(*item->layout, item->source.get(), item->offset, item->encoded);
+                    encoder_busy.fetch_add(elapsedNs(busy_start));
+                    add_inflight(item->encoded.size());
+                }
+                waitUntil([&]
+                          { return write_queue.tryPush(item); });
+            }
+            encoders_running.fetch_sub(1, std::memory_order_release); });
+    }
+
+    // 写入阶段：单线程提交 HDF5 写操作
+    std::thread writer([&]
+                       {
+        while (true)
+        {
+            Item *item = nullptr;
+            waitUntil([&]
+                      { return write_queue.tryPop(item) || encoders_running.load(std::memory_order_acquire) == 0; });
+            // 编码线程全部结束后再确认一次队列为空，才能退出
+            if (item == nullptr && !write_queue.tryPop(item))
+            {
+                break;
+            }
+
+            const Dataset &dataset = datasets[item->dataset];
+            auto busy_start = steady_clock::now();
+            bool ok = item->ok;
+            if (ok)
+            {
+                std::lock_guard<std::mutex> lock(hdf5_mutex_);
+                if (item->layout)
+                {
+                    // filter_mask 为 0：管线中的过滤器全部已应用
+                    ok = H5Dwrite_chunk(dataset.dst_dset_id, H5P_DEFAULT, 0, item->offset,
+                                        item->encoded.size(), item->encoded.data()) >= 0;
+                    direct_chunks++;
+                }
+                else
+                {
+                    ok = H5Dwrite(dataset.dst_dset_id, H5T_NATIVE_INT16, H5S_ALL, H5S_ALL,
+                                  H5P_DEFAULT, item->source.get()) >= 0 &&
+                         H5Dflush(dataset.dst_dset_id) >= 0;
+                }
+            }
+            writer_busy += elapsedNs(busy_start);
+            chunks.fetch_add(1);
+
+            if (!ok)
+            {
+                std::cerr << "Failed to write chunk in pipeline: " << dataset.path << std::endl;
+                markFailed(dataset.path);
+            }
+            inflight_bytes.fetch_sub(item->encoded.size());
+            delete item;
+        } });
+
+    reader.join();
+    for (auto &encoder : encoders)
+    {
+        encoder.join();
+    }
+    writer.join();
+
+    stats.wall_ns = elapsedNs(start);
+    stats.reader_busy_ns = reader_busy;
+    stats.encoder_busy_ns = encoder_busy.load();
+    stats.writer_busy_ns = writer_busy;
+    stats.reader_blocked_ns = reader_blocked;
+    stats.encoder_threads = options_.encoder_threads;
+    stats.chunks = chunks.load();
+    stats.peak_inflight_bytes = peak_inflight.load();
+    direct_chunks_ = direct_chunks;
+    return failed_paths_.empty();
+}
@@ -0,0 +1,53 @@
+#ifndef SIGNAL_PIPELINE_HPP
+#define SIGNAL_PIPELINE_HPP
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <hdf5.h>
+#include "hdf5_processor.hpp"
+
+// 三阶段 Signal 写出流水线：读取线程 → 编码线程池 → 单个 HDF5 写入线程，阶段之间用有界无锁队列连接。
+// HDF5 不是线程安全的，读取和写入线程的 HDF5 调用通过同一个互斥锁串行化；编码阶段不调用 HDF5。
+// 运行期间调用者线程不得调用 HDF5。
+class SignalPipeline
+{
+public:
+    struct Options
+    {
+        int encoder_threads = 1;
+        size_t read_queue_depth = 8;                      // 读取 → 编码 队列容量（分块数）
+        size_t write_queue_depth = 8;                     // 编码 → 写入 队列容量（分块数）
+        size_t max_inflight_bytes = 256 * 1024 * 1024;    // 已读出但尚未写入的源数据与编码结果的上限
+    };
+
+    // 一个待写出的目标数据集；arena_data 非空时直接使用内存区中的数据，否则从源文件读取
+    struct Dataset
+    {
+        std::string path;
+        hid_t dst_dset_id = -1;
+        const int16_t *arena_data = nullptr;
+        size_t elements = 0;
+    };
+
+    explicit SignalPipeline(const Options &options);
+
+    // 运行流水线直到全部数据集写出；全部成功时返回 true
+    bool run(hid_t src_file_id, const std::vector<Dataset> &datasets, PipelineStats &stats);
+
+    const std::vector<std::string> &failedPaths() const { return failed_paths_; }
+    size_t directChunks() const { return direct_chunks_; }
+
+private:
+    void markFailed(const std::string &path);
+
+    Options options_;
+    std::mutex hdf5_mutex_;   // 串行化读取与写入线程的 HDF5 调用
+    std::mutex failed_mutex_;
+    std::vector<std::string> failed_paths_;
+    size_t direct_chunks_ = 0;
+};
+
+#endif // SIGNAL_PIPELINE_HPP
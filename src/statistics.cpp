@@ -0,0 +1,104 @@
+#include "statistics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace Statistics
+{
+
+    // 对已排序的样本做线性插值分位数
+    static double sortedQuantile(const std::vector<double> &sorted, double q)
+    {
+        if (sorted.empty())
+        {
+            return 0.0;
+        }
+        if (sorted.size() == 1)
+        {
+            return sorted[0];
+        }
+        q = std::min(1.0, std::max(0.0, q));
+        double pos = q * (sorted.size() - 1);
+        size_t lower = static_cast<size_t>(std::floor(pos));
+        size_t upper = std::min(lower + 1, sorted.size() - 1);
+        double fraction = pos - lower;
+        return sorted[lower] + (sorted[upper] - sorted[lower]) * fraction;
+    }
+
+    double quantile(std::vector<double> samples, double q)
+    {
+        std::sort(samples.begin(), samples.end());
+        return sortedQuantile(samples, q);
+    }
+
+    TimingStats summarize(const std::vector<double> &samples,
+                          size_t bootstrap_rounds,
+                          double confidence)
+    {
+        TimingStats stats;
+        stats.samples = samples.size();
+        if (samples.empty())
+        {
+            return stats;
+        }
+
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        stats.min = sorted.front();
+        stats.median = sortedQuantile(sorted, 0.5);
+        stats.p95 = sortedQuantile(sorted, 0.95);
+        stats.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+
+        if (sorted.size() > 1)
+        {
+            double sum_sq = 0.0;
+            for (double v : sorted)
+            {
+                sum_sq += (v - stats.mean) * (v - stats.mean);
+            }
+            stats.stddev = std::sqrt(sum_sq / (sorted.size() - 1));
+        }
+
+        // 只有一个样本时置信区间退化为一个点
+        if (sorted.size() < 2 || bootstrap_rounds == 0)
+        {
+            stats.ci_low = stats.median;
+            stats.ci_high = stats.median;
+            return stats;
+        }
+
+        // 百分位 bootstrap：有放回重采样，计算每次重采样的中位数
+        std::mt19937_64 rng(0x5eed5eedULL);
+        std::uniform_int_distribution<size_t> pick(0, sorted.size() - 1);
+        std::vector<double> resample(sorted.size());
+        std::vector<double> medians;
+        medians.reserve(bootstrap_rounds);
+        for (size_t round = 0; round < bootstrap_rounds; ++round)
+        {
+            for (auto &v : resample)
+            {
+                v = sorted[pick(rng)];
+            }
+            std::sort(resample.begin(), resample.end());
+            medians.push_back(sortedQuantile(resample, 0.5));
+        }
+        std::sort(medians.begin(), medians.end());
+        double alpha = (1.0 - confidence) / 2.0;
+        stats.ci_low = sortedQuantile(medians, alpha);
+        stats.ci_high = sortedQuantile(medians, 1.0 - alpha);
+
+        return stats;
+    }
+
+    bool intervalsOverlap(const TimingStats &a, const TimingStats &b)
+    {
+        if (a.samples == 0 || b.samples == 0)
+        {
+            return false;
+        }
+        return a.ci_low <= b.ci_high && b.ci_low <= a.ci_high;
+    }
+
+} // namespace Statistics
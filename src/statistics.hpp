@@ -0,0 +1,36 @@
+#ifndef STATISTICS_HPP
+#define STATISTICS_HPP
+
+#include <cstddef>
+#include <vector>
+
+// 重复测量的统计摘要（单位与输入样本一致，本项目中为毫秒）
+struct TimingStats
+{
+    size_t samples = 0;
+    double min = 0.0;
+    double median = 0.0;
+    double mean = 0.0;
+    double p95 = 0.0;
+    double stddev = 0.0; // 样本标准差（n-1）
+    // 中位数的 bootstrap 置信区间
+    double ci_low = 0.0;
+    double ci_high = 0.0;
+};
+
+namespace Statistics
+{
+    // 计算样本的统计摘要；bootstrap 使用固定种子，保证同一组样本的结果可复现
+    TimingStats summarize(const std::vector<double> &samples,
+                          size_t bootstrap_rounds = 2000,
+                          double confidence = 0.95);
+
+    // 线性插值分位数，q 取值 [0, 1]
+    double quantile(std::vector<double> samples, double q);
+
+    // 两个置信区间是否重叠（重叠即认为统计上无法区分）
+    bool intervalsOverlap(const TimingStats &a, const TimingStats &b);
+
+} // namespace Statistics
+
+#endif // STATISTICS_HPP
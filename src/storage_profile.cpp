@@ -0,0 +1,64 @@
+#include "storage_profile.hpp"
+#include "utils.hpp"
+#include <cstdlib>
+
+long long StorageProfile::deviceNs(long long bytes, long long seeks, bool write) const
+{
+    double mbps = write ? write_mbps : read_mbps;
+    double transfer_ns = mbps > 0.0 ? bytes / (mbps * 1024.0 * 1024.0) * 1.0e9 : 0.0;
+    return static_cast<long long>(seeks * latency_us * 1.0e3 + transfer_ns);
+}
+
+const std::vector<StorageProfile> &StorageProfile::presets()
+{
+    // 典型的顺序带宽与单次访问延迟：PCIe 3.0 NVMe、SATA SSD、7200 转机械硬盘、千兆以太网上的 NFS
+    static const std::vector<StorageProfile> profiles = {
+        {"nvme", 3000.0, 2000.0, 20.0},
+        {"sata_ssd", 550.0, 500.0, 100.0},
+        {"hdd", 180.0, 160.0, 8000.0},
+        {"nfs", 110.0, 100.0, 1000.0},
+    };
+    return profiles;
+}
+
+bool StorageProfile::parse(const std::string &text, StorageProfile &profile, std::string &error)
+{
+    std::string name = Utils::trim(text);
+    for (const auto &preset : presets())
+    {
+        if (preset.name == name)
+        {
+            profile = preset;
+            return true;
+        }
+    }
+
+    std::vector<std::string> parts = Utils::split(name, ':');
+    if (parts.size() != 3)
+    {
+        error = "unknown storage tier '" + name +
+                "' (expected nvme, sata_ssd, hdd, nfs or READ_MBPS:WRITE_MBPS:LATENCY_US)";
+        return false;
+    }
+    char *end = nullptr;
+    double values[3];
+    for (size_t i = 0; i < 3; ++i)
+    {
+        values[i] = std::strtod(parts[i].c_str(), &end);
+        if (end == parts[i].c_str() || *end != '\0' || values[i] < 0.0)
+        {
+            error = "invalid number '" + parts[i] + "' in storage tier '" + name + "'";
+            return false;
+        }
+    }
+    if (values[0] <= 0.0 || values[1] <= 0.0)
+    {
+        error = "storage tier bandwidth must be positive: '" + name + "'";
+        return false;
+    }
+    profile.name = "custom";
+    profile.read_mbps = values[0];
+    profile.write_mbps = values[1];
+    profile.latency_us = values[2];
+    return true;
+}
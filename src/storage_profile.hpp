@@ -0,0 +1,26 @@
+#ifndef STORAGE_PROFILE_HPP
+#define STORAGE_PROFILE_HPP
+
+#include <string>
+#include <vector>
+
+// 存储设备的简化模型：每次非顺序访问付出一次延迟（寻道/往返），数据按带宽传输
+struct StorageProfile
+{
+    std::string name;
+    double read_mbps = 0.0;
+    double write_mbps = 0.0;
+    double latency_us = 0.0;
+
+    bool enabled() const { return !name.empty(); }
+
+    // 一组访问在该设备上的耗时（纳秒）：seeks 次延迟 + bytes / 带宽
+    long long deviceNs(long long bytes, long long seeks, bool write) const;
+
+    // 预设：nvme、sata_ssd、hdd、nfs
+    static const std::vector<StorageProfile> &presets();
+    // 预设名，或 "读MB/s:写MB/s:延迟us" 形式的自定义设备
+    static bool parse(const std::string &text, StorageProfile &profile, std::string &error);
+};
+
+#endif // STORAGE_PROFILE_HPP
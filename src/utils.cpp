@@ -8,6 +8,7 @@
 #include <cctype>
 #include <filesystem>
 #include <thread>
+#include <cstdlib>
 #include <cstring>
 
 #ifdef _WIN32
@@ -319,6 +320,54 @@ size_t Utils::getAvailableMemory()
 #endif
 }
 
+#ifndef _WIN32
+// 读取 /proc/self/status 中的一项（单位 kB），返回字节数
+static size_t readProcStatusKb(const char *key)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    size_t key_length = std::strlen(key);
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, key_length, key) == 0 && line.size() > key_length && line[key_length] == ':')
+        {
+            return static_cast<size_t>(std::strtoull(line.c_str() + key_length + 1, nullptr, 10)) * 1024;
+        }
+    }
+    return 0;
+}
+#endif
+
+size_t Utils::getResidentMemory()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    return readProcStatusKb("VmRSS");
+#endif
+}
+
+size_t Utils::getPeakResidentMemory()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    return readProcStatusKb("VmHWM");
+#endif
+}
+
+bool Utils::resetPeakResidentMemory()
+{
+#ifdef _WIN32
+    return false;
+#else
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+    clear_refs.close();
+    return !clear_refs.fail();
+#endif
+}
+
 bool Utils::isHDF5File(const std::string &path)
 {
     // 简单的HDF5文件检查：检查文件扩展名
@@ -37,6 +37,11 @@ public:
     static std::string getSystemInfo();
     static std::string getCPUInfo();
     static size_t getAvailableMemory();
+    // 当前进程的常驻内存与峰值常驻内存（字节），不支持时返回 0
+    static size_t getResidentMemory();
+    static size_t getPeakResidentMemory();
+    // 把峰值常驻内存重置为当前值（Linux clear_refs），不支持时返回 false
+    static bool resetPeakResidentMemory();
 
     // HDF5相关
     static bool isHDF5File(const std::string &path);
@@ -0,0 +1,828 @@
+#include "vbz_filter.hpp"
+#include "filter_definitions.hpp"
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define VBZ_X86 1
+#include <immintrin.h>
+#endif
+#if defined(__aarch64__)
+#define VBZ_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    // 默认每批处理的元素数：批内的 zigzag 中间结果（32 KB）留在缓存中，不为整个分块分配中间缓冲区
+    const size_t kDefaultBlockElements = 16384;
+
+    // StreamVByte 查找表：每个控制字节对应的数据字节数，以及 SIMD 编码/解码的字节重排掩码
+    struct StreamVByteTables
+    {
+        uint8_t length[256];
+        uint8_t encode[256][16]; // 4 个 32 位值 → 紧凑排列的字节
+        uint8_t decode[256][16]; // 紧凑排列的字节 → 4 个 16 位值（只用于不含 3/4 字节码的批）
+    };
+
+    // 码值对应的字节数：版本 0 为 1/2/3/4，版本 1 为 0/1/2/4
+    inline size_t codeLength(unsigned int version, unsigned int code)
+    {
+        return version == 0 ? code + 1 : (code == 3 ? 4 : code);
+    }
+
+    // 16 位值的码值。差值按 int16 回绕计算，zigzag 值不超过 16 位，编码器不会写出 3/4 字节码
+    inline unsigned int valueCode(unsigned int version, uint16_t value)
+    {
+        if (version == 0)
+        {
+            return value < (1U << 8) ? 0 : 1;
+        }
+        return value == 0 ? 0 : value < (1U << 8) ? 1 : 2;
+    }
+
+    StreamVByteTables buildTables(unsigned int version)
+    {
+        StreamVByteTables tables;
+        for (unsigned int control = 0; control < 256; ++control)
+        {
+            std::memset(tables.encode[control], 0x80, 16);
+            std::memset(tables.decode[control], 0x80, 16);
+            size_t position = 0;
+            for (unsigned int lane = 0; lane < 4; ++lane)
+            {
+                size_t length = codeLength(version, (control >> (lane * 2)) & 0x3);
+                for (size_t b = 0; b < length; ++b)
+                {
+                    tables.encode[control][position + b] = static_cast<uint8_t>(lane * 4 + b);
+                    if (b < 2)
+                    {
+                        tables.decode[control][lane * 2 + b] = static_cast<uint8_t>(position + b);
+                    }
+                }
+                position += length;
+            }
+            tables.length[control] = static_cast<uint8_t>(position);
+        }
+        return tables;
+    }
+
+    const StreamVByteTables &streamVByteTables(unsigned int version)
+    {
+        static const StreamVByteTables version0 = buildTables(0);
+        static const StreamVByteTables version1 = buildTables(1);
+        return version == 0 ? version0 : version1;
+    }
+
+    inline uint16_t zigzag(int16_t delta)
+    {
+        return static_cast<uint16_t>((static_cast<uint16_t>(delta) << 1) ^ static_cast<uint16_t>(delta >> 15));
+    }
+
+    inline int16_t unzigzag(uint16_t value)
+    {
+        return static_cast<int16_t>((value >> 1) ^ (0 - (value & 1)));
+    }
+
+    // 一组实现：批内的 delta+zigzag、StreamVByte 编码/解码、反 zigzag+前缀和
+    struct Kernels
+    {
+        // out[i] = zigzag(in[i] - in[i-1])，previous 为 in[-1]
+        void (*delta_zigzag)(const int16_t *in, size_t count, int16_t previous, uint16_t *out);
+        // control 指向本批第一个控制字节（需预先清零），返回写入后的数据指针；数据区需留 16 字节余量
+        uint8_t *(*encode)(const uint16_t *in, size_t count, unsigned int version, uint8_t *control, uint8_t *data);
+        // 返回读取后的数据指针，数据不足时返回 nullptr
+        const uint8_t *(*decode)(const uint8_t *control, const uint8_t *data, const uint8_t *end,
+                                 size_t count, unsigned int version, uint16_t *out);
+        // out[i] = out[i-1] + unzigzag(in[i])，返回最后一个值
+        int16_t (*prefix)(const uint16_t *in, size_t count, int16_t previous, int16_t *out);
+    };
+
+    // ------------------------------------------------------------------
+    // 标量实现（所有平台）
+    // ------------------------------------------------------------------
+
+    void deltaZigzagScalar(const int16_t *in, size_t count, int16_t previous, uint16_t *out)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = zigzag(static_cast<int16_t>(in[i] - previous));
+            previous = in[i];
+        }
+    }
+
+    uint8_t *encodeScalar(const uint16_t *in, size_t count, unsigned int version, uint8_t *control, uint8_t *data)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            unsigned int code = valueCode(version, in[i]);
+            control[i / 4] |= static_cast<uint8_t>(code << ((i % 4) * 2));
+            size_t length = codeLength(version, code);
+            for (size_t b = 0; b < length; ++b)
+            {
+                *data++ = static_cast<uint8_t>(in[i] >> (8 * b));
+            }
+        }
+        return data;
+    }
+
+    const uint8_t *decodeScalar(const uint8_t *control, const uint8_t *data, const uint8_t *end,
+                                size_t count, unsigned int version, uint16_t *out)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            unsigned int code = (control[i / 4] >> ((i % 4) * 2)) & 0x3;
+            size_t length = codeLength(version, code);
+            if (static_cast<size_t>(end - data) < length)
+            {
+                return nullptr;
+            }
+            uint32_t value = 0;
+            for (size_t b = 0; b < length; ++b)
+            {
+                value |= static_cast<uint32_t>(data[b]) << (8 * b);
+            }
+            data += length;
+            // 含 3/4 字节码的批由 decodeWide 处理，这里出现超过 16 位的值说明控制字节与数据不一致
+            if (value > 0xFFFF)
+            {
+                return nullptr;
+            }
+            out[i] = static_cast<uint16_t>(value);
+        }
+        return data;
+    }
+
+    int16_t prefixScalar(const uint16_t *in, size_t count, int16_t previous, int16_t *out)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            previous = static_cast<int16_t>(previous + unzigzag(in[i]));
+            out[i] = previous;
+        }
+        return previous;
+    }
+
+    const Kernels kScalarKernels = {deltaZigzagScalar, encodeScalar, decodeScalar, prefixScalar};
+
+    // 控制字节中是否有长于 2 字节的码（版本 0 的码 2、3，版本 1 的码 3），每次检查 8 个控制字节
+    bool hasWideCodes(const uint8_t *control, size_t bytes, unsigned int version)
+    {
+        uint64_t wide = 0;
+        size_t i = 0;
+        for (; i + 8 <= bytes; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, control + i, sizeof(word));
+            wide |= version == 0 ? word & 0xAAAAAAAAAAAAAAAAULL : word & (word >> 1) & 0x5555555555555555ULL;
+        }
+        for (; i < bytes; ++i)
+        {
+            uint8_t byte = control[i];
+            wide |= version == 0 ? byte & 0xAA : byte & (byte >> 1) & 0x55;
+        }
+        return wide != 0;
+    }
+
+    // 含 3/4 字节码的批：按 32 位取值并反 zigzag，差值取低 16 位累加。
+    // 插件若按 32 位计算 int16 的差值，跨度超过 32767 的差值会写成 3/4 字节码，zigzag 值最多 17 位；
+    // 按 16 位回绕写出的数据也得到相同结果。超过 17 位的值不可能来自 int16 数据，按数据损坏处理
+    const uint8_t *decodeWide(const uint8_t *control, const uint8_t *data, const uint8_t *end, size_t count,
+                              unsigned int version, int16_t &previous, int16_t *out)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            unsigned int code = (control[i / 4] >> ((i % 4) * 2)) & 0x3;
+            size_t length = codeLength(version, code);
+            if (static_cast<size_t>(end - data) < length)
+            {
+                return nullptr;
+            }
+            uint32_t value = 0;
+            for (size_t b = 0; b < length; ++b)
+            {
+                value |= static_cast<uint32_t>(data[b]) << (8 * b);
+            }
+            data += length;
+            if (value > 0x1FFFF)
+            {
+                return nullptr;
+            }
+            uint32_t delta = (value >> 1) ^ (0U - (value & 1));
+            previous = static_cast<int16_t>(static_cast<uint16_t>(previous) + static_cast<uint16_t>(delta));
+            out[i] = previous;
+        }
+        return data;
+    }
+
+#ifdef VBZ_X86
+    // ------------------------------------------------------------------
+    // SSE4.1：每次 8 个 int16 做 delta/zigzag，StreamVByte 每次 4 个值用 pshufb 重排
+    // ------------------------------------------------------------------
+
+    __attribute__((target("sse4.1"))) void deltaZigzagSse41(const int16_t *in, size_t count, int16_t previous,
+                                                             uint16_t *out)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        out[0] = zigzag(static_cast<int16_t>(in[0] - previous));
+        size_t i = 1;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            __m128i before = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i - 1));
+            __m128i delta = _mm_sub_epi16(current, before);
+            __m128i encoded = _mm_xor_si128(_mm_slli_epi16(delta, 1), _mm_srai_epi16(delta, 15));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), encoded);
+        }
+        deltaZigzagScalar(in + i, count - i, in[i - 1], out + i);
+    }
+
+    __attribute__((target("sse4.1"))) uint8_t *encodeSse41(const uint16_t *in, size_t count, unsigned int version,
+                                                           uint8_t *control, uint8_t *data)
+    {
+        const StreamVByteTables &tables = streamVByteTables(version);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i byte_max = _mm_set1_epi32(0xFF);
+        size_t quads = count / 4;
+        for (size_t q = 0; q < quads; ++q)
+        {
+            __m128i values = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(in + q * 4)));
+            // 每个 32 位通道的码值：大于 255 记 1，版本 1 中非 0 再加 1
+            __m128i codes = _mm_sub_epi32(zero, _mm_cmpgt_epi32(values, byte_max));
+            if (version != 0)
+            {
+                codes = _mm_sub_epi32(codes, _mm_cmpgt_epi32(values, zero));
+            }
+            uint32_t lanes = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(codes, codes), zero)));
+            unsigned int code = (lanes & 0x3) | ((lanes >> 6) & 0xC) | ((lanes >> 12) & 0x30) | ((lanes >> 18) & 0xC0);
+            control[q] = static_cast<uint8_t>(code);
+            __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tables.encode[code]));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(data), _mm_shuffle_epi8(values, mask));
+            data += tables.length[code];
+        }
+        return encodeScalar(in + quads * 4, count - quads * 4, version, control + quads, data);
+    }
+
+    __attribute__((target("sse4.1"))) const uint8_t *decodeSse41(const uint8_t *control, const uint8_t *data,
+                                                                 const uint8_t *end, size_t count,
+                                                                 unsigned int version, uint16_t *out)
+    {
+        const StreamVByteTables &tables = streamVByteTables(version);
+        size_t quads = count / 4;
+        size_t q = 0;
+        // 每次读取 16 字节，剩余不足 16 字节时改用标量实现，避免越界读取
+        for (; q < quads && end - data >= 16; ++q)
+        {
+            unsigned int code = control[q];
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+            __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tables.decode[code]));
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(out + q * 4), _mm_shuffle_epi8(bytes, mask));
+            data += tables.length[code];
+        }
+        return decodeScalar(control + q, data, end, count - q * 4, version, out + q * 4);
+    }
+
+    // 8 个 int16 的通道内前缀和：移位相加三次
+    __attribute__((target("sse4.1"))) inline __m128i prefixSum8(__m128i values)
+    {
+        values = _mm_add_epi16(values, _mm_slli_si128(values, 2));
+        values = _mm_add_epi16(values, _mm_slli_si128(values, 4));
+        return _mm_add_epi16(values, _mm_slli_si128(values, 8));
+    }
+
+    __attribute__((target("sse4.1"))) inline __m128i unzigzag8(__m128i values)
+    {
+        __m128i sign = _mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(values, _mm_set1_epi16(1)));
+        return _mm_xor_si128(_mm_srli_epi16(values, 1), sign);
+    }
+
+    __attribute__((target("sse4.1"))) int16_t prefixSse41(const uint16_t *in, size_t count, int16_t previous,
+                                                          int16_t *out)
+    {
+        size_t i = 0;
+        __m128i carry = _mm_set1_epi16(previous);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i values = unzigzag8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)));
+            values = _mm_add_epi16(prefixSum8(values), carry);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), values);
+            previous = static_cast<int16_t>(_mm_extract_epi16(values, 7));
+            carry = _mm_set1_epi16(previous);
+        }
+        return prefixScalar(in + i, count - i, previous, out + i);
+    }
+
+    const Kernels kSse41Kernels = {deltaZigzagSse41, encodeSse41, decodeSse41, prefixSse41};
+
+    // ------------------------------------------------------------------
+    // AVX2：delta/zigzag 与前缀和每次 16 个 int16；pshufb 只在 128 位通道内重排，
+    // StreamVByte 沿用 SSE4.1 实现
+    // ------------------------------------------------------------------
+
+    __attribute__((target("avx2"))) void deltaZigzagAvx2(const int16_t *in, size_t count, int16_t previous,
+                                                         uint16_t *out)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        out[0] = zigzag(static_cast<int16_t>(in[0] - previous));
+        size_t i = 1;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+            __m256i before = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i - 1));
+            __m256i delta = _mm256_sub_epi16(current, before);
+            __m256i encoded = _mm256_xor_si256(_mm256_slli_epi16(delta, 1), _mm256_srai_epi16(delta, 15));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), encoded);
+        }
+        deltaZigzagScalar(in + i, count - i, in[i - 1], out + i);
+    }
+
+    __attribute__((target("avx2"))) int16_t prefixAvx2(const uint16_t *in, size_t count, int16_t previous,
+                                                       int16_t *out)
+    {
+        size_t i = 0;
+        const __m256i one = _mm256_set1_epi16(1);
+        __m128i carry = _mm_set1_epi16(previous);
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+            __m256i sign = _mm256_sub_epi16(_mm256_setzero_si256(), _mm256_and_si256(values, one));
+            values = _mm256_xor_si256(_mm256_srli_epi16(values, 1), sign);
+            // 两个 128 位通道各自做前缀和，再把低半部分的最后一个值加到高半部分
+            values = _mm256_add_epi16(values, _mm256_slli_si256(values, 2));
+            values = _mm256_add_epi16(values, _mm256_slli_si256(values, 4));
+            values = _mm256_add_epi16(values, _mm256_slli_si256(values, 8));
+            __m128i low = _mm_add_epi16(_mm256_castsi256_si128(values), carry);
+            __m128i high = _mm_add_epi16(_mm256_extracti128_si256(values, 1),
+                                         _mm_set1_epi16(static_cast<int16_t>(_mm_extract_epi16(low, 7))));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), low);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 8), high);
+            previous = static_cast<int16_t>(_mm_extract_epi16(high, 7));
+            carry = _mm_set1_epi16(previous);
+        }
+        return prefixScalar(in + i, count - i, previous, out + i);
+    }
+
+    const Kernels kAvx2Kernels = {deltaZigzagAvx2, encodeSse41, decodeSse41, prefixAvx2};
+#endif // VBZ_X86
+
+#ifdef VBZ_NEON
+    // ------------------------------------------------------------------
+    // NEON（AArch64）：与 SSE4.1 相同的结构，重排使用 vqtbl1q_u8
+    // ------------------------------------------------------------------
+
+    void deltaZigzagNeon(const int16_t *in, size_t count, int16_t previous, uint16_t *out)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        out[0] = zigzag(static_cast<int16_t>(in[0] - previous));
+        size_t i = 1;
+        for (; i + 8 <= count; i += 8)
+        {
+            int16x8_t delta = vsubq_s16(vld1q_s16(in + i), vld1q_s16(in + i - 1));
+            uint16x8_t encoded = veorq_u16(vreinterpretq_u16_s16(vshlq_n_s16(delta, 1)),
+                                           vreinterpretq_u16_s16(vshrq_n_s16(delta, 15)));
+            vst1q_u16(out + i, encoded);
+        }
+        deltaZigzagScalar(in + i, count - i, in[i - 1], out + i);
+    }
+
+    uint8_t *encodeNeon(const uint16_t *in, size_t count, unsigned int version, uint8_t *control, uint8_t *data)
+    {
+        const StreamVByteTables &tables = streamVByteTables(version);
+        size_t quads = count / 4;
+        for (size_t q = 0; q < quads; ++q)
+        {
+            uint32x4_t values = vmovl_u16(vld1_u16(in + q * 4));
+            uint32x4_t codes = vshrq_n_u32(vcgtq_u32(values, vdupq_n_u32(0xFF)), 31);
+            if (version != 0)
+            {
+                codes = vaddq_u32(codes, vshrq_n_u32(vcgtq_u32(values, vdupq_n_u32(0)), 31));
+            }
+            unsigned int code = vgetq_lane_u32(codes, 0) | (vgetq_lane_u32(codes, 1) << 2) |
+                                (vgetq_lane_u32(codes, 2) << 4) | (vgetq_lane_u32(codes, 3) << 6);
+            control[q] = static_cast<uint8_t>(code);
+            vst1q_u8(data, vqtbl1q_u8(vreinterpretq_u8_u32(values), vld1q_u8(tables.encode[code])));
+            data += tables.length[code];
+        }
+        return encodeScalar(in + quads * 4, count - quads * 4, version, control + quads, data);
+    }
+
+    const uint8_t *decodeNeon(const uint8_t *control, const uint8_t *data, const uint8_t *end,
+                              size_t count, unsigned int version, uint16_t *out)
+    {
+        const StreamVByteTables &tables = streamVByteTables(version);
+        size_t quads = count / 4;
+        size_t q = 0;
+        for (; q < quads && end - data >= 16; ++q)
+        {
+            unsigned int code = control[q];
+            uint8x16_t values = vqtbl1q_u8(vld1q_u8(data), vld1q_u8(tables.decode[code]));
+            vst1_u16(out + q * 4, vreinterpret_u16_u8(vget_low_u8(values)));
+            data += tables.length[code];
+        }
+        return decodeScalar(control + q, data, end, count - q * 4, version, out + q * 4);
+    }
+
+    int16_t prefixNeon(const uint16_t *in, size_t count, int16_t previous, int16_t *out)
+    {
+        size_t i = 0;
+        const int16x8_t zero = vdupq_n_s16(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            uint16x8_t encoded = vld1q_u16(in + i);
+            int16x8_t sign = vnegq_s16(vreinterpretq_s16_u16(vandq_u16(encoded, vdupq_n_u16(1))));
+            int16x8_t values = veorq_s16(vreinterpretq_s16_u16(vshrq_n_u16(encoded, 1)), sign);
+            values = vaddq_s16(values, vextq_s16(zero, values, 7));
+            values = vaddq_s16(values, vextq_s16(zero, values, 6));
+            values = vaddq_s16(values, vextq_s16(zero, values, 4));
+            values = vaddq_s16(values, vdupq_n_s16(previous));
+            vst1q_s16(out + i, values);
+            previous = vgetq_lane_s16(values, 7);
+        }
+        return prefixScalar(in + i, count - i, previous, out + i);
+    }
+
+    const Kernels kNeonKernels = {deltaZigzagNeon, encodeNeon, decodeNeon, prefixNeon};
+#endif // VBZ_NEON
+
+    const Kernels &kernelsFor(VbzFilter::Isa isa)
+    {
+        switch (isa)
+        {
+#ifdef VBZ_X86
+        case VbzFilter::Isa::AVX2:
+            return kAvx2Kernels;
+        case VbzFilter::Isa::SSE41:
+            return kSse41Kernels;
+#endif
+#ifdef VBZ_NEON
+        case VbzFilter::Isa::NEON:
+            return kNeonKernels;
+#endif
+        default:
+            return kScalarKernels;
+        }
+    }
+
+    size_t blockElements(const VbzFilter::Options &options)
+    {
+        // 批大小取 16 的倍数，使每批都从控制字节边界开始，且 SIMD 循环没有批内尾部
+        size_t block = options.block_elements > 0 ? options.block_elements : kDefaultBlockElements;
+        return std::max<size_t>(16, (block + 15) / 16 * 16);
+    }
+
+    // 判断 can_apply 时取数据集创建属性中本过滤器的 cd_values
+    bool filterOptions(hid_t dcpl_id, H5Z_filter_t filter_id, VbzFilter::Options &options)
+    {
+        unsigned int flags = 0;
+        size_t cd_nelmts = 8;
+        unsigned int cd_values[8] = {0};
+        unsigned int filter_config = 0;
+        if (H5Pget_filter_by_id2(dcpl_id, filter_id, &flags, &cd_nelmts, cd_values, 0, NULL, &filter_config) < 0)
+        {
+            return false;
+        }
+        options = VbzFilter::fromCdValues(std::min<size_t>(cd_nelmts, 8), cd_values);
+        return true;
+    }
+
+    // 只接受 2 字节整数类型，且本进程能处理该配置（例如未编译 zstd 时 zstd 级别必须为 0）
+    htri_t canApply(hid_t dcpl_id, hid_t type_id, hid_t)
+    {
+        VbzFilter::Options options;
+        bool found = false;
+        H5E_BEGIN_TRY
+        {
+            found = filterOptions(dcpl_id, H5Z_FILTER_VBZ_NATIVE, options) ||
+                    filterOptions(dcpl_id, H5Z_FILTER_VBZ, options);
+        }
+        H5E_END_TRY;
+        if (!found)
+        {
+            return 0;
+        }
+        return H5Tget_class(type_id) == H5T_INTEGER && H5Tget_size(type_id) == options.integer_size &&
+               VbzFilter::supports(options);
+    }
+} // namespace
+
+VbzFilter::Options VbzFilter::fromCdValues(size_t cd_nelmts, const unsigned int cd_values[])
+{
+    Options options;
+    if (cd_nelmts > 0)
+    {
+        options.version = cd_values[0];
+    }
+    if (cd_nelmts > 1)
+    {
+        options.integer_size = cd_values[1];
+    }
+    if (cd_nelmts > 2)
+    {
+        options.delta_zigzag = cd_values[2] != 0;
+    }
+    if (cd_nelmts > 3)
+    {
+        options.zstd_level = static_cast<int>(cd_values[3]);
+    }
+    if (cd_nelmts > 4)
+    {
+        options.window_log = static_cast<int>(cd_values[4]);
+    }
+    if (cd_nelmts > 5)
+    {
+        options.block_elements = cd_values[5];
+    }
+    if (cd_nelmts > 6 && cd_values[6] <= static_cast<unsigned int>(Isa::NEON))
+    {
+        options.isa = static_cast<Isa>(cd_values[6]);
+    }
+    return options;
+}
+
+bool VbzFilter::supports(const Options &options)
+{
+    if (options.version > 1 || options.integer_size != 2 || !options.delta_zigzag)
+    {
+        return false;
+    }
+#ifdef HAVE_ZSTD
+    return true;
+#else
+    return options.zstd_level == 0;
+#endif
+}
+
+VbzFilter::Isa VbzFilter::resolveIsa(Isa requested)
+{
+#ifdef VBZ_X86
+    bool avx2 = __builtin_cpu_supports("avx2");
+    bool sse41 = __builtin_cpu_supports("sse4.1");
+#else
+    bool avx2 = false;
+    bool sse41 = false;
+#endif
+#ifdef VBZ_NEON
+    bool neon = true;
+#else
+    bool neon = false;
+#endif
+    if ((requested == Isa::Scalar) || (requested == Isa::AVX2 && avx2) ||
+        (requested == Isa::SSE41 && sse41) || (requested == Isa::NEON && neon))
+    {
+        return requested;
+    }
+    return avx2 ? Isa::AVX2 : sse41 ? Isa::SSE41 : neon ? Isa::NEON : Isa::Scalar;
+}
+
+const char *VbzFilter::isaName(Isa isa)
+{
+    switch (isa)
+    {
+    case Isa::Auto:
+        return "auto";
+    case Isa::SSE41:
+        return "sse4.1";
+    case Isa::AVX2:
+        return "avx2";
+    case Isa::NEON:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
+
+bool VbzFilter::encode(const Options &options, const unsigned char *input, size_t input_bytes,
+                       std::vector<unsigned char> &output)
+{
+    if (!supports(options) || input_bytes % 2 != 0 || input_bytes > 0xFFFFFFFFu)
+    {
+        return false;
+    }
+    const Kernels &kernels = kernelsFor(resolveIsa(options.isa));
+    const int16_t *values = reinterpret_cast<const int16_t *>(input);
+    size_t count = input_bytes / 2;
+    size_t block = blockElements(options);
+
+    // StreamVByte：先是全部控制字节（每 4 个值一个），再是变长数据；16 位值每个最多 2 字节，另留 16 字节给 SIMD 写入
+    size_t control_bytes = (count + 3) / 4;
+    thread_local std::vector<uint8_t> packed;
+    thread_local std::vector<uint16_t> staging;
+    packed.assign(control_bytes + count * 2 + 16, 0);
+    staging.resize(std::min(block, count));
+    uint8_t *data = packed.data() + control_bytes;
+    int16_t previous = 0;
+    for (size_t start = 0; start < count; start += block)
+    {
+        size_t n = std::min(block, count - start);
+        kernels.delta_zigzag(values + start, n, previous, staging.data());
+        previous = values[start + n - 1];
+        data = kernels.encode(staging.data(), n, options.version, packed.data() + start / 4, data);
+    }
+    size_t packed_size = static_cast<size_t>(data - packed.data());
+
+    // 4 字节原始长度头（小端），zstd 级别为 0 时直接存放 StreamVByte 数据
+    uint32_t original = static_cast<uint32_t>(input_bytes);
+    if (options.zstd_level == 0)
+    {
+        output.resize(4 + packed_size);
+        std::memcpy(output.data(), &original, sizeof(original));
+        std::memcpy(output.data() + 4, packed.data(), packed_size);
+        return true;
+    }
+#ifdef HAVE_ZSTD
+    // 每个线程复用一个压缩上下文
+    struct Context
+    {
+        ZSTD_CCtx *cctx = ZSTD_createCCtx();
+        ~Context() { ZSTD_freeCCtx(cctx); }
+    };
+    thread_local Context context;
+    ZSTD_CCtx_reset(context.cctx, ZSTD_reset_session_and_parameters);
+    ZSTD_CCtx_setParameter(context.cctx, ZSTD_c_compressionLevel, options.zstd_level);
+    if (options.window_log > 0)
+    {
+        ZSTD_CCtx_setParameter(context.cctx, ZSTD_c_windowLog, options.window_log);
+    }
+    output.resize(4 + ZSTD_compressBound(packed_size));
+    std::memcpy(output.data(), &original, sizeof(original));
+    size_t written = ZSTD_compress2(context.cctx, output.data() + 4, output.size() - 4, packed.data(), packed_size);
+    if (ZSTD_isError(written))
+    {
+        return false;
+    }
+    output.resize(4 + written);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool VbzFilter::decode(const Options &options, const unsigned char *input, size_t input_bytes,
+                       std::vector<unsigned char> &output)
+{
+    if (!supports(options) || input_bytes < 4)
+    {
+        return false;
+    }
+    uint32_t original = 0;
+    std::memcpy(&original, input, sizeof(original));
+    if (original % 2 != 0)
+    {
+        return false;
+    }
+    size_t count = original / 2;
+
+    const uint8_t *packed_data = input + 4;
+    size_t packed_size = input_bytes - 4;
+    thread_local std::vector<uint8_t> packed;
+    if (options.zstd_level != 0)
+    {
+#ifdef HAVE_ZSTD
+        unsigned long long content_size = ZSTD_getFrameContentSize(packed_data, packed_size);
+        if (content_size == ZSTD_CONTENTSIZE_ERROR || content_size == ZSTD_CONTENTSIZE_UNKNOWN)
+        {
+            return false;
+        }
+        packed.resize(static_cast<size_t>(content_size));
+        size_t written = ZSTD_decompress(packed.data(), packed.size(), packed_data, packed_size);
+        if (ZSTD_isError(written))
+        {
+            return false;
+        }
+        packed_data = packed.data();
+        packed_size = written;
+#else
+        return false;
+#endif
+    }
+
+    size_t control_bytes = (count + 3) / 4;
+    if (packed_size < control_bytes)
+    {
+        return false;
+    }
+    const Kernels &kernels = kernelsFor(resolveIsa(options.isa));
+    const uint8_t *data = packed_data + control_bytes;
+    const uint8_t *end = packed_data + packed_size;
+    size_t block = blockElements(options);
+    thread_local std::vector<uint16_t> staging;
+    staging.resize(std::min(block, count));
+    output.resize(original);
+    int16_t *values = reinterpret_cast<int16_t *>(output.data());
+    int16_t previous = 0;
+    for (size_t start = 0; start < count; start += block)
+    {
+        size_t n = std::min(block, count - start);
+        const uint8_t *control = packed_data + start / 4;
+        if (hasWideCodes(control, (n + 3) / 4, options.version))
+        {
+            data = decodeWide(control, data, end, n, options.version, previous, values + start);
+            if (data == nullptr)
+            {
+                return false;
+            }
+            continue;
+        }
+        data = kernels.decode(control, data, end, n, options.version, staging.data());
+        if (data == nullptr)
+        {
+            return false;
+        }
+        previous = kernels.prefix(staging.data(), n, previous, values + start);
+    }
+    return true;
+}
+
+size_t VbzFilter::filterCallback(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[],
+                                 size_t nbytes, size_t *buf_size, void **buf)
+{
+    Options options = fromCdValues(cd_nelmts, cd_values);
+    std::vector<unsigned char> output;
+    const unsigned char *input = static_cast<const unsigned char *>(*buf);
+    bool ok = (flags & H5Z_FLAG_REVERSE) ? decode(options, input, nbytes, output)
+                                         : encode(options, input, nbytes, output);
+    if (!ok || output.empty())
+    {
+        return 0;
+    }
+
+    // 过滤器的输出缓冲区必须由 HDF5 的分配函数分配，旧缓冲区由本过滤器释放
+    void *result = H5allocate_memory(output.size(), false);
+    if (result == nullptr)
+    {
+        return 0;
+    }
+    std::memcpy(result, output.data(), output.size());
+    H5free_memory(*buf);
+    *buf = result;
+    *buf_size = output.size();
+    return output.size();
+}
+
+const H5Z_class2_t *VbzFilter::filterClass(H5Z_filter_t filter_id)
+{
+    static const H5Z_class2_t native_class = {
+        H5Z_CLASS_T_VERS,
+        H5Z_FILTER_VBZ_NATIVE,
+        1, // 编码器可用
+        1, // 解码器可用
+        "vbz (in-tree)",
+        canApply,
+        NULL,
+        filterCallback};
+    static const H5Z_class2_t plugin_class = {
+        H5Z_CLASS_T_VERS,
+        H5Z_FILTER_VBZ,
+        1,
+        1,
+        "vbz (in-tree)",
+        canApply,
+        NULL,
+        filterCallback};
+    if (filter_id == H5Z_FILTER_VBZ_NATIVE)
+    {
+        return &native_class;
+    }
+    return filter_id == H5Z_FILTER_VBZ ? &plugin_class : nullptr;
+}
+
+bool VbzFilter::registerFilter(H5Z_filter_t filter_id)
+{
+    const H5Z_class2_t *filter_class = filterClass(filter_id);
+    return filter_class != nullptr && H5Zregister(filter_class) >= 0;
+}
+
+void VbzFilter::registerFilters()
+{
+    static bool registered = false;
+    if (registered)
+    {
+        return;
+    }
+    registered = true;
+    registerFilter(H5Z_FILTER_VBZ_NATIVE);
+#ifdef HAVE_ZSTD
+    // 先尝试加载插件，插件不存在时由本实现解码（和编码）32020。
+    // 插件写出的文件都带 zstd，没有 zstd 时接管 32020 只会让这些文件无法读取，所以不注册
+    H5E_BEGIN_TRY
+    {
+        if (H5Zfilter_avail(H5Z_FILTER_VBZ) <= 0)
+        {
+            registerFilter(H5Z_FILTER_VBZ);
+        }
+    }
+    H5E_END_TRY;
+#endif
+}
@@ -0,0 +1,70 @@
+#ifndef VBZ_FILTER_HPP
+#define VBZ_FILTER_HPP
+
+#include <vector>
+#include <cstddef>
+#include <hdf5.h>
+
+// 进程内实现的 VBZ 过滤器：int16 信号经 delta、zigzag、StreamVByte 后再做 zstd，
+// 输出格式与 VBZ 插件（32020）一致，写出的分块可以被插件解码，插件写出的分块也可以被本实现解码
+// （包括差值超出 int16 范围时的 3/4 字节码）。
+// delta/zigzag 与 StreamVByte 各有 AVX2、SSE4.1、NEON 和标量实现，运行时按 CPU 选择。
+// 未编译 zstd（HAVE_ZSTD）时只能处理 zstd 级别为 0（不做 zstd）的配置。
+// 编译为静态库 vbz_filter，另有插件库（vbz_plugin.cpp）以 H5Z_FILTER_VBZ_NATIVE 导出同一实现。
+class VbzFilter
+{
+public:
+    enum class Isa
+    {
+        Auto = 0, // 当前 CPU 支持的最快实现
+        Scalar = 1,
+        SSE41 = 2,
+        AVX2 = 3,
+        NEON = 4
+    };
+
+    // cd_values：0 版本（0 为 1/2/3/4 字节码，1 为 0/1/2/4 字节码）、1 整数字节数、2 是否 delta zigzag、
+    // 3 zstd 级别（0 表示不做 zstd）；插件不识别的扩展项：4 zstd 窗口（log2，0 为默认）、
+    // 5 分批处理的元素数（0 为默认）、6 指令集（Isa）
+    struct Options
+    {
+        unsigned int version = 1;
+        unsigned int integer_size = 2;
+        bool delta_zigzag = true;
+        int zstd_level = 1;
+        int window_log = 0;
+        size_t block_elements = 0;
+        Isa isa = Isa::Auto;
+    };
+
+    static Options fromCdValues(size_t cd_nelmts, const unsigned int cd_values[]);
+
+    // 该配置能否在本进程编解码（目前只支持 int16 + delta zigzag）
+    static bool supports(const Options &options);
+
+    // 编码一个分块：4 字节原始长度 + zstd(StreamVByte(zigzag(delta(int16))))
+    static bool encode(const Options &options, const unsigned char *input, size_t input_bytes,
+                       std::vector<unsigned char> &output);
+    static bool decode(const Options &options, const unsigned char *input, size_t input_bytes,
+                       std::vector<unsigned char> &output);
+
+    // 请求的指令集在当前 CPU 上实际使用的实现（不支持时回退到可用的最快实现）
+    static Isa resolveIsa(Isa requested);
+    static const char *isaName(Isa isa);
+
+    // 以 filter_id 描述本实现的过滤器类（只支持 H5Z_FILTER_VBZ_NATIVE 与 H5Z_FILTER_VBZ，其他 ID 返回 nullptr），
+    // 供 H5Zregister 与插件入口 H5PLget_plugin_info 使用
+    static const H5Z_class2_t *filterClass(H5Z_filter_t filter_id);
+
+    // 用 H5Zregister 注册本实现；同一 ID 已由插件提供时会被本实现替换
+    static bool registerFilter(H5Z_filter_t filter_id);
+
+    // 注册基准专用 ID；编译了 zstd 且插件不可用时同时以 32020 注册，使已有的 VBZ 文件仍可解码
+    static void registerFilters();
+
+private:
+    static size_t filterCallback(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[],
+                                 size_t nbytes, size_t *buf_size, void **buf);
+};
+
+#endif // VBZ_FILTER_HPP
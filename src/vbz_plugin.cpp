@@ -0,0 +1,16 @@
+#include "vbz_filter.hpp"
+#include "filter_definitions.hpp"
+#include <H5PLextern.h>
+
+// HDF5 动态插件入口：以 H5Z_FILTER_VBZ_NATIVE 导出进程内 VBZ 实现。
+// 把插件目录加入 HDF5_PLUGIN_PATH 后，h5dump、h5py 等其他程序也可以读写基准用 VBZ_NATIVE 写出的文件
+
+H5PL_type_t H5PLget_plugin_type(void)
+{
+    return H5PL_TYPE_FILTER;
+}
+
+const void *H5PLget_plugin_info(void)
+{
+    return VbzFilter::filterClass(H5Z_FILTER_VBZ_NATIVE);
+}
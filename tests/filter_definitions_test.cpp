@@ -0,0 +1,83 @@
+#include "filter_definitions.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <limits>
+
+// 过滤器注册表测试：cd_values 与注册表引入之前 hdf5_processor.cpp 中各过滤器的取值一致，
+// 以及策略文件使用的编解码器自身级别
+namespace
+{
+    int failures = 0;
+    int checks = 0;
+
+    void check(bool condition, const std::string &what)
+    {
+        ++checks;
+        if (!condition)
+        {
+            ++failures;
+            std::cerr << "FAILED: " << what << std::endl;
+        }
+    }
+
+    std::vector<unsigned int> cdValues(const std::string &filter_name, int level, const std::string &parameters)
+    {
+        std::vector<unsigned int> cd_values;
+        std::string error;
+        const FilterDefinitions::FilterSpec *filter = FilterDefinitions::findFilter(filter_name);
+        if (filter == nullptr || !FilterDefinitions::buildCdValues(*filter, level, parameters, cd_values, error))
+        {
+            std::cerr << filter_name << ": " << error << std::endl;
+            return {};
+        }
+        return cd_values;
+    }
+
+    void testLz4()
+    {
+        // 未指定 block_size 时沿用原来的映射：级别 0 为 65535，其余为 UINT_MAX / 级别
+        const unsigned int max = std::numeric_limits<unsigned int>::max();
+        check(cdValues("LZ4", 0, "") == std::vector<unsigned int>{65535}, "LZ4 level 0");
+        check(cdValues("LZ4", 1, "") == std::vector<unsigned int>{max}, "LZ4 level 1");
+        check(cdValues("LZ4", 9, "") == std::vector<unsigned int>{max / 9}, "LZ4 level 9");
+
+        // 显式给出的块大小不受级别影响
+        check(cdValues("LZ4", 9, "block_size=65536") == std::vector<unsigned int>{65536}, "LZ4 explicit block size");
+        check(cdValues("LZ4", 1, "LZ4.block_size=1048576") == std::vector<unsigned int>{1048576},
+              "LZ4 qualified block size");
+    }
+
+    std::vector<unsigned int> nativeCdValues(const std::string &filter_name, int level)
+    {
+        std::vector<unsigned int> cd_values;
+        std::string error;
+        const FilterDefinitions::FilterSpec *filter = FilterDefinitions::findFilter(filter_name);
+        if (filter == nullptr || !FilterDefinitions::buildNativeCdValues(*filter, level, "", cd_values, error))
+        {
+            return {};
+        }
+        return cd_values;
+    }
+
+    void testNativeLevels()
+    {
+        // 扫描级别经过映射，自身级别原样写入
+        check(cdValues("ZSTD", 9, "") == std::vector<unsigned int>{20}, "ZSTD sweep level 9 is zstd level 20");
+        check(nativeCdValues("ZSTD", 19) == std::vector<unsigned int>{19}, "ZSTD native level 19");
+        check(nativeCdValues("ZSTD", 22) == std::vector<unsigned int>{22}, "ZSTD native level 22");
+        check(nativeCdValues("ZSTD", 23).empty(), "ZSTD native level 23 is rejected");
+        check(nativeCdValues("BZIP2", 9) == std::vector<unsigned int>{9}, "BZIP2 native level 9");
+
+        // 没有单独映射的过滤器两种写法相同
+        check(nativeCdValues("GZIP", 6) == cdValues("GZIP", 6, ""), "GZIP native level equals sweep level");
+    }
+} // namespace
+
+int main()
+{
+    testLz4();
+    testNativeLevels();
+    std::cout << checks << " checks, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
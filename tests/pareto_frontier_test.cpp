@@ -0,0 +1,86 @@
+#include "pareto_frontier.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Pareto 前沿测试：扫描剪枝只剪除在前沿全部目标（压缩比、编码/解码吞吐量、峰值内存）上都不可能胜出的配置
+namespace
+{
+    int failures = 0;
+    int checks = 0;
+
+    void check(bool condition, const std::string &what)
+    {
+        ++checks;
+        if (!condition)
+        {
+            ++failures;
+            std::cerr << "FAILED: " << what << std::endl;
+        }
+    }
+
+    CompressionResult makeResult(const std::string &filter_name, int level, double ratio, double encode_mbps,
+                                 double decode_mbps, size_t peak_mb)
+    {
+        CompressionResult result;
+        result.filter_name = filter_name;
+        result.compression_level = level;
+        result.compression_ratio = ratio;
+        result.compression_mbps = encode_mbps;
+        result.decompression_mbps = decode_mbps;
+        result.peak_memory_bytes = peak_mb * 1024 * 1024;
+        return result;
+    }
+
+    CompressionResult makeCandidate(const std::string &filter_name, int level)
+    {
+        CompressionResult candidate;
+        candidate.filter_name = filter_name;
+        candidate.compression_level = level;
+        return candidate;
+    }
+
+    void testPruneKeepsFasterDecoder()
+    {
+        // LZ4 级别 6 的估计压缩比低于 ZSTD 级别 1，编码也不更快，但 LZ4 解码快得多：它可能在解码吞吐量上进入前沿
+        std::vector<CompressionResult> measured = {makeResult("LZ4", 1, 2.0, 400.0, 3000.0, 8),
+                                                   makeResult("ZSTD", 1, 3.0, 500.0, 600.0, 8)};
+        check(ParetoFrontier::coveringPoint(measured, makeCandidate("LZ4", 6), 2.2) < 0,
+              "lower-ratio, faster-decoding configuration is not pruned");
+
+        // 峰值内存更低的同理
+        measured = {makeResult("LZ4", 1, 2.0, 400.0, 500.0, 2), makeResult("ZSTD", 1, 3.0, 500.0, 600.0, 64)};
+        check(ParetoFrontier::coveringPoint(measured, makeCandidate("LZ4", 6), 2.2) < 0,
+              "lower-ratio, lower-memory configuration is not pruned");
+    }
+
+    void testPruneDominated()
+    {
+        // ZSTD 级别 1 在全部目标上都不差于 LZ4 已测级别的最好值，LZ4 级别 6 不可能进入前沿
+        std::vector<CompressionResult> measured = {makeResult("LZ4", 1, 2.0, 400.0, 3000.0, 8),
+                                                   makeResult("ZSTD", 1, 3.0, 500.0, 3500.0, 8)};
+        check(ParetoFrontier::coveringPoint(measured, makeCandidate("LZ4", 6), 2.2) == 1,
+              "configuration worse on every objective is pruned");
+
+        // 估计压缩比上限超过已测最好压缩比时不剪除
+        check(ParetoFrontier::coveringPoint(measured, makeCandidate("LZ4", 6), 3.5) < 0,
+              "configuration with a higher ratio bound is not pruned");
+
+        // 同一管线没有不高于该级别的已测级别：编码吞吐量没有上限，不剪除
+        check(ParetoFrontier::coveringPoint(measured, makeCandidate("GZIP", 1), 1.5) < 0,
+              "configuration without a measured lower level is not pruned");
+
+        // 失败或校验未通过的配置不能支配其他配置
+        measured[1].verification_failures = 1;
+        check(ParetoFrontier::coveringPoint(measured, makeCandidate("LZ4", 6), 2.2) < 0,
+              "failed configuration does not prune");
+    }
+} // namespace
+
+int main()
+{
+    testPruneKeepsFasterDecoder();
+    testPruneDominated();
+    std::cout << checks << " checks, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
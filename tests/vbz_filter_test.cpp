@@ -0,0 +1,253 @@
+#include "vbz_filter.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// VBZ 过滤器的编解码测试：各指令集、版本、批大小下的往返，与 VBZ 插件（32020）分块格式的互通
+namespace
+{
+    int failures = 0;
+    int checks = 0;
+
+    void check(bool condition, const std::string &what)
+    {
+        ++checks;
+        if (!condition)
+        {
+            ++failures;
+            std::cerr << "FAILED: " << what << std::endl;
+        }
+    }
+
+    const VbzFilter::Isa kIsas[] = {VbzFilter::Isa::Scalar, VbzFilter::Isa::SSE41, VbzFilter::Isa::AVX2,
+                                    VbzFilter::Isa::NEON};
+
+    std::vector<unsigned char> toBytes(const std::vector<int16_t> &samples)
+    {
+        std::vector<unsigned char> bytes(samples.size() * 2);
+        std::memcpy(bytes.data(), samples.data(), bytes.size());
+        return bytes;
+    }
+
+    // 类似 nanopore 原始信号的随机游走，每隔 jump_every 个点插入一次跨越整个 int16 范围的跳变
+    std::vector<int16_t> makeSignal(size_t count, size_t jump_every)
+    {
+        std::vector<int16_t> samples(count);
+        uint32_t state = 12345;
+        int value = 500;
+        for (size_t i = 0; i < count; ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            value += static_cast<int>((state >> 24) % 41) - 20;
+            value = std::max(0, std::min(2047, value));
+            samples[i] = static_cast<int16_t>(value);
+            if (jump_every != 0 && i % jump_every == jump_every - 1)
+            {
+                samples[i] = (i / jump_every) % 2 == 0 ? INT16_MIN : INT16_MAX;
+            }
+        }
+        return samples;
+    }
+
+    // 按插件的写法独立实现的编码：差值与 zigzag 按 32 位计算，跨度超过 32767 的差值写成 3/4 字节码，不做 zstd
+    std::vector<unsigned char> pluginChunk(const std::vector<int16_t> &samples, unsigned int version)
+    {
+        // 4 字节原始长度头，之后是全部控制字节，再是变长数据
+        size_t control_bytes = (samples.size() + 3) / 4;
+        std::vector<unsigned char> chunk(4 + control_bytes, 0);
+        uint32_t original = static_cast<uint32_t>(samples.size() * 2);
+        std::memcpy(chunk.data(), &original, sizeof(original));
+        int32_t previous = 0;
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            int32_t delta = samples[i] - previous;
+            previous = samples[i];
+            uint32_t value = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+            size_t length = value < (1U << 8) ? 1 : value < (1U << 16) ? 2 : value < (1U << 24) ? 3 : 4;
+            unsigned int code = static_cast<unsigned int>(length - 1);
+            if (version == 1)
+            {
+                length = value == 0 ? 0 : length == 3 ? 4 : length;
+                code = length == 4 ? 3 : static_cast<unsigned int>(length);
+            }
+            chunk[4 + i / 4] |= static_cast<unsigned char>(code << ((i % 4) * 2));
+            for (size_t b = 0; b < length; ++b)
+            {
+                chunk.push_back(static_cast<unsigned char>(value >> (8 * b)));
+            }
+        }
+        return chunk;
+    }
+
+    VbzFilter::Options makeOptions(unsigned int version, int zstd_level, size_t block_elements, VbzFilter::Isa isa)
+    {
+        VbzFilter::Options options;
+        options.version = version;
+        options.zstd_level = zstd_level;
+        options.block_elements = block_elements;
+        options.isa = isa;
+        return options;
+    }
+
+    std::string describe(const VbzFilter::Options &options, size_t count)
+    {
+        return std::string(VbzFilter::isaName(options.isa)) + " v" + std::to_string(options.version) + " zstd " +
+               std::to_string(options.zstd_level) + " block " + std::to_string(options.block_elements) + ", " +
+               std::to_string(count) + " samples";
+    }
+
+    void testRoundTrip()
+    {
+        std::vector<int> levels = {0};
+#ifdef HAVE_ZSTD
+        levels.push_back(1);
+#endif
+        const size_t counts[] = {0, 1, 3, 17, 1000, 40000};
+        for (size_t count : counts)
+        {
+            for (size_t jump_every : {size_t(0), size_t(97)})
+            {
+                std::vector<unsigned char> input = toBytes(makeSignal(count, jump_every));
+                for (unsigned int version : {0u, 1u})
+                {
+                    for (int level : levels)
+                    {
+                        for (size_t block : {size_t(0), size_t(16)})
+                        {
+                            std::vector<unsigned char> reference;
+                            VbzFilter::encode(makeOptions(version, level, block, VbzFilter::Isa::Scalar), input.data(),
+                                              input.size(), reference);
+                            for (VbzFilter::Isa isa : kIsas)
+                            {
+                                VbzFilter::Options options = makeOptions(version, level, block, isa);
+                                std::vector<unsigned char> encoded;
+                                std::vector<unsigned char> decoded;
+                                bool ok = VbzFilter::encode(options, input.data(), input.size(), encoded) &&
+                                          VbzFilter::decode(options, encoded.data(), encoded.size(), decoded);
+                                check(ok && decoded == input, "round trip, " + describe(options, count));
+                                check(encoded == reference, "same bytes as scalar, " + describe(options, count));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // 按插件分块格式逐字节写出的固定分块（cd_values {0, 2, 1, 0}，不做 zstd）：4 字节原始长度，之后是控制字节与
+    // StreamVByte 数据；插件按 32 位计算差值，第 5、6 个差值（-33168、65535）超出 int16 范围，写成 3 字节码
+    const std::vector<int16_t> kFixtureSamples = {100, 102, 99, 400, INT16_MIN, INT16_MAX, 32760, -5, 0};
+    const std::vector<unsigned char> kFixtureVersion0 = {
+        0x12, 0x00, 0x00, 0x00,                        // 18 字节
+        0x40, 0x4A, 0x00,                              // 码 0,0,0,1 | 2,2,0,1 | 0
+        0xC8, 0x04, 0x05, 0x5A, 0x02,                  // 200, 4, 5, 602
+        0x1F, 0x03, 0x01, 0xFE, 0xFF, 0x01, 0x0D,      // 66335, 131070, 13
+        0xF9, 0xFF, 0x0A};                             // 65529, 10
+    // 同一数据的版本 1（0/1/2/4 字节码）
+    const std::vector<unsigned char> kFixtureVersion1 = {
+        0x12, 0x00, 0x00, 0x00,
+        0x95, 0x9F, 0x01,                              // 码 1,1,1,2 | 3,3,1,2 | 1
+        0xC8, 0x04, 0x05, 0x5A, 0x02,
+        0x1F, 0x03, 0x01, 0x00, 0xFE, 0xFF, 0x01, 0x00, 0x0D,
+        0xF9, 0xFF, 0x0A};
+
+    void testPluginFixture()
+    {
+        std::vector<unsigned char> expected = toBytes(kFixtureSamples);
+        check(pluginChunk(kFixtureSamples, 0) == kFixtureVersion0, "reference encoder reproduces the v0 fixture");
+        check(pluginChunk(kFixtureSamples, 1) == kFixtureVersion1, "reference encoder reproduces the v1 fixture");
+
+        std::vector<int16_t> long_signal = makeSignal(40000, 97);
+        std::vector<unsigned char> long_expected = toBytes(long_signal);
+        for (VbzFilter::Isa isa : kIsas)
+        {
+            for (unsigned int version : {0u, 1u})
+            {
+                VbzFilter::Options options = makeOptions(version, 0, 0, isa);
+                const std::vector<unsigned char> &fixture = version == 0 ? kFixtureVersion0 : kFixtureVersion1;
+                std::vector<unsigned char> decoded;
+                check(VbzFilter::decode(options, fixture.data(), fixture.size(), decoded) && decoded == expected,
+                      "decode plugin fixture, " + describe(options, kFixtureSamples.size()));
+
+                // 宽码分布在多个批中，其余批走 SIMD 路径
+                options.block_elements = 64;
+                std::vector<unsigned char> chunk = pluginChunk(long_signal, version);
+                check(VbzFilter::decode(options, chunk.data(), chunk.size(), decoded) && decoded == long_expected,
+                      "decode plugin chunk with wide codes, " + describe(options, long_signal.size()));
+            }
+        }
+
+#ifdef HAVE_ZSTD
+        // 插件在 StreamVByte 之后对整段数据做一次 ZSTD_compress，原始长度头保持在最前面
+        std::vector<unsigned char> compressed(4 + ZSTD_compressBound(kFixtureVersion0.size() - 4));
+        std::memcpy(compressed.data(), kFixtureVersion0.data(), 4);
+        size_t written = ZSTD_compress(compressed.data() + 4, compressed.size() - 4, kFixtureVersion0.data() + 4,
+                                       kFixtureVersion0.size() - 4, 1);
+        compressed.resize(4 + written);
+        std::vector<unsigned char> decoded;
+        VbzFilter::Options options = makeOptions(0, 1, 0, VbzFilter::Isa::Auto);
+        check(VbzFilter::decode(options, compressed.data(), compressed.size(), decoded) && decoded == expected,
+              "decode zstd plugin fixture");
+#endif
+    }
+
+    void testEncoderBytes()
+    {
+        // 差值都在 int16 范围内时，本实现写出的分块与插件逐字节相同
+        std::vector<int16_t> samples = {100, 102, 99, 400};
+        std::vector<unsigned char> input = toBytes(samples);
+        for (VbzFilter::Isa isa : kIsas)
+        {
+            std::vector<unsigned char> encoded;
+            VbzFilter::encode(makeOptions(0, 0, 0, isa), input.data(), input.size(), encoded);
+            check(encoded == std::vector<unsigned char>({0x08, 0x00, 0x00, 0x00, 0x40, 0xC8, 0x04, 0x05, 0x5A, 0x02}),
+                  std::string("v0 bytes match the plugin, ") + VbzFilter::isaName(isa));
+            VbzFilter::encode(makeOptions(1, 0, 0, isa), input.data(), input.size(), encoded);
+            check(encoded == std::vector<unsigned char>({0x08, 0x00, 0x00, 0x00, 0x95, 0xC8, 0x04, 0x05, 0x5A, 0x02}),
+                  std::string("v1 bytes match the plugin, ") + VbzFilter::isaName(isa));
+        }
+    }
+
+    void testCorruptInput()
+    {
+        for (VbzFilter::Isa isa : kIsas)
+        {
+            VbzFilter::Options options = makeOptions(0, 0, 0, isa);
+            std::vector<unsigned char> decoded;
+
+            // 3 字节码的值超过 17 位，不可能来自 int16 数据
+            std::vector<unsigned char> too_wide = kFixtureVersion0;
+            too_wide[14] = 0x02; // 66335 → 0x02031F
+            check(!VbzFilter::decode(options, too_wide.data(), too_wide.size(), decoded),
+                  std::string("reject value wider than 17 bits, ") + VbzFilter::isaName(isa));
+
+            std::vector<unsigned char> truncated(kFixtureVersion0.begin(), kFixtureVersion0.end() - 2);
+            check(!VbzFilter::decode(options, truncated.data(), truncated.size(), decoded),
+                  std::string("reject truncated chunk, ") + VbzFilter::isaName(isa));
+
+            // 数据区少一字节
+            std::vector<int16_t> samples = makeSignal(64, 0);
+            std::vector<unsigned char> encoded;
+            VbzFilter::encode(options, toBytes(samples).data(), samples.size() * 2, encoded);
+            encoded.resize(encoded.size() - 1);
+            check(!VbzFilter::decode(options, encoded.data(), encoded.size(), decoded),
+                  std::string("reject short data, ") + VbzFilter::isaName(isa));
+        }
+    }
+} // namespace
+
+int main()
+{
+    testRoundTrip();
+    testPluginFixture();
+    testEncoderBytes();
+    testCorruptInput();
+    std::cout << checks << " checks, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
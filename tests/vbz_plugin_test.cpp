@@ -0,0 +1,79 @@
+#include "filter_definitions.hpp"
+#include <hdf5.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// 插件库测试：不链接 vbz_filter，只通过插件目录加载 H5Z_FILTER_VBZ_NATIVE，经过滤器管线写入并读回
+namespace
+{
+    int failures = 0;
+    int checks = 0;
+
+    void check(bool condition, const std::string &what)
+    {
+        ++checks;
+        if (!condition)
+        {
+            ++failures;
+            std::cerr << "FAILED: " << what << std::endl;
+        }
+    }
+
+    void testWriteRead(unsigned int zstd_level)
+    {
+        const hsize_t count = 50000;
+        const hsize_t chunk = 8192;
+        std::vector<int16_t> samples(count);
+        for (hsize_t i = 0; i < count; ++i)
+        {
+            samples[i] = static_cast<int16_t>(500 + (i * 7) % 23 - (i % 5) * 3);
+        }
+        std::string label = "zstd level " + std::to_string(zstd_level);
+
+        hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+        H5Pset_fapl_core(fapl, 1 << 20, 0);
+        hid_t file = H5Fcreate("vbz_plugin_test.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+        hid_t space = H5Screate_simple(1, &count, NULL);
+        hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+        H5Pset_chunk(dcpl, 1, &chunk);
+        const unsigned int cd_values[4] = {0, 2, 1, zstd_level};
+        check(H5Pset_filter(dcpl, H5Z_FILTER_VBZ_NATIVE, H5Z_FLAG_MANDATORY, 4, cd_values) >= 0,
+              "set filter, " + label);
+        hid_t dset = H5Dcreate2(file, "Signal", H5T_NATIVE_INT16, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+        check(dset >= 0, "create dataset, " + label);
+        check(H5Dwrite(dset, H5T_NATIVE_INT16, H5S_ALL, H5S_ALL, H5P_DEFAULT, samples.data()) >= 0,
+              "write, " + label);
+        H5Dflush(dset);
+        check(H5Dget_storage_size(dset) < count * sizeof(int16_t), "chunks are compressed, " + label);
+
+        std::vector<int16_t> decoded(count, 0);
+        check(H5Dread(dset, H5T_NATIVE_INT16, H5S_ALL, H5S_ALL, H5P_DEFAULT, decoded.data()) >= 0 &&
+                  decoded == samples,
+              "read back, " + label);
+        H5Dclose(dset);
+        H5Pclose(dcpl);
+        H5Sclose(space);
+        H5Fclose(file);
+        H5Pclose(fapl);
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: vbz_plugin_test PLUGIN_DIR" << std::endl;
+        return 1;
+    }
+    H5PLprepend(argv[1]);
+    check(H5Zfilter_avail(H5Z_FILTER_VBZ_NATIVE) > 0, "plugin provides filter " +
+                                                          std::to_string(H5Z_FILTER_VBZ_NATIVE));
+    testWriteRead(0);
+#ifdef HAVE_ZSTD
+    testWriteRead(1);
+#endif
+    std::cout << checks << " checks, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}